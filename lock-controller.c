@@ -11,23 +11,48 @@
 
     #include <CowPi.h>
     #include "display.h"
+    #include "led-pattern.h"
     #include "lock-controller.h"
+    #include "lock-tasks.h"
     #include "rotary-encoder.h"
     #include "servomotor.h"
-    
+
     #define COMBO_LENGTH 3
-    
+
+    /* the combination's phases are states of their own, so that a (state, event) pair picks one transition */
     typedef enum {
-        LOCKED, UNLOCKED, ALARMED, CHANGING, FAILED
+        LOCKED_ENTERING_FIRST,
+        LOCKED_ENTERING_SECOND,
+        LOCKED_ENTERING_THIRD,
+        UNLOCKED,
+        ALARMED,
+        CHANGING,
+        FAILED,
+        NUMBER_OF_LOCK_STATES
     } lock_state_t;
-    
+
     typedef enum {
-        ENTERING_FIRST,
-        ENTERING_SECOND,
-        ENTERING_THIRD
-    } combo_phase_t;
-    
-    static combo_phase_t combo_phase = ENTERING_FIRST;
+        EVENT_OVERCOUNT,            // a combination number was passed too many times
+        EVENT_CLOCKWISE,
+        EVENT_COUNTERCLOCKWISE,
+        EVENT_GOOD_ENTRY,           // left button, and the entered combination is correct
+        EVENT_BAD_ENTRY,            // left button, and the entered combination is wrong
+        EVENT_FINAL_BAD_ENTRY,      // left button, and the entered combination is wrong for the third time
+        EVENT_RELOCK,               // both buttons
+        EVENT_BEGIN_CHANGE,         // left switch in the right position, and the right button
+        EVENT_DIGIT,                // a new digit on the keypad
+        EVENT_END_CHANGE,           // left switch in the left position
+        EVENT_PATTERN_DONE,         // the LEDs have stopped blinking
+        NUMBER_OF_LOCK_EVENTS
+    } lock_event_t;
+
+    #define UNCHANGED NUMBER_OF_LOCK_STATES
+
+    struct transition {
+        void (*action)(void);       // NULL for none
+        lock_state_t next_state;    // UNCHANGED to remain in the current state
+    };
+
     static int entered_combination[COMBO_LENGTH] = {-1, -1, -1};
     static int current_value = 0;
     static int first_seen_count = 0;
@@ -35,359 +60,338 @@
     static int third_seen_count = 0;
     static int bad_attempts = 0;
     static bool user_has_interacted = false;
-    
+
     static uint8_t combination[3] __attribute__((section (".uninitialized_ram.")));
-    static lock_state_t current_state = LOCKED;
-    
+    static lock_state_t current_state = LOCKED_ENTERING_FIRST;
+
     static int new_combo1[6] = {-1, -1, -1, -1, -1, -1};
     static int new_combo2[6] = {-1, -1, -1, -1, -1, -1};
     static int new_combination[COMBO_LENGTH] = {-1, -1, -1};
-    static cowpi_timer_t volatile *timer;
+    static int input_index = 0;
+    static int confirm_phase = 0;
+    static int last_digit = 0;
+
+    /* its end wakes the lock controller, which leaves FAILED without waiting for an input */
+    static struct led_pattern const bad_try_pattern = {
+            .leds = LED_PATTERN_BOTH, .on_time_us = 250000, .off_time_us = 250000, .repetitions = 2,
+            .on_complete = lock_tasks_post_input_change
+    };
+    static struct led_pattern const alarm_pattern = {
+            .leds = LED_PATTERN_BOTH, .on_time_us = 250000, .off_time_us = 250000, .repetitions = LED_PATTERN_FOREVER
+    };
 
-    uint32_t get_microseconds(void) {
-        return timer->raw_lower_word;
-    }
-    
     uint8_t const *get_combination() {
         return combination;
     }
-    
+
     lock_state_t get_lock_state() {
         return current_state;
     }
-    
+
     void set_lock_state(lock_state_t new_state) {
         current_state = new_state;
     }
-    
+
     void force_combination_reset() {
         combination[0] = 5;
         combination[1] = 10;
         combination[2] = 15;
     }
-    
-    void initialize_lock_controller() {
-        set_lock_state(LOCKED);
-        combo_phase = ENTERING_FIRST;
+
+    /* actions */
+
+    static void reset_entry(void) {
+        for (int i = 0; i < COMBO_LENGTH; i++) {
+            entered_combination[i] = -1;
+        }
         current_value = 0;
         first_seen_count = 0;
         second_seen_count = 0;
         third_seen_count = 0;
-        bad_attempts = 0;
         user_has_interacted = false;
-        for (int i = 0; i < COMBO_LENGTH; i++) {
-            entered_combination[i] = -1;
+    }
+
+    static void turn(int delta) {
+        user_has_interacted = true;
+        current_value = (current_value + delta + 16) % 16;
+    }
+
+    static void count_first_pass(void) {
+        turn(+1);
+        if (current_value == combination[0]) {
+            first_seen_count++;
         }
-        display_string(1, "- - -");
-        rotate_full_clockwise();
-        force_combination_reset();
-        timer = (cowpi_timer_t *) (0x40054000);
     }
-    
-    void control_lock() {
-        if (get_lock_state() == LOCKED) {
-            direction_t dir = get_direction();
-    
-            if (dir == CLOCKWISE || dir == COUNTERCLOCKWISE) {
-                user_has_interacted = true;
-            }
-    
-            if (dir == CLOCKWISE) {
-                current_value = (current_value + 1) % 16;
-            } else if (dir == COUNTERCLOCKWISE) {
-                current_value = (current_value - 1 + 16) % 16;
-            }
-    
-            if (combo_phase == ENTERING_FIRST) {
-                if (dir == CLOCKWISE && current_value == combination[0]) {
-                    first_seen_count++;
-                }
-                if (dir == COUNTERCLOCKWISE && entered_combination[0] == -1) {
-                    if(current_value == 15){
-                        entered_combination[0] = 0;
-                    } else {
-                        entered_combination[0] = current_value + 1;
-                    }
-                    entered_combination[0] = current_value + 1;
-                    combo_phase = ENTERING_SECOND;
-                    current_value = 0;
-                }
-            } else if (combo_phase == ENTERING_SECOND) {
-                if (second_seen_count > 2){
-                    combo_phase = ENTERING_FIRST;
-                    current_value = 0;
-                    first_seen_count = 0;
-                    second_seen_count = 0;
-                    third_seen_count = 0;
-                    user_has_interacted = false;
-                    display_string(1, "- - -");
-                }
-                if (dir == COUNTERCLOCKWISE && current_value == combination[1]) {
-                    second_seen_count++;
-                }
-                if (dir == CLOCKWISE && entered_combination[1] == -1) {
-                    entered_combination[1] = current_value -1;
-                    combo_phase = ENTERING_THIRD;
-                    current_value = 0;
-                }
-            } else if (combo_phase == ENTERING_THIRD) {
-                if (third_seen_count > 1){
-                    combo_phase = ENTERING_FIRST;
-                    current_value = 0;
-                    first_seen_count = 0;
-                    second_seen_count = 0;
-                    third_seen_count = 0;
-                    user_has_interacted = false;
-                    display_string(1, "- - -");
-                }
-                if (dir == CLOCKWISE) {
-                    if (current_value == combination[2]) {
-                        third_seen_count++;
-                    }
-                } else if (dir == COUNTERCLOCKWISE) {
-                    for (int i = 0; i < COMBO_LENGTH; i++) {
-                        entered_combination[i] = -1;
-                    }
-                    combo_phase = ENTERING_FIRST;
-                    current_value = 0;
-                    first_seen_count = 0;
-                    second_seen_count = 0;
-                    third_seen_count = 0;
-                    user_has_interacted = false;
-                }
-            }
-    
-            char buffer[20];
-    
-            if (!user_has_interacted) {
-                sprintf(buffer, "- - -");
-            } else if (combo_phase == ENTERING_FIRST) {
-                sprintf(buffer, "%02d-  -  ", current_value);
-            } else if (combo_phase == ENTERING_SECOND) {
-                sprintf(buffer, "%02d-%02d-  ", entered_combination[0], current_value);
-            } else if (combo_phase == ENTERING_THIRD) {
-                sprintf(buffer, "%02d-%02d-%02d", entered_combination[0], entered_combination[1], current_value);
-            }
-    
-            if (combo_phase == ENTERING_THIRD && cowpi_left_button_is_pressed()) {
-                bool correct = true;
-    
-                correct = (entered_combination[0] == combination[0] && first_seen_count >= 3)
-                        && (entered_combination[1] == combination[1] && second_seen_count == 2)
-                        && (current_value == combination[2] && third_seen_count == 1);
-    
-                if (correct) {
-                    set_lock_state(UNLOCKED);
-                    sprintf(buffer, "OPEN");
-                    rotate_full_counterclockwise();
-                } else {
-                    bad_attempts++;
-                    if (bad_attempts >= 3) {
-                        sprintf(buffer, "alert!");
-                        display_string(1, buffer);
-                        set_lock_state(ALARMED);
-                    } else {
-                        sprintf(buffer, "bad try %d", bad_attempts);
-                        set_lock_state(FAILED);
-                    }
-                }
-            }
-            display_string(1, buffer);
-        } else if(get_lock_state() == FAILED){
-            for (int i = 0; i < 2; i++) {
-                cowpi_illuminate_left_led();
-                cowpi_illuminate_right_led();
-                uint32_t start = get_microseconds();
-                while (get_microseconds() - start < 250000);
-                    
-                cowpi_deluminate_left_led();
-                cowpi_deluminate_right_led();
-                start = get_microseconds();
-                while (get_microseconds() - start < 250000);
-            }
-            for (int i = 0; i < COMBO_LENGTH; i++) {
-                entered_combination[i] = -1;
-            }
-            combo_phase = ENTERING_FIRST;
-            current_value = 0;
-            first_seen_count = 0;
-            second_seen_count = 0;
-            third_seen_count = 0;
-            user_has_interacted = false;
-            set_lock_state(LOCKED);
-        } else if(get_lock_state() == ALARMED){
-            for (int i = 0; i < INT16_MAX; i++) {
-                cowpi_illuminate_left_led();
-                cowpi_illuminate_right_led();
-                uint32_t start = get_microseconds();
-                while (get_microseconds() - start < 250000);
-                        
-                cowpi_deluminate_left_led();
-                cowpi_deluminate_right_led();
-                start = get_microseconds();
-                while (get_microseconds() - start < 250000);
-            }
-        } else if (get_lock_state() == UNLOCKED) {
-            if (cowpi_left_switch_is_in_right_position() && cowpi_right_button_is_pressed()) {
-                set_lock_state(CHANGING);
-                display_string(1, "enter - - -");
-                for (int i = 0; i < 6; i++) {
-                    new_combo1[i] = -1;
-                    new_combo2[i] = -1;
-                }
-            }
-            if(cowpi_left_button_is_pressed() && cowpi_right_button_is_pressed()){
-                for (int i = 0; i < COMBO_LENGTH; i++) {
-                    entered_combination[i] = -1;
-                }
-                combo_phase = ENTERING_FIRST;
-                current_value = 0;
-                first_seen_count = 0;
-                second_seen_count = 0;
-                third_seen_count = 0;
-                user_has_interacted = false;
-                display_string(1, "- - -");
-                set_lock_state(LOCKED);
-            }
-        } else if (get_lock_state() == CHANGING) {
-            static int input_index = 0;
-            static int confirm_phase = 0;
-
-            static uint8_t last_key = 0xFF;
-            char buffer[20];
-
-            uint8_t key = cowpi_get_keypress();
-            if (key != 0xFF && key != last_key && key >= '0' && key <= '9' && input_index < 6) {
-                int digit = key - '0';
-                if (confirm_phase == 0) {
-                    new_combo1[input_index] = digit;
-                } else {
-                    new_combo2[input_index] = digit;
-                }
-                input_index++;
-            }
-            last_key = key;
-
-            int *combo_ptr = (confirm_phase == 0) ? new_combo1 : new_combo2;
-            if (input_index == 0) {
-                sprintf(buffer, "  -  -  ");
-            } else if (input_index == 1) {
-                sprintf(buffer, "%01d -  -  ", combo_ptr[0]);
-            } else if (input_index == 2) {
-                sprintf(buffer, "%01d%01d-  -  ", combo_ptr[0], combo_ptr[1]);
-            } else if (input_index == 3) {
-                sprintf(buffer, "%01d%01d-%01d -  ", combo_ptr[0], combo_ptr[1], combo_ptr[2]);
-            } else if (input_index == 4) {
-                sprintf(buffer, "%01d%01d-%01d%01d-  ", combo_ptr[0], combo_ptr[1], combo_ptr[2], combo_ptr[3]);
-            } else if (input_index == 5) {
-                sprintf(buffer, "%01d%01d-%01d%01d-%01d ", combo_ptr[0], combo_ptr[1], combo_ptr[2], combo_ptr[3], combo_ptr[4]);
-            } else if (input_index == 6) {
-                sprintf(buffer, "%01d%01d-%01d%01d-%01d%01d", combo_ptr[0], combo_ptr[1], combo_ptr[2], combo_ptr[3], combo_ptr[4], combo_ptr[5]);
-            }
 
+    static void enter_first_number(void) {
+        turn(-1);
+        entered_combination[0] = current_value + 1;
+        current_value = 0;
+    }
+
+    static void count_second_pass(void) {
+        turn(-1);
+        if (current_value == combination[1]) {
+            second_seen_count++;
+        }
+    }
+
+    static void enter_second_number(void) {
+        turn(+1);
+        entered_combination[1] = current_value - 1;
+        current_value = 0;
+    }
+
+    static void count_third_pass(void) {
+        turn(+1);
+        if (current_value == combination[2]) {
+            third_seen_count++;
+        }
+    }
+
+    static void open_lock(void) {
+        display_string(1, "OPEN");
+        rotate_full_counterclockwise();
+    }
+
+    static void reject_entry(void) {
+        char buffer[20];
+        bad_attempts++;
+        sprintf(buffer, "bad try %d", bad_attempts);
+        display_string(1, buffer);
+        led_pattern_start(&bad_try_pattern);
+    }
+
+    static void raise_alarm(void) {
+        bad_attempts++;
+        display_string(1, "alert!");
+        led_pattern_start(&alarm_pattern);
+    }
+
+    static void begin_change(void) {
+        display_string(1, "enter - - -");
+        for (int i = 0; i < 6; i++) {
+            new_combo1[i] = -1;
+            new_combo2[i] = -1;
+        }
+        input_index = 0;
+        confirm_phase = 0;
+    }
+
+    static void add_digit(void) {
+        if (input_index >= 6) {
+            return;
+        }
+        if (confirm_phase == 0) {
+            new_combo1[input_index] = last_digit;
+        } else {
+            new_combo2[input_index] = last_digit;
+        }
+        input_index++;
         if (input_index >= 6 && confirm_phase == 0) {
             confirm_phase = 1;
             input_index = 0;
             display_string(1, "confirm - - -");
         }
+    }
+
+    static void finish_change(void) {
+        bool is_complete = true;
+        bool is_confirmed = true;
+        for (int i = 0; i < 6; i++) {
+            is_complete = is_complete && new_combo1[i] != -1 && new_combo2[i] != -1;
+            is_confirmed = is_confirmed && new_combo1[i] == new_combo2[i];
+        }
+        if (!is_complete || !is_confirmed) {
+            display_string(1, "no change");
+            return;
+        }
+        for (int i = 0; i < COMBO_LENGTH; i++) {
+            new_combination[i] = (new_combo1[2 * i] * 10) + new_combo1[2 * i + 1];
+        }
+        if (new_combination[0] > 15 || new_combination[1] > 15 || new_combination[2] > 15) {
+            display_string(1, "no change");
+        } else {
+            for (int i = 0; i < COMBO_LENGTH; i++) {
+                combination[i] = new_combination[i];
+            }
+            display_string(1, "changed");
+        }
+    }
+
+    /* transition table */
+
+    #define ON(action, next_state)  {(action), (next_state)}
+    #define IGNORE                  {NULL, UNCHANGED}
+
+    /* One row per state, with one cell per event in lock_event_t order: overcount, clockwise, counterclockwise,
+     * good entry, bad entry, final bad entry, relock, begin change, digit, end change, pattern done. */
+    #define ROW(state, ...)         [state] = {__VA_ARGS__},
+
+    #define TRANSITION_TABLE(ROW)                                                                                     \
+        ROW(LOCKED_ENTERING_FIRST,                                                                                   \
+            IGNORE, ON(count_first_pass, UNCHANGED), ON(enter_first_number, LOCKED_ENTERING_SECOND),                 \
+            IGNORE, IGNORE, IGNORE,                                                                                  \
+            IGNORE, IGNORE, IGNORE, IGNORE, IGNORE)                                                                  \
+        ROW(LOCKED_ENTERING_SECOND,                                                                                  \
+            ON(reset_entry, LOCKED_ENTERING_FIRST),                                                                  \
+            ON(enter_second_number, LOCKED_ENTERING_THIRD), ON(count_second_pass, UNCHANGED),                        \
+            IGNORE, IGNORE, IGNORE,                                                                                  \
+            IGNORE, IGNORE, IGNORE, IGNORE, IGNORE)                                                                  \
+        ROW(LOCKED_ENTERING_THIRD,                                                                                   \
+            ON(reset_entry, LOCKED_ENTERING_FIRST),                                                                  \
+            ON(count_third_pass, UNCHANGED), ON(reset_entry, LOCKED_ENTERING_FIRST),                                 \
+            ON(open_lock, UNLOCKED), ON(reject_entry, FAILED), ON(raise_alarm, ALARMED),                             \
+            IGNORE, IGNORE, IGNORE, IGNORE, IGNORE)                                                                  \
+        ROW(UNLOCKED,                                                                                                \
+            IGNORE, IGNORE, IGNORE,                                                                                  \
+            IGNORE, IGNORE, IGNORE,                                                                                  \
+            ON(reset_entry, LOCKED_ENTERING_FIRST), ON(begin_change, CHANGING), IGNORE, IGNORE, IGNORE)              \
+        ROW(ALARMED,                                                                                                 \
+            IGNORE, IGNORE, IGNORE,                                                                                  \
+            IGNORE, IGNORE, IGNORE,                                                                                  \
+            IGNORE, IGNORE, IGNORE, IGNORE, IGNORE)                                                                  \
+        ROW(CHANGING,                                                                                                \
+            IGNORE, IGNORE, IGNORE,                                                                                  \
+            IGNORE, IGNORE, IGNORE,                                                                                  \
+            IGNORE, IGNORE, ON(add_digit, UNCHANGED), ON(finish_change, UNLOCKED), IGNORE)                           \
+        ROW(FAILED,                                                                                                  \
+            IGNORE, IGNORE, IGNORE,                                                                                  \
+            IGNORE, IGNORE, IGNORE,                                                                                  \
+            IGNORE, IGNORE, IGNORE, IGNORE, ON(reset_entry, LOCKED_ENTERING_FIRST))
+
+    static struct transition const transitions[NUMBER_OF_LOCK_STATES][NUMBER_OF_LOCK_EVENTS] = {
+            TRANSITION_TABLE(ROW)
+    };
+
+    /* every state must have exactly one row: as many rows as states, and no state left out */
+    #define COUNT_ROW(state, ...)   + 1
+    #define MARK_ROW(state, ...)    | (1u << (state))
+    _Static_assert(0 TRANSITION_TABLE(COUNT_ROW) == NUMBER_OF_LOCK_STATES, "each lock state needs exactly one row");
+    _Static_assert((0 TRANSITION_TABLE(MARK_ROW)) == (1u << NUMBER_OF_LOCK_STATES) - 1, "a lock state has no row");
+
+    /* and every row must have one cell per lock event; an event added to lock_event_t needs a cell in each row */
+    #define CHECK_ROW(state, ...)                                                                                     \
+        _Static_assert(sizeof((struct transition const[]) {__VA_ARGS__}) / sizeof(struct transition)                 \
+                       == NUMBER_OF_LOCK_EVENTS, "the " #state " row needs one cell per lock event");
+    TRANSITION_TABLE(CHECK_ROW)
+
+    /* rendering */
+
+    static void render_entry(void) {
+        char buffer[20];
+        if (!user_has_interacted) {
+            sprintf(buffer, "- - -");
+        } else if (current_state == LOCKED_ENTERING_FIRST) {
+            sprintf(buffer, "%02d-  -  ", current_value);
+        } else if (current_state == LOCKED_ENTERING_SECOND) {
+            sprintf(buffer, "%02d-%02d-  ", entered_combination[0], current_value);
+        } else {
+            sprintf(buffer, "%02d-%02d-%02d", entered_combination[0], entered_combination[1], current_value);
+        }
+        display_string(1, buffer);
+    }
+
+    static void render_new_combination(void) {
+        char buffer[20];
+        int const *combo = (confirm_phase == 0) ? new_combo1 : new_combo2;
+        char *end = buffer;
+        for (int i = 0; i < 6; i++) {
+            *end++ = (i < input_index) ? (char) ('0' + combo[i]) : ' ';
+            if (i % 2 && i < 5) {
+                *end++ = '-';
+            }
+        }
+        *end = '\0';
+        display_string(1, buffer);
+    }
+
+    static void (*const renderers[NUMBER_OF_LOCK_STATES])(void) = {
+            [LOCKED_ENTERING_FIRST] = render_entry,
+            [LOCKED_ENTERING_SECOND] = render_entry,
+            [LOCKED_ENTERING_THIRD] = render_entry,
+            [CHANGING] = render_new_combination,
+    };
 
-            // if(combo_phase == ENTERING_FIRST){
-            //     count = 0;
-            //     while(count != 2){
-            //         if(count == 0){
-            //             if(key <= 9){
-            //                 new_combo1[0] = key;
-            //                 key = 10;
-            //                 count++;
-            //             }
-            //         } else {
-            //             if(key <= 9){
-            //                 new_combo1[1] = key;
-            //                 key = 10;
-            //                 count++;
-            //                 combo_phase = ENTERING_SECOND;
-            //             } 
-            //         }
-            //     }
-            // } else if(combo_phase == ENTERING_SECOND){
-            //     count = 0;
-            //     while(count != 2){
-            //         if(count == 0){
-            //             if(key <= 9){
-            //                 new_combo1[2] = key;
-            //                 key = 10;
-            //                 count++;
-            //             }
-            //         } else {
-            //             if(key <= 9){
-            //                 new_combo1[3] = key;
-            //                 key = 10;
-            //                 count++;
-            //                 combo_phase = ENTERING_THIRD;
-            //             } 
-            //         }
-            //     }
-            // } else if(combo_phase == ENTERING_THIRD){
-            //     count = 0;
-            //     while(count != 2){
-            //         if(count == 0){
-            //             if(key <= 9){
-            //                 new_combo1[4] = key;
-            //                 key = 10;
-            //                 count++;
-            //             }
-            //         } else {
-            //             if(key <= 9){
-            //                 new_combo1[5] = key;
-            //                 key = 10;
-            //                 count++;
-            //             } 
-            //         }
-            //     }
-            // }
-            // if(new_combo1[0] == -1){
-            //     sprintf(buffer, "  -  -  ");
-            // } else if (combo_phase == ENTERING_FIRST) {
-            //     if(count == 1){
-            //         sprintf(buffer, "%01d -  -  ", new_combo1[0]);
-            //     } else {
-            //         sprintf(buffer, "%01d%01d-  -  ", new_combo1[0], new_combo1[1]);
-            //     }
-            // } else if (combo_phase == ENTERING_SECOND) {
-            //     if(count == 1){
-            //         sprintf(buffer, "%01d%01d-%01d -  ", new_combo1[0], new_combo1[1], new_combo1[2]);
-            //     } else {
-            //         sprintf(buffer, "%01d%01d-%01d%01d-  ", new_combo1[0], new_combo1[1], new_combo1[2], new_combo1[3]);
-            //     }
-            // } else if (combo_phase == ENTERING_THIRD) {
-            //     if(count == 1){
-            //         sprintf(buffer, "%01d%01d-%01d%01d-%01d ", new_combo1[0], new_combo1[1], new_combo1[2], new_combo1[3], new_combo1[4]);
-            //     } else {
-            //         sprintf(buffer, "%01d%01d-%01d%01d-%01d%01d", new_combo1[0], new_combo1[1], new_combo1[2], new_combo1[3], new_combo1[4], new_combo1[5]);
-            //     }
-            // }
-
-            if(cowpi_left_switch_is_in_left_position()){
-                if(new_combo1[0] == -1 || new_combo1[1] == -1 || new_combo1[2] == -1 || new_combo1[3] == -1 || new_combo1[4] == -1 || new_combo1[5] == -1 || new_combo2[0] == -1 || new_combo2[1] == -1 || new_combo2[2] == -1 || new_combo2[3] == -1 || new_combo2[4] == -1 || new_combo2[5] == -1){
-                    sprintf(buffer, "no change");
-                } else if(new_combo1[0] != new_combo2[0] || new_combo1[1] != new_combo2[1] || new_combo1[2] != new_combo2[2] || new_combo1[3] != new_combo2[3] || new_combo1[4] != new_combo2[4] || new_combo1[5] != new_combo2[5]){
-                    sprintf(buffer, "no change");
-                } else if(new_combo1[0] == new_combo2[0] && new_combo1[1] == new_combo2[1] && new_combo1[2] == new_combo2[2] && new_combo1[3] == new_combo2[3] && new_combo1[4] == new_combo2[4] && new_combo1[5] == new_combo2[5]){
-                    new_combination[0] = (new_combo1[0] * 10) + new_combo1[1];
-                    new_combination[1] = (new_combo1[2] * 10) + new_combo1[3];
-                    new_combination[2] = (new_combo1[4] * 10) + new_combo1[5];
-                    if(new_combination[0] > 15 || new_combination[1] > 15 || new_combination[2] > 15){
-                        sprintf(buffer, "no change"); 
-                    } else {
-                        combination[0] = new_combination[0];
-                        combination[1] = new_combination[1];
-                        combination[2] = new_combination[2];
-                        sprintf(buffer, "changed"); 
-                    }
-                }
-                set_lock_state(UNLOCKED);
+    /* events */
+
+    static int collect_events(lock_event_t events[]) {
+        static uint8_t last_key = 0xFF;
+        int number_of_events = 0;
+        if (second_seen_count > 2 || third_seen_count > 1) {
+            events[number_of_events++] = EVENT_OVERCOUNT;
+        }
+        direction_t dir = get_direction();
+        if (dir == CLOCKWISE) {
+            events[number_of_events++] = EVENT_CLOCKWISE;
+        } else if (dir == COUNTERCLOCKWISE) {
+            events[number_of_events++] = EVENT_COUNTERCLOCKWISE;
+        }
+        bool left_button = cowpi_left_button_is_pressed();
+        bool right_button = cowpi_right_button_is_pressed();
+        if (left_button) {
+            bool correct = (entered_combination[0] == combination[0] && first_seen_count >= 3)
+                           && (entered_combination[1] == combination[1] && second_seen_count == 2)
+                           && (current_value == combination[2] && third_seen_count == 1);
+            if (correct) {
+                events[number_of_events++] = EVENT_GOOD_ENTRY;
+            } else {
+                events[number_of_events++] = (bad_attempts + 1 >= 3) ? EVENT_FINAL_BAD_ENTRY : EVENT_BAD_ENTRY;
             }
-            display_string(1, buffer);
+        }
+        if (left_button && right_button) {
+            events[number_of_events++] = EVENT_RELOCK;
+        }
+        if (cowpi_left_switch_is_in_right_position() && right_button) {
+            events[number_of_events++] = EVENT_BEGIN_CHANGE;
+        }
+        uint8_t key = cowpi_get_keypress();
+        if (key != 0xFF && key != last_key && key >= '0' && key <= '9') {
+            last_digit = key - '0';
+            events[number_of_events++] = EVENT_DIGIT;
+        }
+        last_key = key;
+        if (cowpi_left_switch_is_in_left_position()) {
+            events[number_of_events++] = EVENT_END_CHANGE;
+        }
+        if (!led_pattern_is_running()) {
+            events[number_of_events++] = EVENT_PATTERN_DONE;
+        }
+        return number_of_events;
+    }
+
+    void initialize_lock_controller() {
+        set_lock_state(LOCKED_ENTERING_FIRST);
+        reset_entry();
+        bad_attempts = 0;
+        display_string(1, "- - -");
+        rotate_full_clockwise();
+        force_combination_reset();
+    }
+
+    /* performs the current state's transition on the event, and reports whether the state changed */
+    static bool dispatch(lock_event_t event) {
+        struct transition const *transition = &transitions[get_lock_state()][event];
+        if (transition->action) {
+            transition->action();
+        }
+        if (transition->next_state == UNCHANGED) {
+            return false;
+        }
+        set_lock_state(transition->next_state);
+        return true;
+    }
+
+    void control_lock() {
+        lock_event_t events[NUMBER_OF_LOCK_EVENTS];
+        int number_of_events = collect_events(events);
+        // the first event that changes the state ends this pass; the next pass reads the inputs afresh
+        for (int i = 0; i < number_of_events; i++) {
+            if (dispatch(events[i])) {
+                break;
+            }
+        }
+        if (renderers[get_lock_state()]) {
+            renderers[get_lock_state()]();
         }
     }
-    
@@ -22,11 +22,84 @@
 
 #include <CowPi.h>
 #include "display.h"
+#include "display-binding.h"
+#include "interrupt_support.h"
+#include "isr-instrumentation.h"
+#include "loop-profiler.h"
+#include "microsecond-timer.h"
 #include "rotary-encoder.h"
 #include "servomotor.h"
 #include "lock-controller.h"
+#include "lock-tasks.h"
+#include "scheduler.h"
+#include "timer-wheel.h"
+#include "work-queue.h"
 
-static bool test_mode;
+#if defined (__MBED__)
+#define TIMER_WHEEL_ALARM (1)   // alarm 0 belongs to the servo
+#if defined (ARDUINO_ARCH_RP2040)
+#define LEFT_BUTTON_PIN   (25)  // the Cow Pi's D2 and D3 on the Nano RP2040 Connect
+#define RIGHT_BUTTON_PIN  (15)
+#define BUTTON_SETTLING_us (2000)
+#endif //ARDUINO_ARCH_RP2040
+#else
+#define TIMER_WHEEL_TIMER (3)   // timers 0-2 belong to the servo and the rotary encoder
+#endif //__MBED__
+
+#define INPUT_POLL_PERIOD_us    (10000)
+#define DISPLAY_FRAME_PERIOD_us (1000000 / 30)
+
+static struct software_timer input_poll_timer;
+static struct software_timer display_frame_timer;
+
+#if defined (__MBED__)
+static void set_timer_wheel_alarm(uint32_t delay_us, void (*isr)(void)) {
+    register_alarm_ISR(TIMER_WHEEL_ALARM, delay_us, isr);
+}
+
+static void cancel_timer_wheel_alarm(void) {
+    cancel_alarm(TIMER_WHEEL_ALARM);
+}
+
+static struct timer_wheel_clock const timer_wheel_clock = {
+        .now_us = get_microseconds,
+        .set_alarm = set_timer_wheel_alarm,
+        .cancel_alarm = cancel_timer_wheel_alarm,
+};
+#endif //__MBED__
+
+/*
+ * Prints the report whose key was typed in the Serial Monitor: with
+ * `LOOP_PROFILING`, `p` for the loop profile; with `ISR_INSTRUMENTATION`, `i`
+ * for the ISR report; `w` for the work queue's statistics, `b` for the
+ * display bindings' skipped renders, and `s` for each scheduler task's run
+ * count and run times.
+ */
+static void print_requested_report(void) {
+    switch (get_serial_command()) {
+#ifdef LOOP_PROFILING
+        case 'p':
+            print_loop_profile();
+            break;
+#endif
+#ifdef ISR_INSTRUMENTATION
+        case 'i':
+            print_isr_report();
+            break;
+#endif
+        case 'w':
+            print_work_queue_statistics();
+            break;
+        case 'b':
+            print_display_binding_statistics();
+            break;
+        case 's':
+            print_scheduler_statistics();
+            break;
+        default:
+            break;
+    }
+}
 
 void setup() {
     record_build_timestamp(__FILE__, __DATE__, __TIME__);
@@ -35,36 +108,35 @@ void setup() {
                 (cowpi_display_module_protocol_t) {.protocol = NO_PROTOCOL}
                );
     initialize_display(21);
+    set_display_flush_mode(DISPLAY_FLUSH_BACKGROUND);
+    set_display_frame_rate(30);
+    work_queue_initialize();
+    work_queue_set_notify(lock_tasks_post_deferred_work);
+#if defined (__MBED__)
+    timer_wheel_initialize(TIMER_WHEEL_TICK_us, &timer_wheel_clock);
+#else
+    timer_wheel_initialize(TIMER_WHEEL_TICK_us, NULL);
+    register_periodic_timer_ISR(TIMER_WHEEL_TIMER, TIMER_WHEEL_TICK_us, timer_wheel_tick);
+#endif //__MBED__
     initialize_rotary_encoder();
     initialize_servo();
     initialize_lock_controller();
     print_build_timestamps(true);
-    test_mode = cowpi_right_switch_is_in_left_position();
+    lock_tasks_add(cowpi_right_switch_is_in_left_position());     // the right switch selects test mode
+    set_encoder_event_callback(lock_tasks_post_encoder_step);
+    set_encoder_step_deferral(true);
+#if defined (LEFT_BUTTON_PIN)
+    register_filtered_pin_ISR((1 << LEFT_BUTTON_PIN) | (1 << RIGHT_BUTTON_PIN), lock_tasks_post_input_change,
+                              PIN_FILTER_SETTLE_THEN_CONFIRM, BUTTON_SETTLING_us);
+#endif //LEFT_BUTTON_PIN
+    timer_wheel_arm(&input_poll_timer, INPUT_POLL_PERIOD_us, INPUT_POLL_PERIOD_us, lock_tasks_poll_inputs, NULL);
+    timer_wheel_arm(&display_frame_timer, DISPLAY_FRAME_PERIOD_us, DISPLAY_FRAME_PERIOD_us,
+                    lock_tasks_post_display_frame, NULL);
+    scheduler_post_event(EVENT_INPUT_CHANGE | EVENT_DISPLAY_FRAME);
 }
 
 void loop() {
-    if (test_mode) {
-        static char rotations_buffer[22] = {0};
-        static char servo_buffer[22] = {0};
-        static char combo_buffer[22] = {0};
-        count_rotations(rotations_buffer);
-        display_string(1, rotations_buffer);
-        test_servo(servo_buffer);
-        display_string(2, servo_buffer);
-        uint8_t const *combination = get_combination();
-        sprintf(combo_buffer, "Combo: %02d-%02d-%02d", combination[0], combination[1], combination[2]);
-        display_string(3, combo_buffer);
-        static bool is_pressed = false;
-        if (cowpi_right_button_is_pressed() && !is_pressed) {
-            is_pressed = true;
-            force_combination_reset();
-        }
-        if (!cowpi_right_button_is_pressed() && is_pressed) {
-            is_pressed = false;
-        }
-    } else {
-        control_lock();
-    }
-    refresh_display();
-    count_visits(7);
-}
\ No newline at end of file
+    scheduler_run();
+    count_loop_pass();
+    print_requested_report();
+}
@@ -0,0 +1,69 @@
+/**************************************************************************//**
+ *
+ * @file display-binding.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief display-binding.h
+ *
+ * @copydetails display-binding.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stdio.h>
+#include "display.h"
+#include "display-binding.h"
+
+static struct display_binding_statistics statistics = {0, 0};
+
+void display_binding_bind(struct display_binding *binding, int row, uint32_t (*get_state_key)(void),
+                          void (*render)(char buffer[])) {
+    binding->row = row;
+    binding->get_state_key = get_state_key;
+    binding->render = render;
+    binding->rendered_key = 0;
+    binding->is_rendered = false;
+}
+
+bool display_binding_update(struct display_binding *binding) {
+    uint32_t key = binding->get_state_key();
+    if (binding->is_rendered && key == binding->rendered_key) {
+        statistics.skipped_renders++;
+        return false;
+    }
+    char buffer[DISPLAY_BINDING_BUFFER_SIZE];
+    binding->render(buffer);
+    display_string(binding->row, buffer);
+    binding->rendered_key = key;
+    binding->is_rendered = true;
+    statistics.renders++;
+    return true;
+}
+
+void display_binding_invalidate(struct display_binding *binding) {
+    binding->is_rendered = false;
+}
+
+uint32_t display_binding_hash(void const *bytes, size_t number_of_bytes) {
+    uint8_t const *byte = bytes;
+    uint32_t hash = 2166136261u;
+    while (number_of_bytes--) {
+        hash = (hash ^ *byte++) * 16777619u;
+    }
+    return hash;
+}
+
+struct display_binding_statistics display_binding_get_statistics(void) {
+    return statistics;
+}
+
+void print_display_binding_statistics(void) {
+    printf("display bindings: %lu renders, %lu skipped\n", (unsigned long) statistics.renders,
+           (unsigned long) statistics.skipped_renders);
+}
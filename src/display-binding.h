@@ -0,0 +1,112 @@
+/**************************************************************************//**
+ *
+ * @file display-binding.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Binds a display row to the state that it shows, so that the row is
+ *      formatted only when that state changes.
+ *
+ * A binding pairs a row with a render function and a function that returns a
+ * key for the state the row depends on: a version number that the state's
+ * owner bumps on each change, or a hash of the state (see
+ * `display_binding_hash()`). `display_binding_update()` compares the key with
+ * the one from the previous render and calls the render function only if they
+ * differ, so a caller can update its rows on every pass without formatting
+ * the strings anew each time.
+ *
+ * The module counts renders and skipped renders across all bindings, which
+ * shows how much formatting the bindings avoid.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_DISPLAY_BINDING_H
+#define COMBOLOCK_DISPLAY_BINDING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DISPLAY_BINDING_BUFFER_SIZE (22)    // up to 21 columns and the terminating NUL
+
+struct display_binding {
+    int row;
+    uint32_t (*get_state_key)(void);
+    void (*render)(char buffer[]);
+    uint32_t rendered_key;          // the state key when the row was last rendered
+    bool is_rendered;               // false until the first render, or after invalidation
+};
+
+struct display_binding_statistics {
+    uint32_t renders;
+    uint32_t skipped_renders;
+};
+
+/**
+ * @brief Binds a row to its state and render function. The row is rendered by
+ * the next call to `display_binding_update()`.
+ *
+ * @param binding The binding to be initialized; it may be statically allocated
+ * @param row The display row that the binding controls
+ * @param get_state_key Returns a version number or hash of the state that the
+ *      row shows
+ * @param render Formats the row's string into a buffer of
+ *      `DISPLAY_BINDING_BUFFER_SIZE` characters
+ */
+void display_binding_bind(struct display_binding *binding, int row, uint32_t (*get_state_key)(void),
+                          void (*render)(char buffer[]));
+
+/**
+ * @brief Re-renders the row if its state has changed since the last render.
+ *
+ * @param binding The binding to be updated
+ * @return `true` if the row was rendered; `false` if the render was skipped
+ */
+bool display_binding_update(struct display_binding *binding);
+
+/**
+ * @brief Forces the next `display_binding_update()` to render the row, such as
+ * after something else has written to that row.
+ *
+ * @param binding The binding to be invalidated
+ */
+void display_binding_invalidate(struct display_binding *binding);
+
+/**
+ * @brief Computes a 32-bit FNV-1a hash, for use as a state key when the state
+ * has no version number.
+ *
+ * @param bytes The state to be hashed
+ * @param number_of_bytes The size of the state
+ * @return The hash
+ */
+uint32_t display_binding_hash(void const *bytes, size_t number_of_bytes);
+
+/**
+ * @brief Reports how many times bindings were rendered and how many times a
+ * render was skipped because the state had not changed.
+ *
+ * @return The counts across all bindings
+ */
+struct display_binding_statistics display_binding_get_statistics(void);
+
+/**
+ * @brief Prints the counts of renders and skipped renders across all bindings.
+ */
+void print_display_binding_statistics(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_DISPLAY_BINDING_H
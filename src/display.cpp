@@ -23,14 +23,24 @@
  * limitations under the License.
  */
 
+#if defined (ARDUINO)
 #include <CowPi.h>
 #include <CowPi_stdio.h>
+#endif
 #include <stdlib.h>
 #include "display.h"
+#include "display-binding.h"
+#include "fixed-format.h"
+#include "loop-profiler.h"
+#include "microsecond-timer.h"
 
+#if defined (VIRTUAL_SSD1306)
+#include "virtual-ssd1306.h"
+#else
 #if __has_include(<OneBitDisplay.h>)
 #define ONEBIT
 #include <OneBitDisplay.h>
+#include <Wire.h>
 #endif
 #if __has_include(<Adafruit_SSD1306.h>)
 #define ADAFRUITSSD1306
@@ -41,8 +51,11 @@
 #elif !defined (ONEBIT) && !defined (ADAFRUITSSD1306)
 #error "Neither the OneBitDisplay library nor the Adafruit_SSD1306 library has been imported."
 #endif
+#endif //VIRTUAL_SSD1306
 
-#if defined (__AVR__)
+#if defined (VIRTUAL_SSD1306) && !defined (ARDUINO)
+#define CORELIBRARY ("host")
+#elif defined (__AVR__)
 #define CORELIBRARY ("avr-libc")
 #elif defined (__MBED__)
 #define CORELIBRARY ("MBED")
@@ -59,10 +72,38 @@ static int character_width;
 static int character_height;
 
 static inline void library_specific_initialize_display(int number_of_columns);
+static inline void library_specific_render_row(int row, int first_column, int last_column);
+static inline uint8_t const *library_specific_framebuffer(void);
+static inline int library_specific_left_margin(void);
+static void mark_display_dirty(void);
 
 static char rows[8][23] = {{0}, {0}, {0}, {0}, {0}, {0}, {0}, {0}};
 
-#if defined ONEBIT
+/* Dirty-region tracking: a row's bit is set in `dirty_rows` when any of its
+ * characters changed since the last refresh, and the changed characters lie
+ * within [dirty_first_column, dirty_last_column]. `frame_is_dirty` forces the
+ * whole framebuffer out (after clearing the display or drawing the logo). */
+static uint8_t dirty_rows = 0;
+static int8_t dirty_first_column[8];
+static int8_t dirty_last_column[8];
+static bool frame_is_dirty = true;
+
+static uint32_t number_of_dropped_frames;
+
+static uint32_t bytes_sent_by_last_refresh = 0;
+static uint32_t bytes_sent_in_total = 0;
+
+#define SSD1306_I2C_ADDRESS     (0x3C)
+#define SSD1306_COMMAND_STREAM  (0x00)
+#define SSD1306_DATA_STREAM     (0x40)
+#define I2C_CHUNK_SIZE          (16)    // payload bytes per transaction; fits in even the AVR's 32-byte Wire buffer
+
+#if !defined (VIRTUAL_SSD1306)
+/* OneBitDisplay probes for the display module, which may answer at 0x3D instead */
+static uint8_t ssd1306_i2c_address = SSD1306_I2C_ADDRESS;
+#endif
+
+#if defined (VIRTUAL_SSD1306) || defined (ONEBIT)
 
 static uint8_t logo[] = {
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
@@ -131,12 +172,92 @@ static uint8_t logo[] = {
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
 };
 
+#endif
+
+#if defined (VIRTUAL_SSD1306)
+
+/* 5x7 glyphs for ASCII 0x20-0x7E, one byte per column, bit 0 at the top */
+static uint8_t const glyphs[95][5] = {
+        {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5f, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00}, {0x14, 0x7f, 0x14, 0x7f, 0x14}, {0x24, 0x2a, 0x7f, 0x2a, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62}, {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00},
+        {0x00, 0x1c, 0x22, 0x41, 0x00}, {0x00, 0x41, 0x22, 0x1c, 0x00}, {0x08, 0x2a, 0x1c, 0x2a, 0x08}, {0x08, 0x08, 0x3e, 0x08, 0x08}, {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00}, {0x20, 0x10, 0x08, 0x04, 0x02},
+        {0x3e, 0x51, 0x49, 0x45, 0x3e}, {0x00, 0x42, 0x7f, 0x40, 0x00}, {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4b, 0x31}, {0x18, 0x14, 0x12, 0x7f, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3c, 0x4a, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+        {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1e}, {0x00, 0x36, 0x36, 0x00, 0x00}, {0x00, 0x56, 0x36, 0x00, 0x00}, {0x00, 0x08, 0x14, 0x22, 0x41}, {0x14, 0x14, 0x14, 0x14, 0x14}, {0x41, 0x22, 0x14, 0x08, 0x00}, {0x02, 0x01, 0x51, 0x09, 0x06},
+        {0x32, 0x49, 0x79, 0x41, 0x3e}, {0x7e, 0x11, 0x11, 0x11, 0x7e}, {0x7f, 0x49, 0x49, 0x49, 0x36}, {0x3e, 0x41, 0x41, 0x41, 0x22}, {0x7f, 0x41, 0x41, 0x22, 0x1c}, {0x7f, 0x49, 0x49, 0x49, 0x41}, {0x7f, 0x09, 0x09, 0x01, 0x01}, {0x3e, 0x41, 0x41, 0x51, 0x32},
+        {0x7f, 0x08, 0x08, 0x08, 0x7f}, {0x00, 0x41, 0x7f, 0x41, 0x00}, {0x20, 0x40, 0x41, 0x3f, 0x01}, {0x7f, 0x08, 0x14, 0x22, 0x41}, {0x7f, 0x40, 0x40, 0x40, 0x40}, {0x7f, 0x02, 0x04, 0x02, 0x7f}, {0x7f, 0x04, 0x08, 0x10, 0x7f}, {0x3e, 0x41, 0x41, 0x41, 0x3e},
+        {0x7f, 0x09, 0x09, 0x09, 0x06}, {0x3e, 0x41, 0x51, 0x21, 0x5e}, {0x7f, 0x09, 0x19, 0x29, 0x46}, {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7f, 0x01, 0x01}, {0x3f, 0x40, 0x40, 0x40, 0x3f}, {0x1f, 0x20, 0x40, 0x20, 0x1f}, {0x7f, 0x20, 0x18, 0x20, 0x7f},
+        {0x63, 0x14, 0x08, 0x14, 0x63}, {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x00, 0x7f, 0x41, 0x41}, {0x02, 0x04, 0x08, 0x10, 0x20}, {0x41, 0x41, 0x7f, 0x00, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04}, {0x40, 0x40, 0x40, 0x40, 0x40},
+        {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78}, {0x7f, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7f}, {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7e, 0x09, 0x01, 0x02}, {0x08, 0x14, 0x54, 0x54, 0x3c},
+        {0x7f, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7d, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3d, 0x00}, {0x00, 0x7f, 0x10, 0x28, 0x44}, {0x00, 0x41, 0x7f, 0x40, 0x00}, {0x7c, 0x04, 0x18, 0x04, 0x78}, {0x7c, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38},
+        {0x7c, 0x14, 0x14, 0x14, 0x08}, {0x08, 0x14, 0x14, 0x18, 0x7c}, {0x7c, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20}, {0x04, 0x3f, 0x44, 0x40, 0x20}, {0x3c, 0x40, 0x40, 0x20, 0x7c}, {0x1c, 0x20, 0x40, 0x20, 0x1c}, {0x3c, 0x40, 0x30, 0x40, 0x3c},
+        {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0c, 0x50, 0x50, 0x50, 0x3c}, {0x44, 0x64, 0x54, 0x4c, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7f, 0x00, 0x00}, {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x08, 0x2a, 0x1c, 0x08}
+};
+
+static uint8_t backbuffer[1024] = {0};
+
+static inline void library_specific_initialize_display(int number_of_columns) {
+    virtual_ssd1306_reset();
+}
+
+/* Spreads the low four bits of a glyph column across eight bits, for the
+ * double-height characters used when there are ten or fewer columns. */
+static uint8_t double_height(uint8_t nibble) {
+    uint8_t doubled = 0;
+    for (int bit = 0; bit < 4; bit++) {
+        if (nibble & (1 << bit)) {
+            doubled |= (uint8_t) (3 << (2 * bit));
+        }
+    }
+    return doubled;
+}
+
+static inline void library_specific_render_row(int row, int first_column, int last_column) {
+    int scale = character_width / 6;
+    int page = row * scale;
+    for (int column = first_column; column <= last_column; column++) {
+        char c = rows[row][column];
+        uint8_t const *glyph = glyphs[(c >= 0x20 && c <= 0x7E) ? c - 0x20 : '?' - 0x20];
+        uint8_t *destination = backbuffer + 128 * page + character_width * column;
+        for (int x = 0; x < character_width; x++) {
+            uint8_t bits = (x / scale < 5) ? glyph[x / scale] : 0;
+            if (scale == 1) {
+                destination[x] = bits;
+            } else {
+                destination[x] = double_height(bits & 0x0F);
+                destination[x + 128] = double_height(bits >> 4);
+            }
+        }
+    }
+}
+
+static inline uint8_t const *library_specific_framebuffer(void) {
+    return backbuffer;
+}
+
+static inline int library_specific_left_margin(void) {
+    return 0;
+}
+
+void clear_display(void) {
+    memset(backbuffer, 0, sizeof(backbuffer));
+    mark_display_dirty();
+    refresh_display();
+}
+
+void draw_logo() {
+    memcpy(backbuffer, logo, 1024);
+    frame_is_dirty = true;
+    refresh_display();
+}
+
+#elif defined ONEBIT
+
 static uint8_t backbuffer[1024] = {0};
 static OBDISP display;
 static int font;
 
 static inline void library_specific_initialize_display(int number_of_columns) {
     obdI2CInit(&display, OLED_128x64, -1, 0, 0, 1, -1, -1, -1, 400000L);
+    ssd1306_i2c_address = display.oled_addr;        // the address that obdI2CInit() found the display module at
     obdSetBackBuffer(&display, backbuffer);
     switch (number_of_columns) {
         case 21:
@@ -156,23 +277,113 @@ static inline void library_specific_initialize_display(int number_of_columns) {
     }
 }
 
+/* Rendered-row cache: the most recent page strips rendered for each row, keyed
+ * by the row's text and the font. A row whose text matches a cached strip is
+ * copied into the backbuffer instead of being rasterized again; the hash only
+ * rejects most misses quickly, and a hit is confirmed by comparing the text.
+ * The cache takes about 4 KB, so it can be sized (or, with 0, removed) with
+ * `-DDISPLAY_ROW_CACHE_WAYS=n`; it is removed by default on the AVR. */
+#if !defined (DISPLAY_ROW_CACHE_WAYS)
+#if defined (__AVR__)
+#define DISPLAY_ROW_CACHE_WAYS  (0)
+#else
+#define DISPLAY_ROW_CACHE_WAYS  (2)
+#endif
+#endif //DISPLAY_ROW_CACHE_WAYS
+
+#if DISPLAY_ROW_CACHE_WAYS > 0
+
+struct rendered_row {
+    uint32_t hash;
+    bool is_valid;
+    uint8_t font;
+    char text[21];
+    uint8_t strip[256];     // 128 columns by up to two pages
+};
+
+static struct rendered_row row_cache[8][DISPLAY_ROW_CACHE_WAYS];
+static uint8_t row_cache_next_way[8] = {0};
+
+static inline uint32_t hash_row(int row) {
+    return display_binding_hash(rows[row], column_count) ^ (uint32_t) font;
+}
+
+static void invalidate_row_cache(void) {
+    for (int row = 0; row < 8; row++) {
+        for (int way = 0; way < DISPLAY_ROW_CACHE_WAYS; way++) {
+            row_cache[row][way].is_valid = false;
+        }
+    }
+}
+
+static inline bool copy_cached_row(int row, uint32_t hash, uint8_t *strip, size_t strip_size) {
+    for (int way = 0; way < DISPLAY_ROW_CACHE_WAYS; way++) {
+        struct rendered_row const *entry = &row_cache[row][way];
+        if (entry->is_valid && entry->hash == hash && entry->font == font
+            && !memcmp(entry->text, rows[row], column_count)) {
+            memcpy(strip, entry->strip, strip_size);
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline void cache_row(int row, uint32_t hash, uint8_t const *strip, size_t strip_size) {
+    struct rendered_row *entry = &row_cache[row][row_cache_next_way[row]];
+    row_cache_next_way[row] = (uint8_t) ((row_cache_next_way[row] + 1) % DISPLAY_ROW_CACHE_WAYS);
+    entry->hash = hash;
+    entry->is_valid = true;
+    entry->font = (uint8_t) font;
+    memcpy(entry->text, rows[row], column_count);
+    memcpy(entry->strip, strip, strip_size);
+}
+
+#else
+
+static inline void invalidate_row_cache(void) {}
+
+#endif //DISPLAY_ROW_CACHE_WAYS
+
+static inline void library_specific_render_row(int row, int first_column, int last_column) {
+#if DISPLAY_ROW_CACHE_WAYS > 0
+    size_t strip_size = 128 * (character_height / 8);
+    uint8_t *strip = backbuffer + strip_size * row;
+    uint32_t hash = hash_row(row);
+    if (copy_cached_row(row, hash, strip, strip_size)) {
+        return;
+    }
+#endif
+    char characters[23];
+    int length = last_column - first_column + 1;
+    memcpy(characters, rows[row] + first_column, length);
+    characters[length] = '\0';
+    obdWriteString(&display, 0, character_width * first_column, character_height * row, characters, font, OBD_BLACK, 0);
+#if DISPLAY_ROW_CACHE_WAYS > 0
+    cache_row(row, hash, strip, strip_size);
+#endif
+}
+
+static inline uint8_t const *library_specific_framebuffer(void) {
+    return backbuffer;
+}
+
+static inline int library_specific_left_margin(void) {
+    return 0;
+}
+
 void clear_display(void) {
     obdFill(&display, OBD_WHITE, 0);
+    mark_display_dirty();
     refresh_display();
 }
 
 void draw_logo() {
     memcpy(backbuffer, logo, 1024);
+    invalidate_row_cache();     // the logo overwrites the rows' strips, so partial renders would capture it
+    frame_is_dirty = true;
     refresh_display();
 }
 
-void refresh_display(void) {
-    for (int row = 0; row < row_count; ++row) {
-        obdWriteString(&display, 0, 0, character_height * row, (char *) rows[row], font, OBD_BLACK, 0);
-    }
-    obdDumpBuffer(&display, backbuffer);
-}
-
 
 #elif defined ADAFRUITSSD1306
 
@@ -246,32 +457,351 @@ static uint8_t logo[] = {
 static Adafruit_SSD1306 display(128, 64);
 
 static inline void library_specific_initialize_display(int number_of_columns) {
-    display.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+    display.begin(SSD1306_SWITCHCAPVCC, ssd1306_i2c_address);
     display.setTextSize((number_of_columns <= 10) ? 2 : 1);
     display.setTextColor(SSD1306_WHITE);
 }
 
+static inline void library_specific_render_row(int row, int first_column, int last_column) {
+    char characters[23];
+    int length = last_column - first_column + 1;
+    memcpy(characters, rows[row] + first_column, length);
+    characters[length] = '\0';
+    int16_t x = (int16_t) (library_specific_left_margin() + character_width * first_column);
+    int16_t y = (int16_t) (character_height * row);
+    display.fillRect(x, y, (int16_t) (character_width * length), (int16_t) character_height, SSD1306_BLACK);
+    display.setCursor(x, y);
+    display.print(characters);
+}
+
+static inline uint8_t const *library_specific_framebuffer(void) {
+    return display.getBuffer();
+}
+
+static inline int library_specific_left_margin(void) {
+    return (128 - (character_width * column_count)) / 2;
+}
+
 void clear_display(void) {
     display.clearDisplay();
+    mark_display_dirty();
     refresh_display();
 }
 
 void draw_logo() {
     display.drawBitmap(0, 0, logo, 128, 64, 1);
-    display.display();
+    frame_is_dirty = true;
+    refresh_display();
 }
 
-void refresh_display(void) {
-    display.clearDisplay();
+
+#endif
+
+
+static void mark_display_dirty(void) {
     for (int row = 0; row < row_count; ++row) {
-        display.setCursor((int16_t) ((128 - (character_width * column_count)) / 2), (int16_t) (character_height * row));
-        display.print(rows[row]);
+        dirty_first_column[row] = 0;
+        dirty_last_column[row] = (int8_t) (column_count - 1);
+    }
+    dirty_rows = (uint8_t) ((1 << row_count) - 1);
+    frame_is_dirty = true;
+}
+
+static void mark_row_dirty(int row, int first_column, int last_column) {
+    if (dirty_rows & (1 << row)) {
+        if (first_column < dirty_first_column[row]) dirty_first_column[row] = (int8_t) first_column;
+        if (last_column > dirty_last_column[row]) dirty_last_column[row] = (int8_t) last_column;
+    } else {
+        dirty_first_column[row] = (int8_t) first_column;
+        dirty_last_column[row] = (int8_t) last_column;
+        dirty_rows |= (uint8_t) (1 << row);
     }
-    display.display();
 }
 
+/* Copies `text` into the row, marking only the span of characters that differ. */
+static void update_row(int row, char const text[], int first_column, int last_column) {
+    int first_change = -1;
+    int last_change = -1;
+    for (int column = first_column; column <= last_column; column++) {
+        if (rows[row][column] != text[column - first_column]) {
+            rows[row][column] = text[column - first_column];
+            if (first_change < 0) first_change = column;
+            last_change = column;
+        }
+    }
+    if (first_change >= 0) {
+        if (dirty_rows & (1 << row)) {
+            number_of_dropped_frames++;     // the row's previous contents never reached the display
+        }
+        mark_row_dirty(row, first_change, last_change);
+    }
+}
 
+static void send_i2c_transaction(uint8_t control_byte, uint8_t const bytes[], size_t number_of_bytes) {
+#if defined (VIRTUAL_SSD1306)
+    virtual_ssd1306_transmit(control_byte, bytes, number_of_bytes);
+#else
+    Wire.beginTransmission(ssd1306_i2c_address);
+    Wire.write(control_byte);
+    Wire.write(bytes, number_of_bytes);
+    Wire.endTransmission();
+#endif
+    bytes_sent_in_total += number_of_bytes + 2;     // address byte + control byte + payload
+}
+
+static void send_ssd1306_commands(uint8_t const commands[], size_t number_of_commands) {
+    send_i2c_transaction(SSD1306_COMMAND_STREAM, commands, number_of_commands);
+}
+
+static inline void end_frame(void) {
+#if defined (VIRTUAL_SSD1306)
+    virtual_ssd1306_end_frame();
+#endif
+}
+
+struct ssd1306_window {
+    uint8_t first_page;
+    uint8_t last_page;
+    uint8_t first_x;
+    uint8_t last_x;
+};
+
+/* Renders the dirty rows into the library's framebuffer and reports the
+ * windows of GDDRAM that must be sent to bring the display module up to date.
+ * Clears the dirty flags. */
+static int render_dirty_rows(struct ssd1306_window windows[]) {
+    int number_of_windows = 0;
+    int pages_per_row = character_height / 8;
+    int left_margin = library_specific_left_margin();
+    for (int row = 0; row < row_count; ++row) {
+        if (dirty_rows & (1 << row)) {
+            library_specific_render_row(row, dirty_first_column[row], dirty_last_column[row]);
+            windows[number_of_windows++] = (struct ssd1306_window) {
+                    .first_page = (uint8_t) (pages_per_row * row),
+                    .last_page = (uint8_t) (pages_per_row * row + pages_per_row - 1),
+                    .first_x = (uint8_t) (left_margin + character_width * dirty_first_column[row]),
+                    .last_x = (uint8_t) (left_margin + character_width * (dirty_last_column[row] + 1) - 1),
+            };
+        }
+    }
+    if (frame_is_dirty) {
+        windows[0] = (struct ssd1306_window) {.first_page = 0, .last_page = 7, .first_x = 0, .last_x = 127};
+        number_of_windows = 1;
+    }
+    dirty_rows = 0;
+    frame_is_dirty = false;
+    return number_of_windows;
+}
+
+/* Sets the column and page address ranges of the SSD1306's horizontal
+ * addressing mode, after which data bytes fill the window left-to-right,
+ * top-to-bottom. */
+static void send_ssd1306_window_address(struct ssd1306_window const *window) {
+    uint8_t const commands[] = {
+            0x21, window->first_x, window->last_x,          // column address range
+            0x22, window->first_page, window->last_page     // page address range
+    };
+    send_ssd1306_commands(commands, sizeof(commands));
+}
+
+static void send_ssd1306_data(uint8_t const data[], size_t number_of_bytes) {
+    send_i2c_transaction(SSD1306_DATA_STREAM, data, number_of_bytes);
+}
+
+static void send_ssd1306_window(uint8_t const *framebuffer, struct ssd1306_window const *window) {
+    send_ssd1306_window_address(window);
+    for (int page = window->first_page; page <= window->last_page; page++) {
+        int x = window->first_x;
+        while (x <= window->last_x) {
+            int chunk = min(I2C_CHUNK_SIZE, window->last_x - x + 1);
+            send_ssd1306_data(framebuffer + 128 * page + x, chunk);
+            x += chunk;
+        }
+    }
+}
+
+/* Background flushing: the rendered frame is latched into `front_buffer`, and
+ * the windows that changed drain from it one I2C transaction per call to
+ * `service_display()`, while new text renders into the library's framebuffer.
+ * The Wire library cannot be used from interrupt context on MBED, so the
+ * flush is advanced from the main loop rather than from a timer ISR.
+ * The AVR cannot spare a second kilobyte for `front_buffer` beside the
+ * library's framebuffer, so there refreshes always block. */
+#if !defined (__AVR__)
+#define BACKGROUND_FLUSH_IS_SUPPORTED
+#endif
+
+static display_flush_mode_t flush_mode = DISPLAY_FLUSH_BLOCKING;
+static bool flush_is_in_progress = false;
+static uint32_t number_of_coalesced_refreshes = 0;
+static void (*flush_completion_callback)(void) = NULL;
+
+#if defined (BACKGROUND_FLUSH_IS_SUPPORTED)
+static uint8_t front_buffer[1024];
+static struct ssd1306_window flush_windows[8];
+static int number_of_flush_windows = 0;
+static int flush_window_index = 0;
+static int flush_page;
+static int flush_x;
+static bool flush_address_is_sent = false;
+static bool refresh_is_pending = false;
+static uint32_t bytes_sent_before_flush;
+
+static void start_background_flush(void) {
+    number_of_flush_windows = render_dirty_rows(flush_windows);
+    if (number_of_flush_windows == 0) {
+        return;
+    }
+    memcpy(front_buffer, library_specific_framebuffer(), sizeof(front_buffer));
+    flush_window_index = 0;
+    flush_page = flush_windows[0].first_page;
+    flush_x = flush_windows[0].first_x;
+    flush_address_is_sent = false;
+    bytes_sent_before_flush = bytes_sent_in_total;
+    flush_is_in_progress = true;
+}
+
+void service_display(void) {
+    if (!flush_is_in_progress) {
+        return;
+    }
+    struct ssd1306_window const *window = flush_windows + flush_window_index;
+    if (!flush_address_is_sent) {
+        send_ssd1306_window_address(window);
+        flush_address_is_sent = true;
+        return;
+    }
+    int chunk = min(I2C_CHUNK_SIZE, window->last_x - flush_x + 1);
+    send_ssd1306_data(front_buffer + 128 * flush_page + flush_x, chunk);
+    flush_x += chunk;
+    if (flush_x > window->last_x) {
+        flush_x = window->first_x;
+        if (++flush_page > window->last_page) {
+            if (++flush_window_index < number_of_flush_windows) {
+                flush_page = flush_windows[flush_window_index].first_page;
+                flush_x = flush_windows[flush_window_index].first_x;
+                flush_address_is_sent = false;
+            } else {
+                flush_is_in_progress = false;
+                bytes_sent_by_last_refresh = bytes_sent_in_total - bytes_sent_before_flush;
+                end_frame();
+                if (flush_completion_callback) {
+                    flush_completion_callback();
+                }
+                if (refresh_is_pending) {
+                    refresh_is_pending = false;
+                    start_background_flush();
+                }
+            }
+        }
+    }
+}
+
+#else
+
+void service_display(void) {}
+
+#endif //BACKGROUND_FLUSH_IS_SUPPORTED
+
+static void flush_frame(void) {
+#if defined (BACKGROUND_FLUSH_IS_SUPPORTED)
+    if (flush_mode == DISPLAY_FLUSH_BACKGROUND) {
+        if (flush_is_in_progress) {
+            if (dirty_rows || frame_is_dirty) {
+                if (refresh_is_pending) {
+                    number_of_coalesced_refreshes++;
+                }
+                refresh_is_pending = true;
+            }
+        } else {
+            start_background_flush();
+        }
+        service_display();
+        return;
+    }
+#endif //BACKGROUND_FLUSH_IS_SUPPORTED
+    while (flush_is_in_progress) {
+        service_display();
+    }
+    uint32_t bytes_sent_before_refresh = bytes_sent_in_total;
+    struct ssd1306_window windows[8];
+    int number_of_windows = render_dirty_rows(windows);
+    for (int i = 0; i < number_of_windows; i++) {
+        send_ssd1306_window(library_specific_framebuffer(), windows + i);
+    }
+    bytes_sent_by_last_refresh = bytes_sent_in_total - bytes_sent_before_refresh;
+    if (number_of_windows) {
+        end_frame();
+    }
+}
+
+/* Frame-rate governor: changes that arrive less than one frame interval after
+ * the previous frame began are held back and go out with the next frame. */
+static uint32_t frame_interval_us = 0;
+static uint32_t frame_start_us = 0;
+static uint32_t number_of_merged_frames = 0;
+
+void refresh_display(void) {
+    if (frame_interval_us && (dirty_rows || frame_is_dirty)) {
+        uint32_t now = get_microseconds();
+        if (now - frame_start_us < frame_interval_us) {
+            number_of_merged_frames++;
+            service_display();
+            return;
+        }
+        frame_start_us = now;
+    }
+    flush_frame();
+}
+
+void refresh_display_immediately(void) {
+    frame_start_us = get_microseconds();
+    flush_frame();
+}
+
+void set_display_frame_rate(unsigned int frames_per_second) {
+    frame_interval_us = frames_per_second ? 1000000 / frames_per_second : 0;
+}
+
+uint32_t get_display_merged_frame_count(void) {
+    return number_of_merged_frames;
+}
+
+uint32_t get_display_dropped_frame_count(void) {
+    return number_of_dropped_frames;
+}
+
+void set_display_flush_mode(display_flush_mode_t mode) {
+#if !defined (BACKGROUND_FLUSH_IS_SUPPORTED)
+    mode = DISPLAY_FLUSH_BLOCKING;
 #endif
+    if (mode == DISPLAY_FLUSH_BLOCKING) {
+        while (flush_is_in_progress) {
+            service_display();
+        }
+    }
+    flush_mode = mode;
+}
+
+bool display_flush_is_in_progress(void) {
+    return flush_is_in_progress;
+}
+
+void set_display_flush_callback(void (*callback)(void)) {
+    flush_completion_callback = callback;
+}
+
+uint32_t get_display_coalesced_refresh_count(void) {
+    return number_of_coalesced_refreshes;
+}
+
+uint32_t get_display_bytes_per_refresh(void) {
+    return bytes_sent_by_last_refresh;
+}
+
+uint32_t get_display_bytes_sent(void) {
+    return bytes_sent_in_total;
+}
 
 
 void initialize_display(int number_of_columns) {
@@ -284,21 +814,29 @@ void initialize_display(int number_of_columns) {
     character_width = (number_of_columns <= 10) ? 12 : 6;
     character_height = (number_of_columns <= 10) ? 16 : 8;
     library_specific_initialize_display(number_of_columns);
+    for (int row = 0; row < row_count; ++row) {
+        memset(rows[row], ' ', column_count);
+        rows[row][column_count] = '\0';
+    }
+    uint8_t const horizontal_addressing_mode[] = {0x20, 0x00};
+    send_ssd1306_commands(horizontal_addressing_mode, sizeof(horizontal_addressing_mode));
     clear_display();
 }
 
 void display_string(int row, char const string[]) {
     static char buffer[23] = {"                      "};
     size_t string_length = strlen(string);
-    if (0 <= row && row < row_count) {
-        sprintf(buffer, "%-*s", column_count, string);
+    if (row < 0 || row >= row_count) {
+        return;
     }
-    if (string[string_length - 1] == '\n') {
-        buffer[string_length - 1] = '\0';
-        memcpy(rows[row], buffer, 21);
-        refresh_display();
-    } else {
-        memcpy(rows[row], buffer, 21);
+    format_end(format_padded_string(buffer, string, column_count));
+    bool refresh_now = string_length > 0 && string[string_length - 1] == '\n';
+    if (refresh_now && string_length <= (size_t) column_count) {
+        buffer[string_length - 1] = ' ';
+    }
+    update_row(row, buffer, 0, column_count - 1);
+    if (refresh_now) {
+        refresh_display_immediately();
     }
 }
 
@@ -432,15 +970,51 @@ void print_build_timestamps(bool only_most_recent) {
     refresh_display();
 }
 
-// TODO: this will break without the rows being partially exposed
+#if defined (ARDUINO)
+int get_serial_command(void) {
+    return Serial.available() ? Serial.read() : -1;
+}
+#else
+int get_serial_command(void) {
+    return -1;
+}
+#endif
+
+void count_loop_pass(void) {
+    mark_loop_iteration();
+}
+
+#ifdef LOOP_PROFILING
+
+void count_visits(int row) {
+    static uint32_t displayed_rate = UINT32_MAX;
+    uint32_t rate = get_loop_profile().iterations_per_second;
+    if (rate != displayed_rate) {
+        displayed_rate = rate;
+        char digits[7];
+        char const *source = digits + sizeof(digits);
+        char *destination = digits + sizeof(digits);
+        do {
+            *--destination = (char) ('0' + rate % 10);
+            rate /= 10;
+        } while (rate && destination > digits);
+        char field[7];
+        format_padded_string(field, "", (int) (destination - digits));
+        memcpy(field + (destination - digits), destination, source - destination);
+        update_row(row, field, column_count - 7, column_count - 1);
+    }
+    refresh_display();
+}
+
+#else
+
 void count_visits(int row) {
     static uint8_t counters[8] = {0};
     int counter_position = column_count - 2;
-    for (int i = 0; i < counter_position; i++) {
-        if (!rows[row][i]) {
-            rows[row][i] = ' ';
-        }
-    }
-    sprintf(rows[row] + counter_position, "%02X", ++counters[row]);
+    char counter[2];
+    format_hex_byte(counter, ++counters[row]);
+    update_row(row, counter, counter_position, counter_position + 1);
     refresh_display();
 }
+
+#endif //LOOP_PROFILING
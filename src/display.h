@@ -30,6 +30,9 @@
 #ifndef COWPI_DISPLAY_H
 #define COWPI_DISPLAY_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -71,9 +74,119 @@ void display_string(int row, char const string[]);
 
 /**
  * Updates the display with any buffered strings.
+ *
+ * Only the characters that changed since the previous refresh are re-drawn,
+ * and only the SSD1306 pages and column ranges that cover them are sent to the
+ * display module.
+ *
+ * @see set_display_frame_rate()
  */
 void refresh_display(void);
 
+/**
+ * Updates the display with any buffered strings, regardless of the maximum
+ * frame rate. Intended for state changes that should be shown without delay.
+ */
+void refresh_display_immediately(void);
+
+/**
+ * Limits how often `refresh_display()` updates the display module. Changes
+ * requested less than one frame interval after the previous frame began are
+ * merged into the next frame. Strings placed with `display_string()` that end
+ * in a newline are shown immediately.
+ *
+ * @param frames_per_second The maximum frame rate, or 0 for no limit
+ */
+void set_display_frame_rate(unsigned int frames_per_second);
+
+/**
+ * Reports how many refresh requests were held back by the frame-rate limit and
+ * merged into a later frame.
+ *
+ * @return The number of merged frames
+ */
+uint32_t get_display_merged_frame_count(void);
+
+/**
+ * Reports how many times a row's contents were replaced before they had been
+ * shown on the display module.
+ *
+ * @return The number of dropped frames
+ */
+uint32_t get_display_dropped_frame_count(void);
+
+/**
+ * How `refresh_display()` sends the framebuffer to the display module.
+ * <ul>
+ * <li> `DISPLAY_FLUSH_BLOCKING`: `refresh_display()` returns after the changes
+ *      have been sent.
+ * <li> `DISPLAY_FLUSH_BACKGROUND`: `refresh_display()` latches the changes into
+ *      a second framebuffer and returns; each later call to
+ *      `refresh_display()` or `service_display()` sends one I2C transaction.
+ *      A refresh requested while a flush is in progress is deferred until that
+ *      flush completes, and any further requests are merged into it.
+ *      Background flushing needs a second 1 KB framebuffer and is not
+ *      available on AVR boards, where this mode behaves as
+ *      `DISPLAY_FLUSH_BLOCKING`.
+ * </ul>
+ */
+typedef enum {
+    DISPLAY_FLUSH_BLOCKING, DISPLAY_FLUSH_BACKGROUND
+} display_flush_mode_t;
+
+/**
+ * Selects whether display refreshes block until complete or drain in the
+ * background. Switching to `DISPLAY_FLUSH_BLOCKING` finishes any flush that is
+ * in progress.
+ *
+ * @param mode The flush mode to be used by subsequent refreshes
+ */
+void set_display_flush_mode(display_flush_mode_t mode);
+
+/**
+ * Advances a background flush by one I2C transaction. Does nothing if no flush
+ * is in progress.
+ */
+void service_display(void);
+
+/**
+ * Reports whether a background flush has not yet finished sending.
+ *
+ * @return `true` if a flush is in progress; `false` otherwise
+ */
+bool display_flush_is_in_progress(void);
+
+/**
+ * Registers a function to be called each time a background flush completes.
+ *
+ * @param callback The function to be called, or `NULL` for none
+ */
+void set_display_flush_callback(void (*callback)(void));
+
+/**
+ * Reports how many refresh requests were merged into an already-pending
+ * background flush instead of causing a flush of their own.
+ *
+ * @return The number of coalesced refresh requests
+ */
+uint32_t get_display_coalesced_refresh_count(void);
+
+/**
+ * Reports the number of bytes (including I2C address and control bytes) that
+ * the most recent display refresh sent to the display module.
+ *
+ * @return The number of bytes sent by the last call to `refresh_display()`
+ */
+uint32_t get_display_bytes_per_refresh(void);
+
+/**
+ * Reports the number of bytes (including I2C address and control bytes) that
+ * have been sent to the display module since it was initialized.
+ *
+ * @return The cumulative number of bytes sent to the display module
+ */
+uint32_t get_display_bytes_sent(void);
+
 /**
  * Prints the gcc, CowPi, and CowPi_stdio versions. Prints the core library
  * backing the Arduino framework, and the library used to drive the SSD1306
@@ -118,10 +231,33 @@ void print_build_timestamps(bool only_most_recent);
  * demonstration of liveness, or merely a demonstration that a code segment has
  * executed.
  *
+ * When built with `LOOP_PROFILING`, the rightmost seven columns instead show
+ * the number of main-loop iterations per second, as marked by
+ * `count_loop_pass()`. The display task calls this once per frame, so the
+ * counter also shows that frames are being drawn.
+ *
+ * @see count_loop_pass()
+ *
  * @param row The display row on which to show the counter
  */
 void count_visits(int row);
 
+/**
+ * @brief Marks a pass of the main loop for the loop profiler. Call this once
+ * per pass.
+ *
+ * @see loop-profiler.h
+ */
+void count_loop_pass(void);
+
+/**
+ * @brief Reads a character typed in the Serial Monitor, without waiting for
+ * one, so that C code can respond to single-key commands.
+ *
+ * @return The character, or -1 if none is waiting (always -1 off the Arduino)
+ */
+int get_serial_command(void);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,104 @@
+/**************************************************************************//**
+ *
+ * @file fixed-format.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Allocation-free formatting of the handful of fixed-width fields that
+ *      the display code uses, as a replacement for `sprintf()`.
+ *
+ * Each function writes its field at `destination` and returns a pointer to the
+ * character after the field, so that fields can be chained. None of them
+ * writes a terminating NUL; call `format_end()` when the string is complete.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_FIXED_FORMAT_H
+#define COMBOLOCK_FIXED_FORMAT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Writes `value % 100` as two decimal digits, zero-padded (like `"%02d"`).
+ */
+static inline char *format_decimal_2(char *destination, unsigned int value) {
+    value %= 100;
+    destination[0] = (char) ('0' + value / 10);
+    destination[1] = (char) ('0' + value % 10);
+    return destination + 2;
+}
+
+/**
+ * Writes `value` as two uppercase hexadecimal digits (like `"%02X"`).
+ */
+static inline char *format_hex_byte(char *destination, uint8_t value) {
+    static char const hex_digits[] = "0123456789ABCDEF";
+    destination[0] = hex_digits[value >> 4];
+    destination[1] = hex_digits[value & 0xF];
+    return destination + 2;
+}
+
+/**
+ * Writes `value` in decimal using as few digits as needed (like `"%u"`).
+ */
+static inline char *format_unsigned(char *destination, uint32_t value) {
+    char digits[10];
+    int number_of_digits = 0;
+    do {
+        digits[number_of_digits++] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (number_of_digits) {
+        *destination++ = digits[--number_of_digits];
+    }
+    return destination;
+}
+
+/**
+ * Copies `source`, without its terminating NUL.
+ */
+static inline char *format_string(char *destination, char const *source) {
+    while (*source) {
+        *destination++ = *source++;
+    }
+    return destination;
+}
+
+/**
+ * Copies at most `width` characters of `source` and pads with spaces to
+ * exactly `width` characters (like `"%-*.*s"`).
+ */
+static inline char *format_padded_string(char *destination, char const *source, int width) {
+    char *end = destination + width;
+    while (destination < end && *source) {
+        *destination++ = *source++;
+    }
+    while (destination < end) {
+        *destination++ = ' ';
+    }
+    return end;
+}
+
+/**
+ * Terminates the string that ends at `destination`.
+ */
+static inline char *format_end(char *destination) {
+    *destination = '\0';
+    return destination;
+}
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_FIXED_FORMAT_H
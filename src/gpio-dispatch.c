@@ -0,0 +1,183 @@
+/**************************************************************************//**
+ *
+ * @file gpio-dispatch.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief gpio-dispatch.h
+ *
+ * @copydetails gpio-dispatch.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stddef.h>
+#include "gpio-dispatch.h"
+#ifdef ISR_INSTRUMENTATION
+#include "microsecond-timer.h"
+#endif
+
+#define NUMBER_OF_PINS          (30)
+#define IO_BANK0_INTR0          (0x400140F0)
+#define PADS_BANK0_GPIO0        (0x4001C004)
+#define SIO_GPIO_IN             (0xD0000004)
+#define SYSTICK_BASE            (0xE000E010)
+
+#define EDGE_BITS               (0xCCCCCCCCu)   // edge low and edge high, for all eight pins of a word
+#define PAD_INPUT_ENABLE        (1 << 6)
+#define PAD_PULL_UP_ENABLE      (1 << 3)
+#define PAD_PULL_DOWN_ENABLE    (1 << 2)
+
+struct pin_handler {
+    void (*isr)(void);
+    void (*handler)(void *context);
+    void *context;
+};
+
+static struct rp2040_gpio_interrupts volatile *interrupts = (struct rp2040_gpio_interrupts *) (IO_BANK0_INTR0);
+static uint32_t volatile *pads = (uint32_t *) (PADS_BANK0_GPIO0);
+static uint32_t const volatile *gpio_input = (uint32_t *) (SIO_GPIO_IN);
+static struct cortex_m_systick volatile *systick = (struct cortex_m_systick *) (SYSTICK_BASE);
+
+static struct pin_handler pin_handlers[NUMBER_OF_PINS];
+static uint32_t owned_edges[4] = {0, 0, 0, 0};         // the edge bits of the pins registered here
+static void (*chained_handler)(void) = NULL;
+
+#ifdef ISR_INSTRUMENTATION
+uint32_t gpio_dispatch_entry_us = 0;
+#endif
+
+static uint32_t interrupt_count = 0;
+static uint32_t dispatch_count = 0;
+static uint32_t total_cycles = 0;
+static uint32_t maximum_cycles = 0;
+
+void gpio_dispatch_use_registers(struct rp2040_gpio_interrupts volatile *interrupt_registers,
+                                 uint32_t volatile *pad_registers,
+                                 uint32_t const volatile *gpio_input_register,
+                                 struct cortex_m_systick volatile *systick_registers) {
+    interrupts = interrupt_registers;
+    pads = pad_registers;
+    gpio_input = gpio_input_register;
+    systick = systick_registers;
+}
+
+/* Assigns the handler to each pin in the mask; a context array is indexed by pin number. */
+static void assign_handlers(uint32_t pin_mask, struct pin_handler handler, uint32_t context_size) {
+    bool enable = handler.isr || handler.handler;
+    pin_mask &= (1UL << NUMBER_OF_PINS) - 1;
+    while (pin_mask) {
+        unsigned int pin = __builtin_ctz(pin_mask);
+        pin_mask &= pin_mask - 1;
+        uint32_t edges = 0xCu << (4 * (pin % 8));
+        interrupts->enable[pin / 8] &= ~edges;      // disable interrupts while we're making changes
+        owned_edges[pin / 8] &= ~edges;
+        pin_handlers[pin] = handler;
+        if (handler.context) {
+            pin_handlers[pin].context = (uint8_t *) handler.context + pin * context_size;
+        }
+        if (enable) {
+            pads[pin] = (pads[pin] & ~PAD_PULL_DOWN_ENABLE) | PAD_INPUT_ENABLE | PAD_PULL_UP_ENABLE;
+            interrupts->raw[pin / 8] = edges;       // discard edges from before the ISR was registered
+            owned_edges[pin / 8] |= edges;
+            interrupts->enable[pin / 8] |= edges;
+        }
+    }
+}
+
+void gpio_dispatch_register(uint32_t pin_mask, void (*isr)(void)) {
+    assign_handlers(pin_mask, (struct pin_handler) {.isr = isr, .handler = NULL, .context = NULL}, 0);
+}
+
+void gpio_dispatch_register_with_context(uint32_t pin_mask, void (*handler)(void *context),
+                                         void *contexts, uint32_t context_size) {
+    assign_handlers(pin_mask, (struct pin_handler) {.isr = NULL, .handler = handler, .context = contexts},
+                    context_size);
+}
+
+void gpio_dispatch_chain(void (*handler)(void)) {
+    chained_handler = handler;
+}
+
+bool gpio_dispatch_read_pin(unsigned int pin) {
+    return (*gpio_input >> pin) & 0x1;
+}
+
+/* Gathers bit 0 of each nibble (after the edge bits have been shifted there) into one byte. */
+static inline uint32_t gather_nibbles(uint32_t x) {
+    x &= 0x11111111u;
+    x = (x | (x >> 3)) & 0x03030303u;
+    x = (x | (x >> 6)) & 0x000F000Fu;
+    x = (x | (x >> 12)) & 0x000000FFu;
+    return x;
+}
+
+static inline uint32_t cycles_between(uint32_t start, uint32_t end) {
+    // SysTick counts down and wraps to its reload value
+    return (start >= end) ? start - end : start + (systick->reload_value & 0x00FFFFFF) + 1 - end;
+}
+
+void gpio_dispatch_handle_interrupt(void) {
+    uint32_t start = systick->current_value;
+#ifdef ISR_INSTRUMENTATION
+    gpio_dispatch_entry_us = get_microseconds();
+#endif
+    uint32_t isr_cycles = 0;
+    uint32_t pending = 0;
+    uint32_t foreign = 0;
+    for (unsigned int i = 0; i < 4; i++) {
+        uint32_t all_status = interrupts->status[i];
+        uint32_t status = all_status & owned_edges[i];
+        foreign |= all_status & ~owned_edges[i];
+        if (status) {
+            interrupts->raw[i] = status;            // acknowledge before dispatching, so no edge is lost
+            pending |= gather_nibbles((status >> 2) | (status >> 3)) << (8 * i);
+        }
+    }
+    while (pending) {
+        unsigned int pin = __builtin_ctz(pending);
+        pending &= pending - 1;
+        struct pin_handler const *entry = pin_handlers + pin;
+        uint32_t isr_start = systick->current_value;
+        if (entry->handler) {
+            entry->handler(entry->context);
+        } else if (entry->isr) {
+            entry->isr();
+        }
+        isr_cycles += cycles_between(isr_start, systick->current_value);
+        dispatch_count++;
+    }
+    if (foreign && chained_handler) {
+        // another driver's pins are pending; it acknowledges them itself
+        uint32_t chain_start = systick->current_value;
+        chained_handler();
+        isr_cycles += cycles_between(chain_start, systick->current_value);
+    }
+    uint32_t cycles = cycles_between(start, systick->current_value) - isr_cycles;
+    interrupt_count++;
+    total_cycles += cycles;
+    if (cycles > maximum_cycles) {
+        maximum_cycles = cycles;
+    }
+}
+
+struct gpio_dispatch_statistics gpio_dispatch_get_statistics(void) {
+    return (struct gpio_dispatch_statistics) {
+            .interrupts = interrupt_count,
+            .dispatches = dispatch_count,
+            .mean_cycles_per_dispatch = dispatch_count ? total_cycles / dispatch_count : 0,
+            .maximum_cycles = maximum_cycles,
+    };
+}
+
+void gpio_dispatch_reset_statistics(void) {
+    interrupt_count = 0;
+    dispatch_count = 0;
+    total_cycles = 0;
+    maximum_cycles = 0;
+}
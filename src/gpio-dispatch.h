@@ -0,0 +1,159 @@
+/**************************************************************************//**
+ *
+ * @file gpio-dispatch.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Heap-free dispatch of RP2040 GPIO edge interrupts to per-pin ISRs.
+ *
+ * All of the pins share one bank-level interrupt. Its handler reads the
+ * processor's four interrupt status registers, folds their edge bits into a
+ * 32-bit mask of pins with pending edges, acknowledges those edges, and then
+ * calls each pin's ISR from a statically-allocated table, finding the pins
+ * with count-trailing-zeros. Nothing is allocated, and there are no per-pin
+ * objects.
+ *
+ * The dispatcher only acknowledges the pins registered with it. If any other
+ * pin of the bank is pending, such as one serviced by mbed::InterruptIn, the
+ * handler that was installed before the dispatcher is called afterward, so
+ * the two can share the bank interrupt.
+ *
+ * The handler measures its own cost, excluding the time spent in the ISRs, in
+ * SysTick cycles.
+ *
+ * The register blocks are reached through pointers that default to the
+ * RP2040's addresses, so a host program can redirect them to ordinary structs,
+ * set the status bits that a simulated interrupt controller would set, and
+ * call `gpio_dispatch_handle_interrupt()` directly.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_GPIO_DISPATCH_H
+#define COMBOLOCK_GPIO_DISPATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GPIO_DISPATCH_IRQ_NUMBER (13)   // IO_IRQ_BANK0
+
+/* IO_BANK0's interrupt registers for processor 0, starting at INTR0. Each word
+ * covers eight pins with four bits per pin: level low, level high, edge low,
+ * and edge high. */
+struct rp2040_gpio_interrupts {
+    uint32_t raw[4];                    // INTR0-3: edge bits are write-1-to-clear
+    uint32_t enable[4];                 // PROC0_INTE0-3
+    uint32_t force[4];                  // PROC0_INTF0-3
+    uint32_t status[4];                 // PROC0_INTS0-3
+};
+
+/* The Cortex-M0+ SysTick registers. */
+struct cortex_m_systick {
+    uint32_t control_and_status;
+    uint32_t reload_value;
+    uint32_t current_value;             // counts down from the reload value
+    uint32_t calibration;
+};
+
+/* The cost of dispatching, excluding the ISRs themselves. */
+struct gpio_dispatch_statistics {
+    uint32_t interrupts;                // bank interrupts handled
+    uint32_t dispatches;                // ISRs called
+    uint32_t mean_cycles_per_dispatch;
+    uint32_t maximum_cycles;            // the most costly single bank interrupt
+};
+
+#ifdef ISR_INSTRUMENTATION
+/* When the bank interrupt being handled began, in microseconds. */
+extern uint32_t gpio_dispatch_entry_us;
+#endif
+
+/**
+ * @brief Redirects the module's register accesses, such as to structs in
+ * ordinary memory on a host computer.
+ *
+ * @param interrupts IO_BANK0's interrupt registers
+ * @param pads PADS_BANK0's 30 per-pin pad control registers
+ * @param gpio_input SIO's GPIO_IN register
+ * @param systick The SysTick registers
+ */
+void gpio_dispatch_use_registers(struct rp2040_gpio_interrupts volatile *interrupts,
+                                 uint32_t volatile *pads,
+                                 uint32_t const volatile *gpio_input,
+                                 struct cortex_m_systick volatile *systick);
+
+/**
+ * @brief Enables pull-ups and edge interrupts on the specified pins and
+ * assigns them an ISR, or disables their interrupts if the ISR is `NULL`.
+ *
+ * The caller is responsible for installing `gpio_dispatch_handle_interrupt()`
+ * as the handler for `GPIO_DISPATCH_IRQ_NUMBER`, and for chaining the handler
+ * that it replaces with `gpio_dispatch_chain()`.
+ *
+ * @param pin_mask A bit vector of the pins to be serviced by the ISR
+ * @param isr The function that will service edges on those pins
+ */
+void gpio_dispatch_register(uint32_t pin_mask, void (*isr)(void));
+
+/**
+ * @brief As `gpio_dispatch_register()`, but the handler is passed a pointer
+ * to the caller's data for the pin.
+ *
+ * @param pin_mask A bit vector of the pins to be serviced by the handler
+ * @param handler The function that will service edges on those pins
+ * @param contexts An array indexed by pin number; the handler is passed
+ *      `&contexts[pin]`
+ * @param context_size The size of each element of `contexts`
+ */
+void gpio_dispatch_register_with_context(uint32_t pin_mask, void (*handler)(void *context),
+                                         void *contexts, uint32_t context_size);
+
+/**
+ * @brief Designates the handler that services the bank's other pins, normally
+ * the handler that `gpio_dispatch_handle_interrupt()` replaced. It is called
+ * after the registered pins' ISRs whenever a pin that is not registered here
+ * has a pending interrupt.
+ *
+ * @param handler The previous bank-level handler, or `NULL` for none
+ */
+void gpio_dispatch_chain(void (*handler)(void));
+
+/**
+ * @brief Reads a pin's current level.
+ *
+ * @param pin The pin to be read
+ * @return `true` if the pin is high; `false` if it is low
+ */
+bool gpio_dispatch_read_pin(unsigned int pin);
+
+/**
+ * @brief The bank-level interrupt handler.
+ */
+void gpio_dispatch_handle_interrupt(void);
+
+/**
+ * @brief Reports what dispatching has cost since the last reset.
+ *
+ * @return The dispatch statistics
+ */
+struct gpio_dispatch_statistics gpio_dispatch_get_statistics(void);
+
+/**
+ * @brief Zeroes the dispatch statistics.
+ */
+void gpio_dispatch_reset_statistics(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_GPIO_DISPATCH_H
@@ -94,9 +94,6 @@ float configure_timer(unsigned int timer_number, float desired_period_us) {
         return INFINITY;
     }
     struct timer_data *timer = timers + timer_number;
-    timer->interrupt_service_routines[0] = do_nothing;
-    timer->interrupt_service_routines[1] = do_nothing;
-    timer->interrupt_service_routines[2] = do_nothing;
     float const system_clock = 16.0;    // cycles per microsecond
     float best_error = INFINITY;
     float best_period = INFINITY;
@@ -130,7 +127,20 @@ float configure_timer(unsigned int timer_number, float desired_period_us) {
             }
         }
     }
-    // Configure the timer
+    load_timer_configuration(timer_number, best_index, best_count + 1);
+    return best_period;
+}
+
+void load_timer_configuration(unsigned int timer_number, unsigned int prescaler_index, uint32_t count) {
+    if (timer_number < 1 || timer_number > 2) {
+        return;
+    }
+    struct timer_data *timer = timers + timer_number;
+    timer->interrupt_service_routines[0] = do_nothing;
+    timer->interrupt_service_routines[1] = do_nothing;
+    timer->interrupt_service_routines[2] = do_nothing;
+    uint32_t best_count = count - 1;
+    int best_index = (int) prescaler_index;
     uint8_t *mode_bits;
     uint32_t compare_A;
     if (timer->number_of_counter_values - best_count == 1) {    // the comparison value is the maximum possible comparison value
@@ -163,11 +173,10 @@ float configure_timer(unsigned int timer_number, float desired_period_us) {
             break;
         default:
             // unreachable
-            return INFINITY;
+            return;
     }
     // printf("TCCR2 = %#04x,%02x\n", TCCR2B, TCCR2A);
     // printf("OCR2A = %#04x\n", OCR2A);
-    return best_period;
 }
 
 bool register_timer_ISR(unsigned int timer_number, unsigned int isr_slot, void (*isr)(void)) {
@@ -224,11 +233,65 @@ void reset_timer(unsigned int timer_number) {
 #ifdef __MBED__
 #include <InterruptIn.h>
 #include <Ticker.h>
+#include <Timeout.h>
+#if defined (ARDUINO_ARCH_RP2040)
+#include <cmsis.h>
+#include "gpio-dispatch.h"
+#endif
+#include "isr-instrumentation.h"
+#include "microsecond-timer.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if defined (ARDUINO_ARCH_RP2040)
+
+/* One bank-level interrupt handler dispatches to all pins' ISRs, without mbed::InterruptIn. Any handler already
+ * installed, such as the one behind other libraries' mbed::InterruptIn objects, is chained rather than replaced. */
+static void install_gpio_dispatch(void) {
+    static bool is_installed = false;
+    if (!is_installed) {
+        uint32_t previous_handler = NVIC_GetVector((IRQn_Type) GPIO_DISPATCH_IRQ_NUMBER);
+        if (previous_handler != (uint32_t) (uintptr_t) gpio_dispatch_handle_interrupt) {
+            gpio_dispatch_chain((void (*)(void)) (uintptr_t) previous_handler);
+        }
+        NVIC_SetVector((IRQn_Type) GPIO_DISPATCH_IRQ_NUMBER, (uint32_t) (uintptr_t) gpio_dispatch_handle_interrupt);
+        NVIC_EnableIRQ((IRQn_Type) GPIO_DISPATCH_IRQ_NUMBER);
+        is_installed = true;
+    }
+}
+
+#ifdef ISR_INSTRUMENTATION
+static struct isr_probe pin_probes[32];
+
+static void run_pin_probe(void *probe) {
+    isr_probe_run((struct isr_probe *) probe, gpio_dispatch_entry_us);
+}
+#endif //ISR_INSTRUMENTATION
+
+void register_pin_ISR(uint32_t interrupt_mask, void (*isr)(void)) {
+    install_gpio_dispatch();
+#ifdef ISR_INSTRUMENTATION
+    gpio_dispatch_register(interrupt_mask, nullptr);    // disable interrupts while we're making changes
+    if (isr != nullptr) {
+        for (uint32_t pins = interrupt_mask; pins; pins &= pins - 1) {
+            uint8_t pin = (uint8_t) __builtin_ctz(pins);
+            isr_probe_initialize(pin_probes + pin, isr, 'p', pin, 0);
+        }
+        gpio_dispatch_register_with_context(interrupt_mask, run_pin_probe, pin_probes, sizeof(struct isr_probe));
+    }
+#else
+    gpio_dispatch_register(interrupt_mask, isr);
+#endif //ISR_INSTRUMENTATION
+}
+
+static bool read_pin(uint8_t pin) {
+    return gpio_dispatch_read_pin(pin);
+}
+
+#else
+
 static mbed::InterruptIn *inputs[32] = {
         nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
         nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
@@ -236,6 +299,14 @@ static mbed::InterruptIn *inputs[32] = {
         nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
 };
 
+#ifdef ISR_INSTRUMENTATION
+static struct isr_probe pin_probes[32];
+
+static void run_pin_probe(struct isr_probe *probe) {
+    isr_probe_run(probe, get_microseconds());   // there is no earlier timestamp for the edge
+}
+#endif //ISR_INSTRUMENTATION
+
 void register_pin_ISR(uint32_t interrupt_mask, void (*isr)(void)) {
     int8_t i = 0;
     do {
@@ -244,13 +315,93 @@ void register_pin_ISR(uint32_t interrupt_mask, void (*isr)(void)) {
                 inputs[i] = new mbed::InterruptIn((PinName)i, PullUp);
             }
             inputs[i]->disable_irq();   // disable interrupts while we're making changes
+#ifdef ISR_INSTRUMENTATION
+            if (isr != nullptr) {
+                isr_probe_initialize(pin_probes + i, isr, 'p', (uint8_t) i, 0);
+                inputs[i]->rise(mbed::callback(run_pin_probe, pin_probes + i));
+                inputs[i]->fall(mbed::callback(run_pin_probe, pin_probes + i));
+            } else {
+                inputs[i]->rise(isr);
+                inputs[i]->fall(isr);
+            }
+#else
             inputs[i]->rise(isr);
             inputs[i]->fall(isr);
-            inputs[i]->enable_irq();   // re-enable interrupts
+#endif //ISR_INSTRUMENTATION
+            if (isr != nullptr) {
+                inputs[i]->enable_irq();   // re-enable interrupts
+            }
         }
     } while (++i < 32);
 }
 
+static bool read_pin(uint8_t pin) {
+    return inputs[pin]->read();
+}
+
+#endif //ARDUINO_ARCH_RP2040
+
+static struct pin_filter pin_filters[32];
+static mbed::Timeout settle_timeouts[32];
+
+static void start_settling_timer(struct pin_filter *filter, uint32_t delay_us) {
+    settle_timeouts[filter->pin].attach(mbed::callback(pin_filter_handle_settling_timeout, filter),
+                                        std::chrono::microseconds(delay_us));
+}
+
+static struct pin_filter_clock const pin_filter_clock = {
+        .now_us = get_microseconds,
+        .read_pin = read_pin,
+        .start_settling_timer = start_settling_timer,
+};
+
+#if defined (ARDUINO_ARCH_RP2040)
+static void filter_dispatched_edge(void *filter) {
+    pin_filter_handle_edge((struct pin_filter *) filter);
+}
+#endif
+
+void register_filtered_pin_ISR(uint32_t interrupt_mask, void (*isr)(void), pin_filter_mode_t mode, uint32_t interval_us) {
+#if defined (ARDUINO_ARCH_RP2040)
+    install_gpio_dispatch();
+    gpio_dispatch_register(interrupt_mask, nullptr);    // disable interrupts while we're making changes
+#endif
+    int8_t i = 0;
+    do {
+        if (interrupt_mask & (1L << i)) {
+#if !defined (ARDUINO_ARCH_RP2040)
+            if (inputs[i] == nullptr) {
+                inputs[i] = new mbed::InterruptIn((PinName)i, PullUp);
+            }
+            inputs[i]->disable_irq();   // disable interrupts while we're making changes
+#endif
+            settle_timeouts[i].detach();
+            if (isr != nullptr) {
+                pin_filter_initialize(pin_filters + i, (uint8_t) i, isr, mode, interval_us, &pin_filter_clock);
+            }
+#if !defined (ARDUINO_ARCH_RP2040)
+            if (isr != nullptr) {
+                inputs[i]->rise(mbed::callback(pin_filter_handle_edge, pin_filters + i));
+                inputs[i]->fall(mbed::callback(pin_filter_handle_edge, pin_filters + i));
+                inputs[i]->enable_irq();   // re-enable interrupts
+            } else {
+                inputs[i]->rise(nullptr);
+                inputs[i]->fall(nullptr);
+            }
+#endif
+        }
+    } while (++i < 32);
+#if defined (ARDUINO_ARCH_RP2040)
+    if (isr != nullptr) {
+        gpio_dispatch_register_with_context(interrupt_mask, filter_dispatched_edge, pin_filters, sizeof(struct pin_filter));
+    }
+#endif
+}
+
+uint32_t get_rejected_edge_count(unsigned int pin) {
+    return (pin < 32) ? pin_filter_get_rejected_edge_count(pin_filters + pin) : 0;
+}
+
 //static mbed::Ticker *tickers[MAXIMUM_NUMBER_OF_TICKERS] = {
 //        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
 //};
@@ -285,6 +436,25 @@ static struct timer_data timers[MAXIMUM_NUMBER_OF_TIMERS] = {
         {.ticker = nullptr, .period = no_time, .interrupt_service_routine = nullptr,}
 };
 
+#ifdef ISR_INSTRUMENTATION
+static struct isr_probe timer_probes[MAXIMUM_NUMBER_OF_TIMERS];
+
+static void run_timer_probe(struct isr_probe *probe) {
+    isr_probe_run(probe, 0);
+}
+
+static void attach_timer(unsigned int timer_number) {
+    isr_probe_initialize(timer_probes + timer_number, timers[timer_number].interrupt_service_routine, 't',
+                         (uint8_t) timer_number, (uint32_t) timers[timer_number].period.count());
+    timers[timer_number].ticker->attach(mbed::callback(run_timer_probe, timer_probes + timer_number),
+                                        timers[timer_number].period);
+}
+#else
+static void attach_timer(unsigned int timer_number) {
+    timers[timer_number].ticker->attach(timers[timer_number].interrupt_service_routine, timers[timer_number].period);
+}
+#endif //ISR_INSTRUMENTATION
+
 bool register_periodic_timer_ISR(unsigned int timer_number, uint32_t period_us, void (*isr)(void)) {
     if (timer_number >= MAXIMUM_NUMBER_OF_TIMERS) {
         return false;
@@ -294,7 +464,7 @@ bool register_periodic_timer_ISR(unsigned int timer_number, uint32_t period_us,
     }
     timers[timer_number].period = std::chrono::microseconds(period_us);
     timers[timer_number].interrupt_service_routine = isr;
-    timers[timer_number].ticker->attach(timers[timer_number].interrupt_service_routine, timers[timer_number].period);
+    attach_timer(timer_number);
     return true;
 }
 
@@ -306,7 +476,40 @@ void reset_periodic_timer(unsigned int timer_number) {
         return;
     }
     timers[timer_number].ticker->detach();
-    timers[timer_number].ticker->attach(timers[timer_number].interrupt_service_routine, timers[timer_number].period);
+    attach_timer(timer_number);
+}
+
+void stop_periodic_timer(unsigned int timer_number) {
+    if (timer_number >= MAXIMUM_NUMBER_OF_TIMERS) {
+        return;
+    }
+    if (timers[timer_number].ticker == nullptr) {
+        return;
+    }
+    timers[timer_number].ticker->detach();
+}
+
+static mbed::Timeout *alarms[MAXIMUM_NUMBER_OF_ALARMS] = {nullptr, nullptr, nullptr, nullptr};
+
+bool register_alarm_ISR(unsigned int alarm_number, uint32_t delay_us, void (*isr)(void)) {
+    if (alarm_number >= MAXIMUM_NUMBER_OF_ALARMS) {
+        return false;
+    }
+    if (alarms[alarm_number] == nullptr) {
+        alarms[alarm_number] = new mbed::Timeout();
+    }
+    alarms[alarm_number]->attach(isr, std::chrono::microseconds(delay_us));
+    return true;
+}
+
+void cancel_alarm(unsigned int alarm_number) {
+    if (alarm_number >= MAXIMUM_NUMBER_OF_ALARMS) {
+        return;
+    }
+    if (alarms[alarm_number] == nullptr) {
+        return;
+    }
+    alarms[alarm_number]->detach();
 }
 
 #ifdef __cplusplus
@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include "pin-filter.h"
 
 /**
 * @brief Registers a function to service pin-based interrupts triggered by
@@ -30,6 +31,9 @@ extern "C" {
 * function. A bit with a 0 signifies nothing more than that the function is
 * not being registered to service changes on that pin at this time.
 *
+* On MBED systems, registering `NULL` disables interrupts on the specified
+* pins.
+*
 * @param interrupt_mask A bit vector specifying which pins will be serviced by
 *      the registered ISR
 * @param isr The function that will service interrupts triggered by changes on
@@ -106,6 +110,20 @@ float configure_timer(unsigned int timer_number, float desired_period_us);
  */
 bool register_timer_ISR(unsigned int timer_number, unsigned int isr_slot, void (*isr)(void));
 
+/**
+ * @brief Loads a timer configuration that has already been chosen, as
+ * `configure_timer()` does after its search.
+ *
+ * This is the run-time half of `configure_timer<timer_number, period_us>()`;
+ * it can also be called directly.
+ *
+ * @param timer_number The timer to be configured
+ * @param prescaler_index The position of the prescaler in the timer's list of
+ *      prescalers
+ * @param count The number of prescaled clock ticks per interrupt period
+ */
+void load_timer_configuration(unsigned int timer_number, unsigned int prescaler_index, uint32_t count);
+
 #endif //__AVR__
 
 #ifdef __MBED__
@@ -131,10 +149,169 @@ bool register_timer_ISR(unsigned int timer_number, unsigned int isr_slot, void (
  */
 bool register_periodic_timer_ISR(unsigned int timer_number, uint32_t period_us, void (*isr)(void));
 
+/**
+ * @brief Registers a function to service pin-based interrupts, with edges
+ * filtered before they reach the function.
+ *
+ * This behaves as `register_pin_ISR()` does, except that each specified pin
+ * is debounced according to `mode`:
+ * <ul>
+ * <li> `PIN_FILTER_MINIMUM_INTERVAL`: an edge is passed on only if at least
+ *      `interval_us` microseconds have passed since the last edge that was
+ *      passed on. The ISR runs immediately on the first edge of a bounce.
+ * <li> `PIN_FILTER_SETTLE_THEN_CONFIRM`: each edge (re)starts an
+ *      `interval_us` settling time; when the pin has had no edges for that
+ *      long, the ISR runs once if the pin's level differs from the last level
+ *      passed on.
+ * </ul>
+ * Rejected edges never reach the ISR; they are counted per pin. A
+ * <code>NULL</code> ISR disables the pins' interrupts, as it does for
+ * `register_pin_ISR()`, and abandons any settling time in progress.
+ *
+ * @param interrupt_mask A bit vector specifying which pins will be serviced by
+ *      the registered ISR
+ * @param isr The function that will service interrupts triggered by changes on
+ *      the specified pins
+ * @param mode How edges are filtered
+ * @param interval_us The minimum edge interval or settling time
+ */
+void register_filtered_pin_ISR(uint32_t interrupt_mask, void (*isr)(void), pin_filter_mode_t mode, uint32_t interval_us);
+
+/**
+ * @brief Reports how many edges the filter has kept from reaching a pin's ISR.
+ *
+ * @param pin The pin whose count is wanted
+ * @return The number of rejected edges since the pin's ISR was registered
+ */
+uint32_t get_rejected_edge_count(unsigned int pin);
+
+/**
+ * @brief Stops a timer's periodic interrupts. The timer's ISR remains
+ * registered, and `reset_periodic_timer()` restarts the interrupts.
+ *
+ * @param timer_number The timer whose interrupts are to be stopped
+ */
+void stop_periodic_timer(unsigned int timer_number);
+
+#define MAXIMUM_NUMBER_OF_ALARMS (4)
+
+/**
+ * @brief Arranges for a function to be called once, after a delay.
+ *
+ * This function supports up to `MAXIMUM_NUMBER_OF_ALARMS` alarms. Registering
+ * an alarm that is already pending replaces its delay and its ISR. The ISR may
+ * register its own alarm again to schedule the next event.
+ *
+ * @param alarm_number A unique handle for the one-shot alarm being set
+ * @param delay_us The time from now until the ISR is to be invoked
+ * @param isr The function that will service the alarm
+ * @return <code>true</code> if the alarm was successfully set;
+ *      <code>false</code> otherwise
+ */
+bool register_alarm_ISR(unsigned int alarm_number, uint32_t delay_us, void (*isr)(void));
+
+/**
+ * @brief Cancels a pending alarm. Does nothing if the alarm is not pending.
+ *
+ * @param alarm_number The alarm to be cancelled
+ */
+void cancel_alarm(unsigned int alarm_number);
+
 #endif //__MBED__
 
 #ifdef __cplusplus
 } // extern "C"
 #endif
 
+#if defined (__AVR__) && defined (__cplusplus)
+
+/* Compile-time counterpart of configure_timer()'s search; C++11 constexpr
+ * functions must be single expressions, hence the recursion. */
+namespace avr_timer_search {
+
+static constexpr uint32_t CYCLES_PER_MICROSECOND = 16;
+static constexpr uint16_t timer1_prescalers[] = {1, 8, 64, 256, 1024};
+static constexpr uint16_t timer2_prescalers[] = {1, 8, 32, 64, 128, 256, 1024};
+
+struct candidate {
+    bool is_valid;
+    unsigned int prescaler_index;
+    uint32_t count;
+    uint32_t error_cycles;
+};
+
+constexpr unsigned int number_of_prescalers(unsigned int timer_number) {
+    return timer_number == 2 ? 7 : 5;
+}
+
+constexpr uint32_t prescaler(unsigned int timer_number, unsigned int index) {
+    return timer_number == 2 ? timer2_prescalers[index] : timer1_prescalers[index];
+}
+
+constexpr uint32_t number_of_counter_values(unsigned int timer_number) {
+    return timer_number == 1 ? (1UL << 16) : (1UL << 8);
+}
+
+constexpr uint32_t difference(uint32_t a, uint32_t b) {
+    return a > b ? a - b : b - a;
+}
+
+constexpr candidate make_candidate(unsigned int timer_number, unsigned int index, uint32_t count, uint32_t cycles) {
+    return candidate{count >= 1 && count <= number_of_counter_values(timer_number), index, count,
+                     difference(count * prescaler(timer_number, index), cycles)};
+}
+
+/* like configure_timer(), a challenger must be strictly better to replace the incumbent */
+constexpr candidate better(candidate incumbent, candidate challenger) {
+    return (challenger.is_valid && (!incumbent.is_valid || challenger.error_cycles < incumbent.error_cycles))
+           ? challenger : incumbent;
+}
+
+constexpr candidate search(unsigned int timer_number, uint32_t cycles, unsigned int index, candidate best) {
+    return index >= number_of_prescalers(timer_number) ? best
+           : search(timer_number, cycles, index + 1,
+                    better(better(best, make_candidate(timer_number, index,
+                                                       (cycles + prescaler(timer_number, index) - 1) /
+                                                       prescaler(timer_number, index), cycles)),
+                           make_candidate(timer_number, index, cycles / prescaler(timer_number, index), cycles)));
+}
+
+constexpr candidate best_configuration(unsigned int timer_number, uint32_t period_us) {
+    return search(timer_number, period_us * CYCLES_PER_MICROSECOND, 0, candidate{false, 0, 0, 0});
+}
+
+} // namespace avr_timer_search
+
+/**
+ * @brief Configures an AVR timer with a period chosen at compile time.
+ *
+ * This is `configure_timer()` with the search done by the compiler, so the
+ * call reduces to the register writes in `load_timer_configuration()`, with
+ * no floating-point arithmetic. Compilation fails if the timer number is not
+ * 1 or 2, if no prescaler can produce the period, or if the closest period
+ * differs from the requested period by more than `tolerance_ppm` parts per
+ * million.
+ *
+ * @tparam timer_number The timer to be configured
+ * @tparam period_us The desired interrupt period
+ * @tparam tolerance_ppm The largest acceptable error
+ * @return The actual interrupt period
+ */
+template<unsigned int timer_number, uint32_t period_us, uint32_t tolerance_ppm = 1000>
+inline float configure_timer() {
+    static_assert(timer_number == 1 || timer_number == 2, "only TIMER1 and TIMER2 may be configured");
+    static_assert(period_us >= 1 && period_us <= UINT32_MAX / avr_timer_search::CYCLES_PER_MICROSECOND,
+                  "the period must be between 1 us and 268 s");
+    constexpr avr_timer_search::candidate configuration = avr_timer_search::best_configuration(timer_number, period_us);
+    static_assert(configuration.is_valid, "no prescaler can produce this period on this timer");
+    static_assert((uint64_t) configuration.error_cycles * 1000000
+                  <= (uint64_t) tolerance_ppm * period_us * avr_timer_search::CYCLES_PER_MICROSECOND,
+                  "the closest achievable period is outside the tolerance");
+    load_timer_configuration(timer_number, configuration.prescaler_index, configuration.count);
+    return (float) (configuration.count * avr_timer_search::prescaler(timer_number, configuration.prescaler_index))
+           / avr_timer_search::CYCLES_PER_MICROSECOND;
+}
+
+#endif //__AVR__ && __cplusplus
+
 #endif //INTERRUPT_SUPPORT_H
@@ -0,0 +1,129 @@
+/**************************************************************************//**
+ *
+ * @file isr-instrumentation.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief isr-instrumentation.h
+ *
+ * @copydetails isr-instrumentation.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "isr-instrumentation.h"
+
+#ifdef ISR_INSTRUMENTATION
+
+#include "gpio-dispatch.h"
+#include "microsecond-timer.h"
+
+#define MAXIMUM_NUMBER_OF_PROBES (40)
+#if defined (__arm__)
+#define SYSTICK_BASE ((struct cortex_m_systick *) (0xE000E010))
+#else
+#define SYSTICK_BASE (NULL)         // no SysTick to read; cycles are reported as 0
+#endif //__arm__
+
+static struct isr_probe *probes[MAXIMUM_NUMBER_OF_PROBES];
+static unsigned int number_of_probes = 0;
+static uint32_t (*now_us)(void) = get_microseconds;
+static struct cortex_m_systick volatile *systick = SYSTICK_BASE;
+
+void isr_instrumentation_use_clock(uint32_t (*clock_us)(void), struct cortex_m_systick volatile *systick_registers) {
+    now_us = clock_us;
+    systick = systick_registers;
+}
+
+static inline uint32_t read_cycles(void) {
+    return systick ? systick->current_value : 0;
+}
+
+static inline unsigned int log2_bucket(uint32_t value) {
+    unsigned int bucket = value ? 31 - __builtin_clz(value) : 0;
+    return bucket < ISR_HISTOGRAM_BUCKETS ? bucket : ISR_HISTOGRAM_BUCKETS - 1;
+}
+
+void isr_probe_initialize(struct isr_probe *probe, void (*isr)(void), char source, uint8_t number, uint32_t period_us) {
+    memset(probe, 0, sizeof(struct isr_probe));
+    probe->isr = isr;
+    probe->source = source;
+    probe->number = number;
+    probe->period_us = period_us;
+    probe->expected_us = now_us() + period_us;
+    for (unsigned int i = 0; i < number_of_probes; i++) {
+        if (probes[i] == probe) {
+            return;
+        }
+    }
+    if (number_of_probes < MAXIMUM_NUMBER_OF_PROBES) {
+        probes[number_of_probes++] = probe;
+    }
+}
+
+void isr_probe_run(struct isr_probe *probe, uint32_t triggered_us) {
+    uint32_t start_us = now_us();
+    uint32_t start_cycles = read_cycles();
+    probe->isr();
+    uint32_t end_cycles = read_cycles();
+    // SysTick counts down and wraps to its reload value
+    uint32_t cycles = (start_cycles >= end_cycles)
+                      ? start_cycles - end_cycles
+                      : start_cycles + (systick->reload_value & 0x00FFFFFF) + 1 - end_cycles;
+    uint32_t latency_us;
+    if (probe->period_us) {
+        latency_us = start_us - probe->expected_us;
+        if (latency_us > probe->period_us) {
+            // early, or an entire period late: start the schedule over rather than report garbage
+            latency_us = 0;
+            probe->expected_us = start_us;
+        }
+        probe->expected_us += probe->period_us;
+    } else {
+        latency_us = start_us - triggered_us;
+    }
+    probe->calls++;
+    probe->total_cycles += cycles;
+    if (cycles > probe->maximum_cycles) {
+        probe->maximum_cycles = cycles;
+    }
+    if (latency_us > probe->maximum_latency_us) {
+        probe->maximum_latency_us = latency_us;
+    }
+    probe->cycle_histogram[log2_bucket(cycles)]++;
+    probe->latency_histogram[log2_bucket(latency_us)]++;
+}
+
+static void print_histogram(char const *name, uint32_t const histogram[]) {
+    printf("    %s:", name);
+    for (unsigned int bucket = 0; bucket < ISR_HISTOGRAM_BUCKETS; bucket++) {
+        if (histogram[bucket]) {
+            printf(" %lu:%lu", 1UL << bucket, (unsigned long) histogram[bucket]);
+        }
+    }
+    printf("\n");
+}
+
+void print_isr_report(void) {
+    for (unsigned int i = 0; i < number_of_probes; i++) {
+        struct isr_probe const *probe = probes[i];
+        if (!probe->isr) {
+            continue;
+        }
+        printf("%s %2u: %lu calls, cycles mean %lu max %lu, latency max %lu us\n",
+               probe->source == 't' ? "timer" : "pin  ", probe->number, (unsigned long) probe->calls,
+               (unsigned long) (probe->calls ? probe->total_cycles / probe->calls : 0),
+               (unsigned long) probe->maximum_cycles, (unsigned long) probe->maximum_latency_us);
+        print_histogram("cycles    ", probe->cycle_histogram);
+        print_histogram("latency us", probe->latency_histogram);
+    }
+}
+
+#endif //ISR_INSTRUMENTATION
@@ -0,0 +1,116 @@
+/**************************************************************************//**
+ *
+ * @file isr-instrumentation.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Measures how late interrupt service routines start and how long they
+ *      run.
+ *
+ * When built with `ISR_INSTRUMENTATION` defined (for example, with
+ * `build_flags = -DISR_INSTRUMENTATION` in platformio.ini),
+ * `register_pin_ISR()` and `register_periodic_timer_ISR()` wrap each ISR in a
+ * probe. The probe records the ISR's entry latency in microseconds, its
+ * execution time in SysTick cycles, the worst case of each, and log2
+ * histograms of both. `print_isr_report()` prints every probe's statistics.
+ *
+ * A periodic timer's latency is measured against when its interrupt was
+ * scheduled. A pin's latency is measured from the start of the GPIO bank
+ * interrupt on the RP2040 (it cannot include the hardware's own interrupt
+ * entry), and is not measured on other MBED targets.
+ *
+ * Execution time is read from the Cortex-M SysTick; on other architectures
+ * it is reported as 0 cycles unless `isr_instrumentation_use_clock()`
+ * supplies a SysTick, as a host test does along with a simulated clock.
+ *
+ * Without `ISR_INSTRUMENTATION`, ISRs are registered unwrapped and
+ * `print_isr_report()` does nothing.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_ISR_INSTRUMENTATION_H
+#define COMBOLOCK_ISR_INSTRUMENTATION_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef ISR_INSTRUMENTATION
+
+#define ISR_HISTOGRAM_BUCKETS (16)
+
+/* One wrapped ISR and its statistics. Bucket *k* of a histogram counts values
+ * of at least 2<sup>*k*</sup> and less than 2<sup>*k*+1</sup> (bucket 0 also
+ * counts 0); the last bucket also counts all larger values. */
+struct isr_probe {
+    void (*isr)(void);
+    char source;                        // 'p' for a pin, 't' for a timer
+    uint8_t number;                     // the pin or timer number
+    uint32_t period_us;                 // 0 if the ISR is not periodic
+    uint32_t expected_us;               // when a periodic ISR is next due
+    uint32_t calls;
+    uint32_t maximum_latency_us;
+    uint32_t maximum_cycles;
+    uint64_t total_cycles;
+    uint32_t latency_histogram[ISR_HISTOGRAM_BUCKETS];
+    uint32_t cycle_histogram[ISR_HISTOGRAM_BUCKETS];
+};
+
+struct cortex_m_systick;
+
+/**
+ * Redirects the probes' time and cycle measurements, such as to a simulated
+ * clock and a SysTick in ordinary memory on a host computer.
+ *
+ * @param now_us A free-running microsecond counter
+ * @param systick The SysTick registers, or <code>NULL</code> to report 0
+ *      cycles
+ */
+void isr_instrumentation_use_clock(uint32_t (*now_us)(void), struct cortex_m_systick volatile *systick);
+
+/**
+ * Prepares a probe for an ISR, zeroing its statistics, and adds it to the
+ * report.
+ *
+ * @param probe The probe, which must be statically allocated
+ * @param isr The ISR to be measured
+ * @param source 'p' for a pin, 't' for a timer
+ * @param number The pin or timer number
+ * @param period_us The ISR's period, or 0 if it is not periodic
+ */
+void isr_probe_initialize(struct isr_probe *probe, void (*isr)(void), char source, uint8_t number, uint32_t period_us);
+
+/**
+ * Calls the probe's ISR and records its latency and execution time.
+ *
+ * @param probe The probe whose ISR is to be called
+ * @param triggered_us When the interrupt was triggered; ignored for periodic
+ *      ISRs, whose latency is measured against their schedule
+ */
+void isr_probe_run(struct isr_probe *probe, uint32_t triggered_us);
+
+/**
+ * Prints each probe's call count, mean and worst-case execution time, worst
+ * latency, and histograms.
+ */
+void print_isr_report(void);
+
+#else
+
+static inline void print_isr_report(void) {}
+
+#endif //ISR_INSTRUMENTATION
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_ISR_INSTRUMENTATION_H
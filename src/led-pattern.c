@@ -0,0 +1,80 @@
+/**************************************************************************//**
+ *
+ * @file led-pattern.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief led-pattern.h
+ *
+ * @copydetails led-pattern.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <CowPi.h>
+#include "led-pattern.h"
+#include "timer-wheel.h"
+
+static struct software_timer pattern_timer;
+static struct led_pattern pattern;
+static uint16_t remaining_repetitions;
+static bool leds_are_on = false;
+static bool volatile is_running = false;
+
+static void set_leds(uint8_t leds) {
+    if (leds & LED_PATTERN_LEFT) {
+        cowpi_illuminate_left_led();
+    } else {
+        cowpi_deluminate_left_led();
+    }
+    if (leds & LED_PATTERN_RIGHT) {
+        cowpi_illuminate_right_led();
+    } else {
+        cowpi_deluminate_right_led();
+    }
+}
+
+static void advance_pattern(void *context) {
+    if (leds_are_on) {
+        set_leds(0);
+        leds_are_on = false;
+        if (pattern.repetitions != LED_PATTERN_FOREVER) {
+            remaining_repetitions--;
+        }
+        timer_wheel_arm(&pattern_timer, pattern.off_time_us, 0, advance_pattern, NULL);
+    } else if (pattern.repetitions != LED_PATTERN_FOREVER && remaining_repetitions == 0) {
+        is_running = false;
+        if (pattern.on_complete) {
+            pattern.on_complete();
+        }
+    } else {
+        set_leds(pattern.leds);
+        leds_are_on = true;
+        timer_wheel_arm(&pattern_timer, pattern.on_time_us, 0, advance_pattern, NULL);
+    }
+}
+
+void led_pattern_start(struct led_pattern const *new_pattern) {
+    timer_wheel_cancel(&pattern_timer);
+    pattern = *new_pattern;
+    remaining_repetitions = pattern.repetitions;
+    leds_are_on = false;
+    is_running = true;
+    advance_pattern(NULL);
+}
+
+void led_pattern_stop(void) {
+    timer_wheel_cancel(&pattern_timer);
+    is_running = false;
+    leds_are_on = false;
+    set_leds(0);
+}
+
+bool led_pattern_is_running(void) {
+    return is_running;
+}
@@ -0,0 +1,82 @@
+/**************************************************************************//**
+ *
+ * @file led-pattern.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Blinks the CowPi's LEDs in the background, following a pattern
+ *      described as data.
+ *
+ * A pattern names the LEDs to blink, how long they stay on and off, and how
+ * many times to blink them (or to blink them until stopped). The pattern runs
+ * from a timer-wheel callback, so starting one returns immediately and the
+ * main loop keeps running while the LEDs blink. Only one pattern runs at a
+ * time; starting another replaces it.
+ *
+ * A pattern that ends by itself calls its `on_complete` function, so that the
+ * application can react (for example, by posting a scheduler event) instead
+ * of polling `led_pattern_is_running()`. A pattern that is stopped or
+ * replaced, or that blinks forever, never calls it.
+ *
+ * The timer wheel must be initialized and ticking before a pattern is started.
+ *
+ * @see timer-wheel.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_LED_PATTERN_H
+#define COMBOLOCK_LED_PATTERN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LED_PATTERN_LEFT        (1 << 0)
+#define LED_PATTERN_RIGHT       (1 << 1)
+#define LED_PATTERN_BOTH        (LED_PATTERN_LEFT | LED_PATTERN_RIGHT)
+#define LED_PATTERN_FOREVER     (0)
+
+struct led_pattern {
+    uint8_t leds;               // LED_PATTERN_LEFT, LED_PATTERN_RIGHT, or LED_PATTERN_BOTH
+    uint32_t on_time_us;
+    uint32_t off_time_us;       // the pattern ends after the last off time
+    uint16_t repetitions;       // LED_PATTERN_FOREVER to blink until stopped
+    void (*on_complete)(void);  // called from the timer wheel when the pattern ends, or NULL for none
+};
+
+/**
+ * @brief Starts blinking the LEDs, replacing any pattern already running. The
+ * pattern begins with its LEDs illuminated.
+ *
+ * @param pattern The pattern to be run; it is copied, so it need not outlive
+ *      this call
+ */
+void led_pattern_start(struct led_pattern const *pattern);
+
+/**
+ * @brief Stops the running pattern, if any, and turns off both LEDs.
+ */
+void led_pattern_stop(void);
+
+/**
+ * @brief Reports whether a pattern is still running.
+ *
+ * @return `true` if a pattern is running; `false` if it has finished or been
+ *      stopped
+ */
+bool led_pattern_is_running(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_LED_PATTERN_H
@@ -16,6 +16,9 @@
 
 #include <CowPi.h>
 #include "display.h"
+#include "display-binding.h"
+#include "fixed-format.h"
+#include "led-pattern.h"
 #include "lock-controller.h"
 #include "rotary-encoder.h"
 #include "servomotor.h"
@@ -42,7 +45,22 @@ static int bad_attempts = 0;
 static bool user_has_interacted = false;
 
 static uint8_t combination[3] __attribute__((section (".uninitialized_ram.")));
+
+/* fast spins move the dial several values per detent; slow turns move one */
+static encoder_acceleration_point_t const dial_acceleration[] = {
+        {.minimum_steps_per_second = 0, .multiplier = 1},
+        {.minimum_steps_per_second = 12, .multiplier = 2},
+        {.minimum_steps_per_second = 24, .multiplier = 3},
+};
 static lock_state_t current_state = LOCKED;
+static struct display_binding entry_row;
+
+static struct led_pattern const bad_try_pattern = {
+        .leds = LED_PATTERN_BOTH, .on_time_us = 250000, .off_time_us = 250000, .repetitions = 2
+};
+static struct led_pattern const alarm_pattern = {
+        .leds = LED_PATTERN_BOTH, .on_time_us = 250000, .off_time_us = 250000, .repetitions = LED_PATTERN_FOREVER
+};
 
 uint8_t const *get_combination() {
     return combination;
@@ -62,6 +80,30 @@ void force_combination_reset() {
     combination[2] = 15;
 }
 
+static uint32_t get_entry_state_key(void) {
+    int const state[] = {user_has_interacted, combo_phase, current_value,
+                         entered_combination[0], entered_combination[1]};
+    return display_binding_hash(state, sizeof(state));
+}
+
+static void render_entry(char buffer[]) {
+    if (!user_has_interacted) {
+        format_end(format_string(buffer, "- - -"));
+    } else if (combo_phase == ENTERING_FIRST) {
+        format_end(format_string(format_decimal_2(buffer, current_value), "-  -  "));
+    } else if (combo_phase == ENTERING_SECOND) {
+        char *end = format_decimal_2(buffer, entered_combination[0]);
+        *end++ = '-';
+        format_end(format_string(format_decimal_2(end, current_value), "-  "));
+    } else if (combo_phase == ENTERING_THIRD) {
+        char *end = format_decimal_2(buffer, entered_combination[0]);
+        *end++ = '-';
+        end = format_decimal_2(end, entered_combination[1]);
+        *end++ = '-';
+        format_end(format_decimal_2(end, current_value));
+    }
+}
+
 void initialize_lock_controller() {
     set_lock_state(LOCKED);
     combo_phase = ENTERING_FIRST;
@@ -74,73 +116,82 @@ void initialize_lock_controller() {
     for (int i = 0; i < COMBO_LENGTH; i++) {
         entered_combination[i] = -1;
     }
-    display_string(1, "- - -");
+    display_binding_bind(&entry_row, 1, get_entry_state_key, render_entry);
+    display_binding_update(&entry_row);
     rotate_full_clockwise();
     force_combination_reset();
+    set_encoder_acceleration(dial_acceleration, sizeof(dial_acceleration) / sizeof(dial_acceleration[0]));
 }
 
-void control_lock() {
-    if (get_lock_state() == LOCKED) {
-        direction_t dir = get_direction();
+static void apply_step(direction_t dir) {
+    if (dir == CLOCKWISE || dir == COUNTERCLOCKWISE) {
+        user_has_interacted = true;
+    }
 
-        if (dir == CLOCKWISE || dir == COUNTERCLOCKWISE) {
-            user_has_interacted = true;
-        }
+    if (dir == CLOCKWISE) {
+        current_value = (current_value + 1) % 16;
+    } else if (dir == COUNTERCLOCKWISE) {
+        current_value = (current_value - 1 + 16) % 16;
+    }
 
-        if (dir == CLOCKWISE) {
-            current_value = (current_value + 1) % 16;
-        } else if (dir == COUNTERCLOCKWISE) {
-            current_value = (current_value - 1 + 16) % 16;
+    if (combo_phase == ENTERING_FIRST) {
+        if (dir == CLOCKWISE && current_value == combination[0]) {
+            first_seen_count++;
         }
-
-        if (combo_phase == ENTERING_FIRST) {
-            if (dir == CLOCKWISE && current_value == combination[0]) {
-                first_seen_count++;
-            }
-            if (dir == COUNTERCLOCKWISE && entered_combination[0] == -1 && first_seen_count >= 3) {
-                entered_combination[0] = current_value;
-                combo_phase = ENTERING_SECOND;
-                current_value = 0;
-            }
-        } else if (combo_phase == ENTERING_SECOND) {
-            if (dir == COUNTERCLOCKWISE && current_value == combination[1]) {
-                second_seen_count++;
-            }
-            if (dir == CLOCKWISE && entered_combination[1] == -1 && second_seen_count >= 2) {
-                entered_combination[1] = current_value;
-                combo_phase = ENTERING_THIRD;
-                current_value = 0;
+        if (dir == COUNTERCLOCKWISE && entered_combination[0] == -1 && first_seen_count >= 3) {
+            entered_combination[0] = current_value;
+            combo_phase = ENTERING_SECOND;
+            current_value = 0;
+        }
+    } else if (combo_phase == ENTERING_SECOND) {
+        if (dir == COUNTERCLOCKWISE && current_value == combination[1]) {
+            second_seen_count++;
+        }
+        if (dir == CLOCKWISE && entered_combination[1] == -1 && second_seen_count >= 2) {
+            entered_combination[1] = current_value;
+            combo_phase = ENTERING_THIRD;
+            current_value = 0;
+        }
+    } else if (combo_phase == ENTERING_THIRD) {
+        if (dir == CLOCKWISE) {
+            if (!seen_third_once && current_value == combination[2]) {
+                seen_third_once = true;
+                entered_combination[2] = current_value;
             }
-        } else if (combo_phase == ENTERING_THIRD) {
-            if (dir == CLOCKWISE) {
-                if (!seen_third_once && current_value == combination[2]) {
-                    seen_third_once = true;
-                    entered_combination[2] = current_value;
-                }
-            } else if (dir == COUNTERCLOCKWISE && entered_combination[2] != -1) {
-                for (int i = 0; i < COMBO_LENGTH; i++) {
-                    entered_combination[i] = -1;
-                }
-                combo_phase = ENTERING_FIRST;
-                current_value = 0;
-                first_seen_count = 0;
-                second_seen_count = 0;
-                seen_third_once = false;
-                user_has_interacted = false;
+        } else if (dir == COUNTERCLOCKWISE && entered_combination[2] != -1) {
+            for (int i = 0; i < COMBO_LENGTH; i++) {
+                entered_combination[i] = -1;
             }
+            combo_phase = ENTERING_FIRST;
+            current_value = 0;
+            first_seen_count = 0;
+            second_seen_count = 0;
+            seen_third_once = false;
+            user_has_interacted = false;
         }
+    }
+}
 
-        char buffer[20];
+void control_lock() {
+    if (get_lock_state() != LOCKED) {
+        discard_encoder_events();       // turns made while open or alarmed do not count toward the next entry
+    } else {
+        encoder_event_t events[8];
+        size_t number_of_events;
+        do {
+            number_of_events = drain_encoder_events(events, sizeof(events) / sizeof(events[0]));
+            for (size_t i = 0; i < number_of_events; i++) {
+                // apply accelerated moves one value at a time so that passes over a combination number still
+                // count, and let a change of phase absorb the rest of the move
+                int delta = get_accelerated_delta(events + i);
+                combo_phase_t phase = combo_phase;
+                for (int step = 0; step < abs(delta) && combo_phase == phase; step++) {
+                    apply_step(events[i].direction);
+                }
+            }
+        } while (number_of_events == sizeof(events) / sizeof(events[0]));
 
-        if (!user_has_interacted) {
-            sprintf(buffer, "- - -");
-        } else if (combo_phase == ENTERING_FIRST) {
-            sprintf(buffer, "%02d-  -  ", current_value);
-        } else if (combo_phase == ENTERING_SECOND) {
-            sprintf(buffer, "%02d-%02d-  ", entered_combination[0], current_value);
-        } else if (combo_phase == ENTERING_THIRD) {
-            sprintf(buffer, "%02d-%02d-%02d", entered_combination[0], entered_combination[1], current_value);
-        }
+        char buffer[20] = {0};
 
         if (combo_phase == ENTERING_THIRD && entered_combination[2] != -1 && cowpi_left_button_is_pressed()) {
             bool correct = true;
@@ -151,15 +202,17 @@ void control_lock() {
 
             if (correct) {
                 set_lock_state(UNLOCKED);
-                sprintf(buffer, "OPEN");
+                sprintf(buffer, "OPEN\n");
                 rotate_full_counterclockwise();
             } else {
                 bad_attempts++;
                 if (bad_attempts >= 3) {
                     set_lock_state(ALARMED);
-                    sprintf(buffer, "alert!");
+                    sprintf(buffer, "alert!\n");
+                    led_pattern_start(&alarm_pattern);
                 } else {
                     sprintf(buffer, "bad try %d", bad_attempts);
+                    led_pattern_start(&bad_try_pattern);
                     for (int i = 0; i < COMBO_LENGTH; i++) {
                         entered_combination[i] = -1;
                     }
@@ -172,6 +225,11 @@ void control_lock() {
                 }
             }
         }
-        display_string(1, buffer);
+        if (buffer[0]) {
+            display_string(1, buffer);
+            display_binding_invalidate(&entry_row);     // the next pass shows the entry again
+        } else {
+            display_binding_update(&entry_row);
+        }
     }
 }
@@ -0,0 +1,138 @@
+/**************************************************************************//**
+ *
+ * @file lock-tasks.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief lock-tasks.h
+ *
+ * @copydetails lock-tasks.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <CowPi.h>
+#include <string.h>
+#include "display.h"
+#include "display-binding.h"
+#include "fixed-format.h"
+#include "lock-controller.h"
+#include "lock-tasks.h"
+#include "rotary-encoder.h"
+#include "servomotor.h"
+#include "work-queue.h"
+
+#define LIVENESS_ROW    (7)
+
+static struct display_binding rotations_row;
+static struct display_binding servo_row;
+static struct display_binding combo_row;
+
+void lock_tasks_post_deferred_work(void) {
+    scheduler_post_event(EVENT_DEFERRED_WORK);
+}
+
+void lock_tasks_post_encoder_step(void) {
+    scheduler_post_event(EVENT_ENCODER_STEP);
+}
+
+void lock_tasks_post_input_change(void) {
+    scheduler_post_event(EVENT_INPUT_CHANGE);
+}
+
+void lock_tasks_poll_inputs(void *context) {
+    static uint8_t previous_inputs = 0xFF;
+    uint8_t inputs = (uint8_t) (cowpi_left_button_is_pressed()
+                                | cowpi_right_button_is_pressed() << 1
+                                | cowpi_left_switch_is_in_left_position() << 2
+                                | cowpi_right_switch_is_in_left_position() << 3);
+    if (inputs != previous_inputs) {
+        previous_inputs = inputs;
+        scheduler_post_event(EVENT_INPUT_CHANGE);
+    }
+}
+
+void lock_tasks_post_display_frame(void *context) {
+    scheduler_post_event(EVENT_DISPLAY_FRAME);
+}
+
+static void run_deferred_work(event_mask_t events) {
+    if (work_queue_drain(WORK_ITEMS_PER_RUN) == WORK_ITEMS_PER_RUN) {
+        scheduler_post_event(EVENT_DEFERRED_WORK);     // let other tasks run before draining the rest
+    }
+}
+
+static void run_lock_controller(event_mask_t events) {
+    control_lock();
+    scheduler_post_event(EVENT_DISPLAY_FRAME);
+}
+
+static void render_rotations(char buffer[]) {
+    count_rotations(buffer);
+}
+
+/* run_test_mode() commands the servo and leaves test_servo()'s description of the command here */
+static char servo_status[DISPLAY_BINDING_BUFFER_SIZE] = {0};
+
+static uint32_t get_servo_status_key(void) {
+    return display_binding_hash(servo_status, strlen(servo_status));
+}
+
+static void render_servo(char buffer[]) {
+    strcpy(buffer, servo_status);
+}
+
+static uint32_t get_combination_key(void) {
+    return display_binding_hash(get_combination(), 3);
+}
+
+static void render_combination(char buffer[]) {
+    uint8_t const *combination = get_combination();
+    char *end = format_decimal_2(format_string(buffer, "Combo: "), combination[0]);
+    *end++ = '-';
+    end = format_decimal_2(end, combination[1]);
+    *end++ = '-';
+    format_end(format_decimal_2(end, combination[2]));
+}
+
+static void run_test_mode(event_mask_t events) {
+    static bool is_pressed = false;
+    discard_encoder_events();       // the rotations row reads the step counts, not the queue
+    if (cowpi_right_button_is_pressed() && !is_pressed) {
+        is_pressed = true;
+        force_combination_reset();
+    }
+    if (!cowpi_right_button_is_pressed() && is_pressed) {
+        is_pressed = false;
+    }
+    test_servo(servo_status);       // repeating a move to the current target is a no-op
+    display_binding_update(&rotations_row);
+    display_binding_update(&servo_row);
+    display_binding_update(&combo_row);
+    scheduler_post_event(EVENT_DISPLAY_FRAME);
+}
+
+static void run_display(event_mask_t events) {
+    count_visits(LIVENESS_ROW);         // refreshes the display
+    if (display_flush_is_in_progress()) {
+        scheduler_post_event(EVENT_DISPLAY_FRAME);     // keep the background flush moving
+    }
+}
+
+void lock_tasks_add(bool test_mode) {
+    scheduler_add_task("work", EVENT_DEFERRED_WORK, run_deferred_work);
+    if (test_mode) {
+        display_binding_bind(&rotations_row, 1, get_rotation_count_version, render_rotations);
+        display_binding_bind(&servo_row, 2, get_servo_status_key, render_servo);
+        display_binding_bind(&combo_row, 3, get_combination_key, render_combination);
+        scheduler_add_task("test", EVENT_ENCODER_STEP | EVENT_INPUT_CHANGE, run_test_mode);
+    } else {
+        scheduler_add_task("lock", EVENT_ENCODER_STEP | EVENT_INPUT_CHANGE, run_lock_controller);
+    }
+    scheduler_add_task("display", EVENT_DISPLAY_FRAME, run_display);
+}
@@ -0,0 +1,72 @@
+/**************************************************************************//**
+ *
+ * @file lock-tasks.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief The ComboLock's scheduler tasks and the events that wake them.
+ *
+ * `lock_tasks_add()` adds, in order, the task that drains the work queue; the
+ * lock controller (or, in test mode, the task that exercises the servo and
+ * shows the encoder's counts); and the display. The remaining functions post
+ * the tasks' events, and are meant to be registered as callbacks: with the
+ * work queue, the rotary encoder, the buttons' ISR, and the timer wheel.
+ *
+ * The tasks reach the hardware only through the other modules, so a host test
+ * can link this module with the scheduler, post events, and watch which tasks
+ * run.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_LOCK_TASKS_H
+#define COMBOLOCK_LOCK_TASKS_H
+
+#include <stdbool.h>
+#include "scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EVENT_ENCODER_STEP      (1 << 0)
+#define EVENT_INPUT_CHANGE      (1 << 1)
+#define EVENT_DISPLAY_FRAME     (1 << 2)
+#define EVENT_DEFERRED_WORK     (1 << 3)
+
+#define WORK_ITEMS_PER_RUN      (8)
+
+/**
+ * @brief Adds the ComboLock's tasks to the scheduler and, in test mode, binds
+ * the display rows that the test task keeps up to date.
+ *
+ * @param test_mode `true` to exercise the servo and encoder instead of running
+ *      the lock controller
+ */
+void lock_tasks_add(bool test_mode);
+
+/* Posts EVENT_DEFERRED_WORK; for work_queue_set_notify(). */
+void lock_tasks_post_deferred_work(void);
+
+/* Posts EVENT_ENCODER_STEP; for set_encoder_event_callback(). */
+void lock_tasks_post_encoder_step(void);
+
+/* Posts EVENT_INPUT_CHANGE; for the buttons' ISR, and for the end of an LED pattern that the lock waits on. */
+void lock_tasks_post_input_change(void);
+
+/* Posts EVENT_INPUT_CHANGE if a button or switch changed since the last poll; for a periodic timer. */
+void lock_tasks_poll_inputs(void *context);
+
+/* Posts EVENT_DISPLAY_FRAME; for a periodic timer. */
+void lock_tasks_post_display_frame(void *context);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_LOCK_TASKS_H
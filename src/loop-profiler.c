@@ -0,0 +1,82 @@
+/**************************************************************************//**
+ *
+ * @file loop-profiler.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief loop-profiler.h
+ *
+ * @copydetails loop-profiler.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "loop-profiler.h"
+
+uint32_t loop_timestamp_us = 0;
+
+#ifdef LOOP_PROFILING
+
+#define WINDOW_LENGTH_us (1000000)
+
+static uint32_t window_start_us = 0;
+static uint32_t iterations_in_window = 0;
+static uint32_t minimum_period_us = UINT32_MAX;
+static uint32_t maximum_period_us = 0;
+static uint32_t histogram[LOOP_PROFILE_BUCKETS] = {0};
+static struct loop_profile published_profile;
+
+static inline unsigned int log2_bucket(uint32_t period_us) {
+    unsigned int bucket = period_us ? 31 - __builtin_clz(period_us) : 0;
+    return bucket < LOOP_PROFILE_BUCKETS ? bucket : LOOP_PROFILE_BUCKETS - 1;
+}
+
+void mark_loop_iteration(void) {
+    uint32_t now = get_microseconds();
+    uint32_t period_us = now - loop_timestamp_us;
+    loop_timestamp_us = now;
+    if (iterations_in_window) {
+        if (period_us < minimum_period_us) minimum_period_us = period_us;
+        if (period_us > maximum_period_us) maximum_period_us = period_us;
+        histogram[log2_bucket(period_us)]++;
+    }
+    iterations_in_window++;
+    uint32_t elapsed_us = now - window_start_us;
+    if (elapsed_us >= WINDOW_LENGTH_us) {
+        published_profile.iterations_per_second = (uint32_t) ((uint64_t) iterations_in_window * 1000000 / elapsed_us);
+        published_profile.minimum_period_us = minimum_period_us;
+        published_profile.mean_period_us = elapsed_us / iterations_in_window;
+        published_profile.maximum_period_us = maximum_period_us;
+        memcpy(published_profile.histogram, histogram, sizeof(histogram));
+        window_start_us = now;
+        iterations_in_window = 0;
+        minimum_period_us = UINT32_MAX;
+        maximum_period_us = 0;
+        memset(histogram, 0, sizeof(histogram));
+    }
+}
+
+struct loop_profile get_loop_profile(void) {
+    return published_profile;
+}
+
+void print_loop_profile(void) {
+    struct loop_profile profile = get_loop_profile();
+    printf("loop: %lu/s  period min %lu us, mean %lu us, max %lu us\n",
+           (unsigned long) profile.iterations_per_second, (unsigned long) profile.minimum_period_us,
+           (unsigned long) profile.mean_period_us, (unsigned long) profile.maximum_period_us);
+    for (unsigned int bucket = 0; bucket < LOOP_PROFILE_BUCKETS; bucket++) {
+        if (profile.histogram[bucket]) {
+            printf("  >= %6lu us: %lu\n", 1UL << bucket, (unsigned long) profile.histogram[bucket]);
+        }
+    }
+}
+
+#endif //LOOP_PROFILING
@@ -0,0 +1,81 @@
+/**************************************************************************//**
+ *
+ * @file loop-profiler.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Measures how often the main loop runs and how long each pass takes.
+ *
+ * Profiling is compiled in only when `LOOP_PROFILING` is defined (for example,
+ * with `build_flags = -DLOOP_PROFILING` in platformio.ini). Otherwise,
+ * `mark_loop_iteration()` does nothing but record a timestamp.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_LOOP_PROFILER_H
+#define COMBOLOCK_LOOP_PROFILER_H
+
+#include <stdint.h>
+#include "microsecond-timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOOP_PROFILE_BUCKETS (16)
+
+/**
+ * Loop statistics for the most recent complete one-second window.
+ * Bucket *k* of the histogram counts loop periods of at least 2<sup>*k*</sup>
+ * and less than 2<sup>*k*+1</sup> microseconds (bucket 0 also counts periods
+ * of 0 µs); the last bucket also counts all longer periods.
+ */
+struct loop_profile {
+    uint32_t iterations_per_second;
+    uint32_t minimum_period_us;
+    uint32_t mean_period_us;
+    uint32_t maximum_period_us;
+    uint32_t histogram[LOOP_PROFILE_BUCKETS];
+};
+
+extern uint32_t loop_timestamp_us;
+
+#ifdef LOOP_PROFILING
+
+/**
+ * Records the end of one pass through the main loop. Call exactly once per
+ * pass.
+ */
+void mark_loop_iteration(void);
+
+/**
+ * Reports the loop statistics for the most recent complete one-second window.
+ *
+ * @return The loop statistics
+ */
+struct loop_profile get_loop_profile(void);
+
+/**
+ * Prints the loop statistics for the most recent complete one-second window.
+ */
+void print_loop_profile(void);
+
+#else
+
+static inline void mark_loop_iteration(void) {
+    loop_timestamp_us = get_microseconds();
+}
+
+#endif //LOOP_PROFILING
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_LOOP_PROFILER_H
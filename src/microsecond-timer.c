@@ -0,0 +1,33 @@
+/**************************************************************************//**
+ *
+ * @file microsecond-timer.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief microsecond-timer.h
+ *
+ * @copydetails microsecond-timer.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include "microsecond-timer.h"
+
+#if !defined (ARDUINO)
+#include <time.h>
+
+uint32_t get_microseconds(void) {
+    static struct timespec start = {0, 0};
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (start.tv_sec == 0 && start.tv_nsec == 0) {
+        start = now;
+    }
+    return (uint32_t) ((now.tv_sec - start.tv_sec) * 1000000L + (now.tv_nsec - start.tv_nsec) / 1000L);
+}
+#endif //ARDUINO
@@ -0,0 +1,58 @@
+/**************************************************************************//**
+ *
+ * @file microsecond-timer.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Inline access to a free-running microsecond counter.
+ *
+ * On the RP2040 this reads the lower word of the hardware timer directly,
+ * which is cheaper than going through the Arduino framework's `micros()`.
+ * Host builds have no such counter: they link either microsecond-timer.c,
+ * which reads the host's monotonic clock, or a test's simulated clock.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_MICROSECOND_TIMER_H
+#define COMBOLOCK_MICROSECOND_TIMER_H
+
+#include <stdint.h>
+
+#if defined (ARDUINO_ARCH_RP2040)
+#include <CowPi.h>
+
+#define RP2040_TIMER ((cowpi_timer_t volatile *) (0x40054000))
+
+static inline uint32_t get_microseconds(void) {
+    return RP2040_TIMER->raw_lower_word;
+}
+#elif defined (ARDUINO)
+#include <Arduino.h>
+
+static inline uint32_t get_microseconds(void) {
+    return (uint32_t) micros();
+}
+#else
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Reads the host's clock.
+ *
+ * @return Microseconds elapsed since the first call
+ */
+uint32_t get_microseconds(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+#endif //ARDUINO_ARCH_RP2040
+
+#endif //COMBOLOCK_MICROSECOND_TIMER_H
@@ -0,0 +1,71 @@
+/**************************************************************************//**
+ *
+ * @file pin-filter.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief pin-filter.h
+ *
+ * @copydetails pin-filter.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include "pin-filter.h"
+
+void pin_filter_initialize(struct pin_filter *filter, uint8_t pin, void (*isr)(void), pin_filter_mode_t mode,
+                           uint32_t interval_us, struct pin_filter_clock const *clock) {
+    *filter = (struct pin_filter) {
+            .interrupt_service_routine = isr,
+            .clock = clock,
+            .pin = pin,
+            .mode = mode,
+            .interval_us = interval_us,
+            .last_accepted_edge_us = clock->now_us() - interval_us,
+            .is_settling = false,
+            .accepted_level = clock->read_pin(pin),
+            .rejected_edges = 0,
+    };
+}
+
+void pin_filter_handle_edge(struct pin_filter *filter) {
+    if (filter->mode == PIN_FILTER_MINIMUM_INTERVAL) {
+        uint32_t now = filter->clock->now_us();
+        if (now - filter->last_accepted_edge_us < filter->interval_us) {
+            filter->rejected_edges++;
+            return;
+        }
+        filter->last_accepted_edge_us = now;
+        filter->accepted_level = filter->clock->read_pin(filter->pin);
+        filter->interrupt_service_routine();
+    } else {
+        if (filter->is_settling) {
+            filter->rejected_edges++;   // superseded by this edge; the settling time starts over
+        }
+        filter->is_settling = true;
+        filter->clock->start_settling_timer(filter, filter->interval_us);
+    }
+}
+
+void pin_filter_handle_settling_timeout(struct pin_filter *filter) {
+    if (!filter->is_settling) {
+        return;
+    }
+    filter->is_settling = false;
+    bool level = filter->clock->read_pin(filter->pin);
+    if (level != filter->accepted_level) {
+        filter->accepted_level = level;
+        filter->interrupt_service_routine();
+    } else {
+        filter->rejected_edges++;       // the pin bounced back to where it was
+    }
+}
+
+uint32_t pin_filter_get_rejected_edge_count(struct pin_filter const *filter) {
+    return filter->rejected_edges;
+}
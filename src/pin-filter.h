@@ -0,0 +1,118 @@
+/**************************************************************************//**
+ *
+ * @file pin-filter.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Time-based filtering of a pin's edges before they reach its ISR.
+ *
+ * Each filtered pin has a `struct pin_filter`, which is passed each edge that
+ * the pin's interrupt reports. The filter decides, from the time of the edge
+ * or from the pin's level once it has settled, whether the edge reaches the
+ * pin's ISR, and counts the edges that it rejects.
+ *
+ * The module does not touch the hardware. A `struct pin_filter_clock`
+ * supplies the time, the pin's level, and a one-shot settling timer per pin,
+ * so a host program can drive the filter from a simulated clock.
+ * interrupt_support.cpp supplies the clock for `register_filtered_pin_ISR()`.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_PIN_FILTER_H
+#define COMBOLOCK_PIN_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * How edges are filtered.
+ * <ul>
+ * <li> `PIN_FILTER_MINIMUM_INTERVAL`: an edge is passed on only if at least
+ *      the interval has passed since the last edge that was passed on. The
+ *      ISR runs immediately on the first edge of a bounce.
+ * <li> `PIN_FILTER_SETTLE_THEN_CONFIRM`: each edge (re)starts a settling time
+ *      of the interval; when the pin has had no edges for that long, the ISR
+ *      runs once if the pin's level differs from the last level passed on.
+ * </ul>
+ */
+typedef enum {
+    PIN_FILTER_MINIMUM_INTERVAL, PIN_FILTER_SETTLE_THEN_CONFIRM
+} pin_filter_mode_t;
+
+struct pin_filter;
+
+/* The time, the pins, and the settling timers that the filters use. */
+struct pin_filter_clock {
+    uint32_t (*now_us)(void);                                   // a free-running microsecond counter
+    bool (*read_pin)(uint8_t pin);
+    /* calls `pin_filter_handle_settling_timeout(filter)` `delay_us` from now, replacing any call still pending */
+    void (*start_settling_timer)(struct pin_filter *filter, uint32_t delay_us);
+};
+
+/* One pin's filter. Its contents are managed by this module; the caller only
+ * allocates it. */
+struct pin_filter {
+    void (*interrupt_service_routine)(void);
+    struct pin_filter_clock const *clock;
+    uint8_t pin;
+    pin_filter_mode_t mode;
+    uint32_t interval_us;
+    uint32_t last_accepted_edge_us;
+    bool is_settling;
+    bool accepted_level;
+    uint32_t rejected_edges;
+};
+
+/**
+ * @brief Prepares a pin's filter, taking the pin's present level as the last
+ * level passed on, and zeroes its count of rejected edges.
+ *
+ * @param filter The filter to be prepared
+ * @param pin The pin whose edges will be filtered
+ * @param isr The function that the accepted edges reach
+ * @param mode How edges are filtered
+ * @param interval_us The minimum edge interval or settling time
+ * @param clock The clock, pins, and settling timers, which must outlive the
+ *      filter
+ */
+void pin_filter_initialize(struct pin_filter *filter, uint8_t pin, void (*isr)(void), pin_filter_mode_t mode,
+                           uint32_t interval_us, struct pin_filter_clock const *clock);
+
+/**
+ * @brief Filters one edge on the pin. Call from the pin's interrupt.
+ *
+ * @param filter The pin's filter
+ */
+void pin_filter_handle_edge(struct pin_filter *filter);
+
+/**
+ * @brief Ends the pin's settling time, passing the edge on if the pin has
+ * settled at a new level. Call from the settling timer.
+ *
+ * @param filter The pin's filter
+ */
+void pin_filter_handle_settling_timeout(struct pin_filter *filter);
+
+/**
+ * @brief Reports how many edges the filter has kept from reaching the ISR.
+ *
+ * @param filter The pin's filter
+ * @return The number of rejected edges since the filter was prepared
+ */
+uint32_t pin_filter_get_rejected_edge_count(struct pin_filter const *filter);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_PIN_FILTER_H
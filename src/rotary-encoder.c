@@ -15,38 +15,107 @@
  */
 
 #include <CowPi.h>
+#include "fixed-format.h"
 #include "interrupt_support.h"
+#include "microsecond-timer.h"
 #include "rotary-encoder.h"
+#include "work-queue.h"
 
 #define A_WIPER_PIN         (16)
 #define B_WIPER_PIN         (A_WIPER_PIN + 1)
+#define SAMPLING_TIMER      (1)     // timer 0 drives the servo
+#define WIPER_SETTLING_us   (500)   // longer than the wipers' bounces, shorter than a fast spin's edge interval
 
-#define SIO_GPIO_IN (*(volatile uint32_t *)(0xd0000004))  // RP2040's GPIO input register
+#define SIO_GPIO_IN (0xd0000004)  // RP2040's GPIO input register
 
+static uint32_t const volatile *gpio_input = (uint32_t *) (SIO_GPIO_IN);
 
-typedef enum {
-    HIGH_HIGH, HIGH_LOW, LOW_LOW, LOW_HIGH, UNKNOWN
-} rotation_state_t;
 
-static rotation_state_t volatile state;
-static direction_t volatile direction = STATIONARY;
+/* Quadrature decoding is a lookup on (previous_ab << 2) | current_ab, where a
+ * clockwise turn cycles the wipers 11 -> 10 -> 00 -> 01 -> 11. A change of
+ * both wipers at once is impossible for a real rotation, so it is counted as
+ * an illegal transition (typically contact bounce) and contributes nothing. */
+#define ILLEGAL (2)
+
+static int8_t const transitions[16] = {
+        /*         to 00    to 01    to 10    to 11 */
+        /* 00 */   0,       +1,      -1,      ILLEGAL,
+        /* 01 */   -1,      0,       ILLEGAL, +1,
+        /* 10 */   +1,      ILLEGAL, 0,       -1,
+        /* 11 */   ILLEGAL, -1,      +1,      0,
+};
+
+/* Quadrature states at which accumulated edges are converted into steps:
+ * the 11 detent for 1x, both 11 and 00 for 2x, every state for 4x */
+#define REST_STATES_1X  (1 << 0b11)
+#define REST_STATES_2X  ((1 << 0b11) | (1 << 0b00))
+#define REST_STATES_4X  (0xF)
+
+static uint8_t volatile previous_quadrature;
+static int8_t volatile edges_per_step = ENCODER_1X;
+static uint8_t volatile rest_states = REST_STATES_1X;
+static uint8_t volatile steps_per_detent = 1;
 static int volatile clockwise_count = 0;
 static int volatile counterclockwise_count = 0;
+static uint32_t volatile illegal_transition_count = 0;
+
+/* Single-producer/single-consumer ring of step events: only the ISR advances
+ * `event_head` and only the main loop advances `event_tail`, so no locking is
+ * needed. The indices run freely and are reduced modulo the (power-of-two)
+ * queue length when used. */
+#define EVENT_QUEUE_LENGTH  (32)
+
+static encoder_event_t event_queue[EVENT_QUEUE_LENGTH];
+static uint32_t volatile event_head = 0;
+static uint32_t volatile event_tail = 0;
+static uint32_t volatile event_overflow_count = 0;
+static void (*event_callback)(void) = NULL;
+
+/* When steps are deferred, the ISR only timestamps each step and posts it to
+ * the work queue; the velocity estimate and the ring's producer side then run
+ * in the main context. Only one context ever produces into the ring. */
+static bool volatile is_deferring_steps = false;
+
+/* Step velocity is estimated from a smoothed (exponential moving average,
+ * weight 1/4) interval between consecutive steps in the same direction, and
+ * reported in steps per second as an unsigned Q24.8 fixed-point number. */
+#define MAXIMUM_STEP_INTERVAL_us    (500000)
+
+static encoder_acceleration_point_t const *acceleration_curve = NULL;
+static size_t acceleration_curve_length = 0;
+
+/* In the timer-sampled mode, each wiper has a saturating integrator that
+ * counts up on high samples and down on low samples; the debounced level
+ * changes only when the integrator reaches the opposite rail. An excursion
+ * from a rail that returns to the same rail is a rejected glitch. */
+#define DEBOUNCE_INTEGRATOR_MAXIMUM (3)
+
+static encoder_mode_t encoder_mode = ENCODER_INTERRUPT_DRIVEN;
+static uint8_t integrators[2];
+static bool excursions[2];
+static uint8_t volatile debounced_quadrature;
+static uint32_t volatile glitch_count = 0;
 
 
 static void handle_quadrature_interrupt();
+static void handle_sampling_interrupt();
 
 void initialize_rotary_encoder() {
 
-    state = UNKNOWN;
     cowpi_set_pullup_input_pins((1 << A_WIPER_PIN) | (1 << B_WIPER_PIN));
-    
-    register_pin_ISR((1 << A_WIPER_PIN) | (1 << B_WIPER_PIN), handle_quadrature_interrupt);
+    previous_quadrature = get_quadrature();
+
+    register_filtered_pin_ISR((1 << A_WIPER_PIN) | (1 << B_WIPER_PIN), handle_quadrature_interrupt,
+                              PIN_FILTER_SETTLE_THEN_CONFIRM, WIPER_SETTLING_us);
+}
+
+void rotary_encoder_use_registers(uint32_t const volatile *gpio_input_register) {
+    gpio_input = gpio_input_register;
 }
 
 uint8_t get_quadrature() {
     
-    uint32_t gpio_state = SIO_GPIO_IN;
+    uint32_t gpio_state = *gpio_input;
 
     uint8_t a = (gpio_state >> A_WIPER_PIN) & 0x01;
     uint8_t b = (gpio_state >> B_WIPER_PIN) & 0x01;
@@ -56,44 +125,235 @@ uint8_t get_quadrature() {
 
 char *count_rotations(char *buffer) {
     
-    sprintf(buffer, "CW:%d CCW:%d", clockwise_count, counterclockwise_count);
+    char *end = format_unsigned(format_string(buffer, "CW:"), clockwise_count);
+    format_end(format_unsigned(format_string(end, " CCW:"), counterclockwise_count));
 
     return buffer;
 }
 
-direction_t get_direction() {
-    direction_t current_direction = direction;
-    direction = STATIONARY;
-    return current_direction;
+uint32_t get_rotation_count_version() {
+    return (uint32_t) (clockwise_count + counterclockwise_count);     // each step increments one of them
 }
 
-static void handle_quadrature_interrupt() {
-    static rotation_state_t last_state = HIGH_HIGH;
-    static rotation_state_t state_before_last = HIGH_HIGH;
+void set_encoder_mode(encoder_mode_t mode, uint32_t sample_period_us) {
+    uint32_t const wipers = (1 << A_WIPER_PIN) | (1 << B_WIPER_PIN);
+    if (mode == ENCODER_TIMER_SAMPLED) {
+        register_filtered_pin_ISR(wipers, NULL, PIN_FILTER_SETTLE_THEN_CONFIRM, WIPER_SETTLING_us);
+        uint8_t quadrature = get_quadrature();
+        for (int wiper = 0; wiper < 2; wiper++) {
+            integrators[wiper] = ((quadrature >> wiper) & 0x1) ? DEBOUNCE_INTEGRATOR_MAXIMUM : 0;
+            excursions[wiper] = false;
+        }
+        debounced_quadrature = quadrature;
+        previous_quadrature = quadrature;
+        encoder_mode = mode;
+        register_periodic_timer_ISR(SAMPLING_TIMER, sample_period_us, handle_sampling_interrupt);
+    } else {
+        if (encoder_mode == ENCODER_TIMER_SAMPLED) {
+            stop_periodic_timer(SAMPLING_TIMER);
+        }
+        previous_quadrature = get_quadrature();
+        encoder_mode = mode;
+        register_filtered_pin_ISR(wipers, handle_quadrature_interrupt, PIN_FILTER_SETTLE_THEN_CONFIRM,
+                                  WIPER_SETTLING_us);
+    }
+}
 
-    uint8_t quadrature = get_quadrature();
+uint32_t get_encoder_glitch_count() {
+    if (encoder_mode == ENCODER_TIMER_SAMPLED) {
+        return glitch_count;
+    }
+    return get_rejected_edge_count(A_WIPER_PIN) + get_rejected_edge_count(B_WIPER_PIN);
+}
+
+void set_encoder_resolution(encoder_resolution_t resolution, uint8_t detent_steps) {
+    edges_per_step = (int8_t) resolution;
+    switch (resolution) {
+        case ENCODER_4X:
+            rest_states = REST_STATES_4X;
+            break;
+        case ENCODER_2X:
+            rest_states = REST_STATES_2X;
+            break;
+        default:
+            rest_states = REST_STATES_1X;
+    }
+    steps_per_detent = detent_steps ? detent_steps : 1;
+}
+
+uint32_t get_illegal_transition_count() {
+    return illegal_transition_count;
+}
+
+static inline uint32_t estimate_velocity(uint32_t now, direction_t step_direction) {
+    static uint32_t last_step_us = 0;
+    static direction_t last_direction = STATIONARY;
+    static uint32_t smoothed_interval_us = MAXIMUM_STEP_INTERVAL_us;
+    uint32_t interval_us = now - last_step_us;
+    if (step_direction != last_direction || interval_us > MAXIMUM_STEP_INTERVAL_us) {
+        interval_us = MAXIMUM_STEP_INTERVAL_us;
+        smoothed_interval_us = MAXIMUM_STEP_INTERVAL_us;
+    }
+    smoothed_interval_us = smoothed_interval_us - (smoothed_interval_us >> 2) + (interval_us >> 2);
+    last_step_us = now;
+    last_direction = step_direction;
+    return (1000000u << 8) / (smoothed_interval_us ? smoothed_interval_us : 1);
+}
+
+static void record_step(direction_t step_direction, uint32_t now) {
+    uint32_t velocity = estimate_velocity(now, step_direction);
+    uint32_t head = event_head;
+    if (head - __atomic_load_n(&event_tail, __ATOMIC_ACQUIRE) >= EVENT_QUEUE_LENGTH) {
+        event_overflow_count++;                     // keep the oldest, but still wake the consumer to catch up
+    } else {
+        event_queue[head % EVENT_QUEUE_LENGTH] = (encoder_event_t) {
+                .timestamp_us = now,
+                .velocity_q8 = velocity,
+                .direction = step_direction,
+        };
+        __atomic_store_n(&event_head, head + 1, __ATOMIC_RELEASE);
+    }
+    if (event_callback) {
+        event_callback();
+    }
+}
+
+static void record_clockwise_step(uint32_t timestamp_us) {
+    record_step(CLOCKWISE, timestamp_us);
+}
+
+static void record_counterclockwise_step(uint32_t timestamp_us) {
+    record_step(COUNTERCLOCKWISE, timestamp_us);
+}
+
+static inline void post_step(direction_t step_direction) {
+    uint32_t now = get_microseconds();
+    if (!is_deferring_steps) {
+        record_step(step_direction, now);
+    } else if (!work_queue_post(step_direction == CLOCKWISE ? record_clockwise_step : record_counterclockwise_step,
+                                now)) {
+        event_overflow_count++;         // the counts still have the step; only its event is lost
+        if (event_callback) {
+            event_callback();
+        }
+    }
+}
+
+void set_encoder_step_deferral(bool defer_to_work_queue) {
+    is_deferring_steps = defer_to_work_queue;
+}
 
-    rotation_state_t current_state;
-    switch (quadrature) {
-        case 0b00: current_state = LOW_LOW; break;
-        case 0b01: current_state = LOW_HIGH; break;
-        case 0b10: current_state = HIGH_LOW; break;
-        case 0b11: current_state = HIGH_HIGH; break;
-        default:   current_state = UNKNOWN; break;
+void set_encoder_event_callback(void (*callback)(void)) {
+    event_callback = callback;
+}
+
+size_t drain_encoder_events(encoder_event_t events[], size_t maximum_number_of_events) {
+    uint32_t tail = event_tail;
+    uint32_t available = __atomic_load_n(&event_head, __ATOMIC_ACQUIRE) - tail;
+    size_t number_of_events = available < maximum_number_of_events ? available : maximum_number_of_events;
+    for (size_t i = 0; i < number_of_events; i++) {
+        events[i] = event_queue[(tail + i) % EVENT_QUEUE_LENGTH];
     }
+    __atomic_store_n(&event_tail, tail + number_of_events, __ATOMIC_RELEASE);
+    return number_of_events;
+}
+
+size_t discard_encoder_events() {
+    uint32_t head = __atomic_load_n(&event_head, __ATOMIC_ACQUIRE);
+    size_t number_of_events = head - event_tail;
+    __atomic_store_n(&event_tail, head, __ATOMIC_RELEASE);
+    return number_of_events;
+}
 
-    if (current_state == LOW_LOW) {
-        if (last_state == HIGH_LOW && state_before_last == HIGH_HIGH) {
-            clockwise_count++;
-            direction = CLOCKWISE;
-        } else if (last_state == LOW_HIGH && state_before_last == HIGH_HIGH) {
-            counterclockwise_count++;
-            direction = COUNTERCLOCKWISE;
+void set_encoder_acceleration(encoder_acceleration_point_t const curve[], size_t number_of_points) {
+    acceleration_curve = curve;
+    acceleration_curve_length = curve ? number_of_points : 0;
+}
+
+int get_accelerated_delta(encoder_event_t const *event) {
+    uint8_t multiplier = 1;
+    for (size_t i = 0; i < acceleration_curve_length; i++) {
+        if ((event->velocity_q8 >> 8) >= acceleration_curve[i].minimum_steps_per_second) {
+            multiplier = acceleration_curve[i].multiplier;
         }
     }
+    switch (event->direction) {
+        case CLOCKWISE:
+            return multiplier;
+        case COUNTERCLOCKWISE:
+            return -multiplier;
+        default:
+            return 0;
+    }
+}
 
-    state_before_last = last_state;
-    last_state = current_state;
+uint32_t get_encoder_overflow_count() {
+    return event_overflow_count;
 }
 
+direction_t get_direction() {
+    encoder_event_t event;
+    return drain_encoder_events(&event, 1) ? event.direction : STATIONARY;
+}
+
+static void decode_quadrature(uint8_t quadrature) {
+    static int8_t edges = 0;
+    static int8_t steps = 0;
+
+    int8_t edge = transitions[(previous_quadrature << 2) | quadrature];
+    previous_quadrature = quadrature;
+
+    if (edge == ILLEGAL) {
+        illegal_transition_count++;
+        return;
+    }
+    edges += edge;
+    if (!(rest_states & (1 << quadrature))) {
+        return;
+    }
+    // round to the nearest whole step, so a single lost edge does not lose a step
+    int8_t half_step = edges > 0 ? edges_per_step / 2 : -(edges_per_step / 2);
+    steps += (edges + half_step) / edges_per_step;
+    edges = 0;
+    if (steps >= steps_per_detent) {
+        steps -= steps_per_detent;
+        clockwise_count++;
+        post_step(CLOCKWISE);
+    } else if (steps <= -steps_per_detent) {
+        steps += steps_per_detent;
+        counterclockwise_count++;
+        post_step(COUNTERCLOCKWISE);
+    }
+}
 
+static void handle_quadrature_interrupt() {
+    decode_quadrature(get_quadrature());
+}
+
+static void handle_sampling_interrupt() {
+    uint8_t quadrature = get_quadrature();
+    uint8_t debounced = debounced_quadrature;
+    for (int wiper = 0; wiper < 2; wiper++) {
+        uint8_t level = (quadrature >> wiper) & 0x1;
+        uint8_t debounced_level = (debounced >> wiper) & 0x1;
+        if (level && integrators[wiper] < DEBOUNCE_INTEGRATOR_MAXIMUM) {
+            integrators[wiper]++;
+        } else if (!level && integrators[wiper] > 0) {
+            integrators[wiper]--;
+        }
+        uint8_t rail = integrators[wiper] == DEBOUNCE_INTEGRATOR_MAXIMUM ? 1 : integrators[wiper] == 0 ? 0 : 2;
+        if (rail == 2) {
+            excursions[wiper] = true;
+        } else if (rail != debounced_level) {
+            debounced ^= (uint8_t) (1 << wiper);
+            excursions[wiper] = false;
+        } else if (excursions[wiper]) {
+            glitch_count++;
+            excursions[wiper] = false;
+        }
+    }
+    if (debounced != debounced_quadrature) {
+        debounced_quadrature = debounced;
+        decode_quadrature(debounced);
+    }
+}
@@ -27,9 +27,54 @@ typedef enum {
     STATIONARY, CLOCKWISE, COUNTERCLOCKWISE
 } direction_t;
 
+/* The number of quadrature edges per decoded step. At 1x, one step per full
+ * quadrature cycle; at 4x, one step per edge. */
+typedef enum {
+    ENCODER_4X = 1, ENCODER_2X = 2, ENCODER_1X = 4
+} encoder_resolution_t;
+
+typedef struct {
+    uint32_t timestamp_us;
+    uint32_t velocity_q8;           // steps per second, with 8 fractional bits
+    direction_t direction;
+} encoder_event_t;
+
+/* A point on the acceleration curve: steps at or above the velocity advance
+ * the value by the multiplier. Points must be in order of increasing velocity. */
+typedef struct {
+    uint16_t minimum_steps_per_second;
+    uint8_t multiplier;
+} encoder_acceleration_point_t;
+
+/* How the wipers are read: by pin-change interrupts on every edge, or by
+ * sampling from a periodic timer interrupt with per-wiper debouncing */
+typedef enum {
+    ENCODER_INTERRUPT_DRIVEN, ENCODER_TIMER_SAMPLED
+} encoder_mode_t;
+
 void initialize_rotary_encoder();
+/* Reads the wipers from `gpio_input_register` instead of SIO's GPIO_IN register, such as a variable in a host test. */
+void rotary_encoder_use_registers(uint32_t const volatile *gpio_input_register);
+void set_encoder_mode(encoder_mode_t mode, uint32_t sample_period_us);
+uint32_t get_encoder_glitch_count();
+void set_encoder_resolution(encoder_resolution_t resolution, uint8_t steps_per_detent);
+uint32_t get_illegal_transition_count();
 uint8_t get_quadrature();
 char *count_rotations(char buffer[]);
+/* Changes whenever count_rotations() would report different counts. */
+uint32_t get_rotation_count_version();
 direction_t get_direction();
+size_t drain_encoder_events(encoder_event_t events[], size_t maximum_number_of_events);
+/* For consumers that do not use the events, so that the queue does not stay full; returns how many were queued. */
+size_t discard_encoder_events();
+uint32_t get_encoder_overflow_count();
+/* The callback, if not NULL, is called on each step, even if the queue was full and the step was lost. It is called
+ * from the ISR, or from the main context while steps are deferred. */
+void set_encoder_event_callback(void (*callback)(void));
+/* If true, the ISR posts each step to the work queue, and the event is built and queued when the work queue is
+ * drained; this keeps the velocity estimate out of the ISR. */
+void set_encoder_step_deferral(bool defer_to_work_queue);
+void set_encoder_acceleration(encoder_acceleration_point_t const curve[], size_t number_of_points);
+int get_accelerated_delta(encoder_event_t const *event);
 
 #endif //COMBOLOCK_ROTARY_ENCODER_H
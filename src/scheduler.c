@@ -0,0 +1,113 @@
+/**************************************************************************//**
+ *
+ * @file scheduler.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief scheduler.h
+ *
+ * @copydetails scheduler.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include "microsecond-timer.h"
+#include "scheduler.h"
+
+#if defined (__MBED__)
+#include <cmsis.h>
+#include <platform/mbed_critical.h>
+#define ENTER_CRITICAL_SECTION()    core_util_critical_section_enter()
+#define EXIT_CRITICAL_SECTION()     core_util_critical_section_exit()
+#define WAIT_FOR_INTERRUPT()        __WFI()
+#else
+#define ENTER_CRITICAL_SECTION()    ((void) 0)
+#define EXIT_CRITICAL_SECTION()     ((void) 0)
+#define WAIT_FOR_INTERRUPT()        ((void) 0)
+#endif //__MBED__
+
+struct task {
+    event_mask_t events;
+    void (*run)(event_mask_t events);
+    struct task_statistics statistics;
+};
+
+static struct task tasks[MAXIMUM_NUMBER_OF_TASKS];
+static int number_of_tasks = 0;
+static event_mask_t volatile pending_events = 0;
+static uint32_t idle_count = 0;
+
+int scheduler_add_task(char const *name, event_mask_t events, void (*run)(event_mask_t events)) {
+    if (number_of_tasks >= MAXIMUM_NUMBER_OF_TASKS) {
+        return -1;
+    }
+    tasks[number_of_tasks] = (struct task) {
+            .events = events,
+            .run = run,
+            .statistics = {.name = name, .runs = 0, .total_run_time_us = 0, .maximum_run_time_us = 0},
+    };
+    return number_of_tasks++;
+}
+
+void scheduler_post_event(event_mask_t events) {
+    ENTER_CRITICAL_SECTION();
+    pending_events |= events;
+    EXIT_CRITICAL_SECTION();
+}
+
+bool scheduler_run(void) {
+    ENTER_CRITICAL_SECTION();
+    event_mask_t events = pending_events;
+    pending_events = 0;
+    if (!events) {
+        // an interrupt that arrives after the check still ends the sleep, even with interrupts masked
+        WAIT_FOR_INTERRUPT();
+    }
+    EXIT_CRITICAL_SECTION();
+    if (!events) {
+        idle_count++;
+        return false;
+    }
+    for (int i = 0; i < number_of_tasks; i++) {
+        event_mask_t task_events = events & tasks[i].events;
+        if (task_events) {
+            uint32_t start_us = get_microseconds();
+            tasks[i].run(task_events);
+            uint32_t run_time_us = get_microseconds() - start_us;
+            tasks[i].statistics.runs++;
+            tasks[i].statistics.total_run_time_us += run_time_us;
+            if (run_time_us > tasks[i].statistics.maximum_run_time_us) {
+                tasks[i].statistics.maximum_run_time_us = run_time_us;
+            }
+        }
+    }
+    return true;
+}
+
+struct task_statistics scheduler_get_task_statistics(int task) {
+    if (task < 0 || task >= number_of_tasks) {
+        return (struct task_statistics) {.name = NULL, .runs = 0, .total_run_time_us = 0, .maximum_run_time_us = 0};
+    }
+    return tasks[task].statistics;
+}
+
+uint32_t scheduler_get_idle_count(void) {
+    return idle_count;
+}
+
+void print_scheduler_statistics(void) {
+    for (int i = 0; i < number_of_tasks; i++) {
+        struct task_statistics const *statistics = &tasks[i].statistics;
+        printf("%-8s %lu runs, mean %lu us, max %lu us\n", statistics->name, (unsigned long) statistics->runs,
+               (unsigned long) (statistics->runs ? statistics->total_run_time_us / statistics->runs : 0),
+               (unsigned long) statistics->maximum_run_time_us);
+    }
+    printf("idle     %lu\n", (unsigned long) idle_count);
+}
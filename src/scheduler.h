@@ -0,0 +1,105 @@
+/**************************************************************************//**
+ *
+ * @file scheduler.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief A run-to-completion task scheduler driven by events that ISRs post.
+ *
+ * Each task names the events it waits for. ISRs (and tasks) post events by
+ * setting bits in a pending-event mask; `scheduler_run()` takes every pending
+ * event at once and runs, in the order they were added, the tasks waiting for
+ * any of them. When no event is pending, the processor sleeps until the next
+ * interrupt, so an idle lock spends its time asleep rather than polling.
+ *
+ * Each task's run count and run times are recorded.
+ *
+ * The scheduler has no hardware dependencies other than sleeping, which is a
+ * no-op on a host computer, so a host program can post simulated events and
+ * call `scheduler_run()` to drive the same tasks.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_SCHEDULER_H
+#define COMBOLOCK_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAXIMUM_NUMBER_OF_TASKS (8)
+
+/* A set of events, one bit per event; the application assigns the bits. */
+typedef uint32_t event_mask_t;
+
+struct task_statistics {
+    char const *name;
+    uint32_t runs;
+    uint32_t total_run_time_us;
+    uint32_t maximum_run_time_us;
+};
+
+/**
+ * @brief Adds a task that runs whenever any of the specified events is
+ * pending. Tasks run in the order that they were added.
+ *
+ * @param name The task's name, for the statistics
+ * @param events The events that the task waits for
+ * @param run The task's body, which is passed the pending events that it
+ *      waits for; it must return rather than wait
+ * @return The task's number, or -1 if `MAXIMUM_NUMBER_OF_TASKS` tasks have
+ *      already been added
+ */
+int scheduler_add_task(char const *name, event_mask_t events, void (*run)(event_mask_t events));
+
+/**
+ * @brief Marks events as pending. Safe to call from ISRs and from tasks; a
+ * task that posts an event it waits for runs again on the next pass.
+ *
+ * @param events The events to be posted
+ */
+void scheduler_post_event(event_mask_t events);
+
+/**
+ * @brief Runs the tasks waiting for the pending events, or, if no event is
+ * pending, sleeps until an interrupt occurs. Call this repeatedly from the
+ * main loop.
+ *
+ * @return `true` if any task ran; `false` if the scheduler slept
+ */
+bool scheduler_run(void);
+
+/**
+ * @brief Reports a task's run count and run times.
+ *
+ * @param task The task's number
+ * @return The task's statistics; all zero if there is no such task
+ */
+struct task_statistics scheduler_get_task_statistics(int task);
+
+/**
+ * @brief Reports how many times the scheduler found nothing to do and slept.
+ *
+ * @return The number of idle passes
+ */
+uint32_t scheduler_get_idle_count(void);
+
+/**
+ * @brief Prints every task's statistics and the idle count.
+ */
+void print_scheduler_statistics(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_SCHEDULER_H
@@ -0,0 +1,197 @@
+/**************************************************************************//**
+ *
+ * @file servo-channels.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief servo-channels.h
+ *
+ * @copydetails servo-channels.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stddef.h>
+#include "servo-channels.h"
+
+#define NO_PIN (0xFF)
+
+struct channel {
+    uint8_t pin;                            // NO_PIN if the channel is not attached
+    uint32_t volatile pulse_width_us;
+};
+
+struct falling_edge {
+    uint32_t offset_us;                     // from the start of the period
+    uint32_t pin_mask;
+};
+
+static struct servo_alarm_clock const *alarm_clock = NULL;
+static uint32_t period_us = 0;
+static bool is_running = false;
+static struct channel channels[MAXIMUM_NUMBER_OF_SERVO_CHANNELS] = {
+        {.pin = NO_PIN, .pulse_width_us = 0}, {.pin = NO_PIN, .pulse_width_us = 0},
+        {.pin = NO_PIN, .pulse_width_us = 0}, {.pin = NO_PIN, .pulse_width_us = 0},
+        {.pin = NO_PIN, .pulse_width_us = 0}, {.pin = NO_PIN, .pulse_width_us = 0},
+        {.pin = NO_PIN, .pulse_width_us = 0}, {.pin = NO_PIN, .pulse_width_us = 0},
+};
+
+/* this period's falling edges, in order, built when the period starts */
+static struct falling_edge falling_edges[MAXIMUM_NUMBER_OF_SERVO_CHANNELS];
+static int number_of_falling_edges = 0;
+static int next_falling_edge = 0;
+static uint32_t period_start_us = 0;
+static uint32_t next_edge_us = 0;           // the deadline of the pending edge
+
+static uint32_t volatile edges = 0;
+static uint32_t volatile total_lateness_us = 0;
+static uint32_t volatile maximum_lateness_us = 0;
+
+static void handle_rising_edges(void);
+static void handle_falling_edge(void);
+
+static void record_lateness(uint32_t now_us) {
+    uint32_t lateness_us = now_us - next_edge_us;
+    if (lateness_us > period_us) {
+        lateness_us = 0;                    // the alarm fired early, which shows up as a huge unsigned lateness
+    }
+    edges++;
+    total_lateness_us += lateness_us;
+    if (lateness_us > maximum_lateness_us) {
+        maximum_lateness_us = lateness_us;
+    }
+}
+
+static void schedule_edge(uint32_t deadline_us, void (*isr)(void)) {
+    uint32_t now_us = alarm_clock->now_us();
+    next_edge_us = deadline_us;
+    int32_t delay_us = (int32_t) (deadline_us - now_us);
+    alarm_clock->set_alarm(delay_us > 0 ? (uint32_t) delay_us : 0, isr);
+}
+
+/* Latches the pulse widths and insertion-sorts them into this period's falling edges. */
+static uint32_t build_falling_edges(void) {
+    uint32_t rising_pins = 0;
+    number_of_falling_edges = 0;
+    for (int i = 0; i < MAXIMUM_NUMBER_OF_SERVO_CHANNELS; i++) {
+        uint32_t width_us = channels[i].pulse_width_us;
+        if (channels[i].pin == NO_PIN || width_us == 0) {
+            continue;
+        }
+        uint32_t pin_mask = 1UL << channels[i].pin;
+        rising_pins |= pin_mask;
+        int j = number_of_falling_edges;
+        while (j > 0 && falling_edges[j - 1].offset_us > width_us) {
+            j--;
+        }
+        if (j > 0 && falling_edges[j - 1].offset_us == width_us) {
+            falling_edges[j - 1].pin_mask |= pin_mask;
+        } else {
+            for (int k = number_of_falling_edges; k > j; k--) {
+                falling_edges[k] = falling_edges[k - 1];
+            }
+            falling_edges[j] = (struct falling_edge) {.offset_us = width_us, .pin_mask = pin_mask};
+            number_of_falling_edges++;
+        }
+    }
+    return rising_pins;
+}
+
+static void handle_rising_edges(void) {
+    record_lateness(alarm_clock->now_us());
+    period_start_us = next_edge_us;
+    uint32_t rising_pins = build_falling_edges();
+    next_falling_edge = 0;
+    if (number_of_falling_edges == 0) {
+        schedule_edge(period_start_us + period_us, handle_rising_edges);
+    } else {
+        alarm_clock->write_pins(rising_pins, true);
+        schedule_edge(period_start_us + falling_edges[0].offset_us, handle_falling_edge);
+    }
+}
+
+static void handle_falling_edge(void) {
+    record_lateness(alarm_clock->now_us());
+    alarm_clock->write_pins(falling_edges[next_falling_edge].pin_mask, false);
+    if (++next_falling_edge < number_of_falling_edges) {
+        schedule_edge(period_start_us + falling_edges[next_falling_edge].offset_us, handle_falling_edge);
+    } else {
+        schedule_edge(period_start_us + period_us, handle_rising_edges);
+    }
+}
+
+void servo_channels_initialize(struct servo_alarm_clock const *clock, uint32_t signal_period_us) {
+    alarm_clock = clock;
+    period_us = signal_period_us;
+    number_of_falling_edges = 0;
+    servo_channels_reset_jitter();
+    is_running = false;
+    servo_channels_start();
+}
+
+void servo_channels_start(void) {
+    if (alarm_clock && !is_running) {
+        is_running = true;
+        schedule_edge(alarm_clock->now_us(), handle_rising_edges);
+    }
+}
+
+void servo_channels_stop(void) {
+    if (alarm_clock) {
+        alarm_clock->cancel_alarm();
+        is_running = false;
+        uint32_t pins = 0;
+        for (int i = 0; i < MAXIMUM_NUMBER_OF_SERVO_CHANNELS; i++) {
+            if (channels[i].pin != NO_PIN) {
+                pins |= 1UL << channels[i].pin;
+            }
+        }
+        alarm_clock->write_pins(pins, false);
+    }
+}
+
+servo_channel_t servo_channel_attach(uint8_t pin) {
+    for (int i = 0; i < MAXIMUM_NUMBER_OF_SERVO_CHANNELS; i++) {
+        if (channels[i].pin == NO_PIN) {
+            channels[i].pulse_width_us = 0;
+            channels[i].pin = pin;
+            return (servo_channel_t) i;
+        }
+    }
+    return -1;
+}
+
+void servo_channel_detach(servo_channel_t channel) {
+    if (channel < 0 || channel >= MAXIMUM_NUMBER_OF_SERVO_CHANNELS) {
+        return;
+    }
+    channels[channel].pulse_width_us = 0;
+    channels[channel].pin = NO_PIN;
+}
+
+void servo_channel_set_pulse_width(servo_channel_t channel, uint32_t width_us) {
+    if (channel < 0 || channel >= MAXIMUM_NUMBER_OF_SERVO_CHANNELS) {
+        return;
+    }
+    channels[channel].pulse_width_us = (width_us < period_us) ? width_us : period_us - 1;
+}
+
+struct servo_edge_jitter servo_channels_get_jitter(void) {
+    uint32_t number_of_edges = edges;
+    return (struct servo_edge_jitter) {
+            .edges = number_of_edges,
+            .mean_lateness_us = number_of_edges ? total_lateness_us / number_of_edges : 0,
+            .maximum_lateness_us = maximum_lateness_us,
+    };
+}
+
+void servo_channels_reset_jitter(void) {
+    edges = 0;
+    total_lateness_us = 0;
+    maximum_lateness_us = 0;
+}
@@ -0,0 +1,124 @@
+/**************************************************************************//**
+ *
+ * @file servo-channels.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Generates the control signals for several servomotors from one
+ *      one-shot alarm.
+ *
+ * Every channel's pulse begins at the start of the signal period, when all of
+ * the channels' pins are raised together. At that point the channels' pulse
+ * widths are latched and sorted, and channels whose pulses end at the same
+ * time are merged into one falling edge. The alarm then visits the falling
+ * edges in order, so a period costs one interrupt for the rising edge plus
+ * one per distinct pulse width. Deadlines are computed from the start of the
+ * period, not from when an interrupt ran, so interrupt latency does not
+ * accumulate into the signal period.
+ *
+ * The module reaches the hardware only through a `struct servo_alarm_clock`,
+ * so it runs unchanged on a host computer against a simulated alarm clock.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_SERVO_CHANNELS_H
+#define COMBOLOCK_SERVO_CHANNELS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAXIMUM_NUMBER_OF_SERVO_CHANNELS (8)
+
+/* A handle for one servomotor's channel; negative values are not valid handles. */
+typedef int8_t servo_channel_t;
+
+/* The clock and pins that the channels run against. */
+struct servo_alarm_clock {
+    uint32_t (*now_us)(void);                                   // a free-running microsecond counter
+    void (*set_alarm)(uint32_t delay_us, void (*isr)(void));    // a one-shot alarm `delay_us` from now
+    void (*cancel_alarm)(void);
+    void (*write_pins)(uint32_t pin_mask, bool level);          // sets every pin in the mask to the level
+};
+
+/* How late the edges were, measured when each edge's interrupt began. */
+struct servo_edge_jitter {
+    uint32_t edges;
+    uint32_t mean_lateness_us;
+    uint32_t maximum_lateness_us;
+};
+
+/**
+ * @brief Starts the signal period. Channels produce no pulses until they are
+ * attached and given a pulse width.
+ *
+ * @param clock The alarm clock that schedules the edges; it must outlive the
+ *      signals
+ * @param period_us The signal period shared by all channels
+ */
+void servo_channels_initialize(struct servo_alarm_clock const *clock, uint32_t period_us);
+
+/**
+ * @brief Stops all channels' signals and leaves their pins low. No interrupts
+ * occur until the signals are restarted.
+ */
+void servo_channels_stop(void);
+
+/**
+ * @brief Restarts the signals after `servo_channels_stop()`, beginning a new
+ * period immediately. Does nothing if the signals are already running.
+ */
+void servo_channels_start(void);
+
+/**
+ * @brief Assigns a pin to a new channel, with a pulse width of 0 (the pin
+ * stays low).
+ *
+ * @param pin The GPIO pin that carries the channel's signal
+ * @return The channel's handle, or -1 if all channels are in use
+ */
+servo_channel_t servo_channel_attach(uint8_t pin);
+
+/**
+ * @brief Releases a channel. Its pin is left low after the current period.
+ *
+ * @param channel The channel to be released
+ */
+void servo_channel_detach(servo_channel_t channel);
+
+/**
+ * @brief Sets the width of a channel's pulses, starting with the next period.
+ *
+ * @param channel The channel whose pulse width is to be set
+ * @param pulse_width_us The pulse width, which is clamped to 1 µs less than
+ *      the signal period
+ */
+void servo_channel_set_pulse_width(servo_channel_t channel, uint32_t pulse_width_us);
+
+/**
+ * @brief Reports the edges' lateness since the signals started or since the
+ * last call to `servo_channels_reset_jitter()`.
+ *
+ * @return The edge jitter statistics
+ */
+struct servo_edge_jitter servo_channels_get_jitter(void);
+
+/**
+ * @brief Zeroes the edge jitter statistics.
+ */
+void servo_channels_reset_jitter(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_SERVO_CHANNELS_H
@@ -0,0 +1,166 @@
+/**************************************************************************//**
+ *
+ * @file servo-motion.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief servo-motion.h
+ *
+ * @copydetails servo-motion.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stddef.h>
+#include "servo-motion.h"
+
+#define FRACTION_BITS   (16)
+#define ONE             (1L << FRACTION_BITS)
+
+static void (*write_pulse_width)(uint32_t pulse_width_us) = NULL;
+static void (*write_enable)(bool enable) = NULL;
+static uint32_t frame_us = 0;                   // 0 until servo_motion_initialize() supplies the frame period
+
+/* the limits as requested, in microseconds of pulse width per second (or per second squared) */
+static uint32_t requested_maximum_speed = 0;
+static uint32_t requested_acceleration = 0;
+static uint32_t requested_hold_time_us = 0;
+
+/* position, velocity, and acceleration are 16.16 fixed-point, per frame */
+static int32_t position = 0;
+static int32_t velocity = 0;
+static int32_t maximum_speed = 0;
+static int32_t acceleration = 0;
+static uint32_t hold_frames = 0;
+
+static int32_t volatile target = 0;
+static void (*volatile completion_callback)(void) = NULL;
+static bool volatile is_settled = true;
+static bool volatile is_quiescent = false;
+static uint32_t hold_frames_remaining = 0;
+
+static inline uint32_t rounded_pulse_width(int32_t fixed_point_position) {
+    return (uint32_t) ((fixed_point_position + ONE / 2) >> FRACTION_BITS);
+}
+
+/* Converts the requested limits to per-frame units; does nothing until the frame period is known. */
+static void convert_limits(void) {
+    if (!frame_us) {
+        return;
+    }
+    maximum_speed = (int32_t) (((uint64_t) requested_maximum_speed * frame_us << FRACTION_BITS) / 1000000);
+    acceleration = (int32_t) (((uint64_t) requested_acceleration * frame_us * frame_us << FRACTION_BITS)
+                              / 1000000000000ULL);
+    if (requested_acceleration && !acceleration) {
+        acceleration = 1;                   // too gentle to represent, but still not an instant move
+    }
+    hold_frames = (requested_hold_time_us + frame_us - 1) / frame_us;
+}
+
+void servo_motion_initialize(void (*set_pulse_width)(uint32_t pulse_width_us),
+                             void (*enable_pulses)(bool enable),
+                             uint32_t frame_period_us, uint32_t pulse_width_us) {
+    write_pulse_width = set_pulse_width;
+    write_enable = enable_pulses;
+    frame_us = frame_period_us;
+    convert_limits();
+    position = (int32_t) pulse_width_us << FRACTION_BITS;
+    target = position;
+    velocity = 0;
+    completion_callback = NULL;
+    is_settled = true;
+    is_quiescent = false;
+    hold_frames_remaining = hold_frames;
+    write_pulse_width(pulse_width_us);
+    write_enable(true);
+}
+
+void servo_motion_set_limits(uint32_t maximum_speed_us_per_s, uint32_t acceleration_us_per_s2, uint32_t hold_time_us) {
+    requested_maximum_speed = maximum_speed_us_per_s;
+    requested_acceleration = acceleration_us_per_s2;
+    requested_hold_time_us = hold_time_us;
+    convert_limits();
+}
+
+void servo_motion_move_to(uint32_t target_us, void (*on_complete)(void)) {
+    int32_t new_target = (int32_t) target_us << FRACTION_BITS;
+    if (new_target == target) {
+        return;
+    }
+    completion_callback = on_complete;
+    target = new_target;
+    is_settled = false;
+    if (is_quiescent) {
+        write_pulse_width(rounded_pulse_width(position));
+        write_enable(true);
+        is_quiescent = false;
+    }
+}
+
+/* Returns the speed for this frame, ramping up to the maximum or down in time to stop at the target. */
+static int32_t next_speed(int32_t speed, int32_t distance) {
+    int64_t stopping_distance = ((int64_t) speed * speed) / (2 * acceleration);
+    if (stopping_distance >= distance) {
+        speed -= acceleration;
+    } else if (speed < maximum_speed) {
+        speed += acceleration;
+        if (speed > maximum_speed) {
+            speed = maximum_speed;
+        }
+    }
+    return speed < acceleration ? acceleration : speed;     // never stall short of the target
+}
+
+bool servo_motion_step(void) {
+    if (is_quiescent) {
+        return false;
+    }
+    if (is_settled) {
+        if (hold_frames_remaining) {
+            hold_frames_remaining--;
+        } else {
+            write_enable(false);
+            is_quiescent = true;
+        }
+        return !is_quiescent;
+    }
+    int32_t error = target - position;
+    bool moving_away = (velocity > 0 && error < 0) || (velocity < 0 && error > 0);
+    if (moving_away) {
+        // the target moved behind us; slow to a stop before turning around
+        int32_t speed = (velocity > 0 ? velocity : -velocity) - acceleration;
+        speed = speed > 0 ? speed : 0;
+        velocity = velocity > 0 ? speed : -speed;
+    } else {
+        int32_t distance = error > 0 ? error : -error;
+        int32_t speed = acceleration ? next_speed(velocity > 0 ? velocity : -velocity, distance) : distance;
+        if (speed >= distance) {
+            position = target;
+            velocity = 0;
+            is_settled = true;
+            hold_frames_remaining = hold_frames;
+            write_pulse_width(rounded_pulse_width(position));
+            if (completion_callback) {
+                completion_callback();
+            }
+            return true;
+        }
+        velocity = error > 0 ? speed : -speed;
+    }
+    position += velocity;
+    write_pulse_width(rounded_pulse_width(position));
+    return true;
+}
+
+bool servo_motion_is_settled(void) {
+    return is_settled;
+}
+
+bool servo_motion_is_quiescent(void) {
+    return is_quiescent;
+}
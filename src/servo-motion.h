@@ -0,0 +1,108 @@
+/**************************************************************************//**
+ *
+ * @file servo-motion.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Moves a servomotor along a trapezoidal velocity profile and turns its
+ *      signal off once it has held its position.
+ *
+ * The planner is stepped once per signal period. Each step accelerates the
+ * pulse width toward its target, cruises at the maximum speed, and
+ * decelerates so as to arrive without overshoot; all arithmetic is 16.16
+ * fixed-point. When the pulse width reaches the target, the completion
+ * callback is called. After the hold time, the planner disables the servo
+ * signal so that neither the servo nor the CPU does any work until the next
+ * move.
+ *
+ * The planner reaches the servo only through the functions passed to
+ * `servo_motion_initialize()`, so it is independent of the signal backend.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_SERVO_MOTION_H
+#define COMBOLOCK_SERVO_MOTION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Places the servo at the specified pulse width, with its signal
+ * enabled, and no motion in progress.
+ *
+ * @param set_pulse_width A function that sets the servo's pulse width
+ * @param enable_pulses A function that turns the servo's signal on or off
+ * @param frame_period_us The time between calls to `servo_motion_step()`,
+ *      normally the signal period; the motion limits are converted to this
+ *      period, so it must not be 0
+ * @param pulse_width_us The initial pulse width
+ */
+void servo_motion_initialize(void (*set_pulse_width)(uint32_t pulse_width_us),
+                             void (*enable_pulses)(bool enable),
+                             uint32_t frame_period_us, uint32_t pulse_width_us);
+
+/**
+ * @brief Sets the motion limits for subsequent steps. The limits may be set
+ * before `servo_motion_initialize()`; they take effect once the frame period
+ * is known.
+ *
+ * @param maximum_speed_us_per_s The fastest that the pulse width may change,
+ *      in microseconds of pulse width per second
+ * @param acceleration_us_per_s2 How quickly the speed may change, in
+ *      microseconds of pulse width per second per second; 0 moves directly to
+ *      the target in one step
+ * @param hold_time_us How long the signal is kept on after the target is
+ *      reached
+ */
+void servo_motion_set_limits(uint32_t maximum_speed_us_per_s, uint32_t acceleration_us_per_s2, uint32_t hold_time_us);
+
+/**
+ * @brief Starts a move to a new pulse width, re-enabling the signal if it had
+ * been turned off. A move to the current target does nothing, so this may be
+ * called repeatedly with the same target.
+ *
+ * @param target_us The pulse width to move to
+ * @param on_complete A function to be called when the target is reached, or
+ *      `NULL` for none; it is called from `servo_motion_step()`
+ */
+void servo_motion_move_to(uint32_t target_us, void (*on_complete)(void));
+
+/**
+ * @brief Advances the motion by one frame. Call this once per frame period,
+ * typically from a timer interrupt.
+ *
+ * @return `true` if the servo is moving or holding; `false` once the signal
+ *      has been turned off, after which steps do nothing until the next move
+ */
+bool servo_motion_step(void);
+
+/**
+ * @brief Reports whether the servo has reached its target.
+ *
+ * @return `true` if no motion is in progress; `false` otherwise
+ */
+bool servo_motion_is_settled(void);
+
+/**
+ * @brief Reports whether the servo's signal has been turned off.
+ *
+ * @return `true` if the hold time has passed since the target was reached;
+ *      `false` otherwise
+ */
+bool servo_motion_is_quiescent(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_SERVO_MOTION_H
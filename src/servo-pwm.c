@@ -0,0 +1,67 @@
+/**************************************************************************//**
+ *
+ * @file servo-pwm.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief servo-pwm.h
+ *
+ * @copydetails servo-pwm.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include "servo-pwm.h"
+
+#define PWM_BASE                (0x40050000)
+#define IO_BANK0_BASE           (0x40014000)
+#define GPIO_FUNCTION_PWM       (4)
+#define GPIO_FUNCTION_MASK      (0x1F)
+#define SYSTEM_CLOCK_MHz        (125)
+#define PWM_ENABLE              (1 << 0)
+
+static struct rp2040_pwm_slice volatile *pwm_slices = (struct rp2040_pwm_slice *) (PWM_BASE);
+static struct rp2040_gpio_control volatile *gpio_controls = (struct rp2040_gpio_control *) (IO_BANK0_BASE);
+
+static struct rp2040_pwm_slice volatile *slice = 0;
+static uint8_t channel = 0;
+static uint32_t period_us = 0;
+static uint32_t pulse_width_us = 0;
+
+void servo_pwm_use_registers(struct rp2040_pwm_slice volatile *pwm_slice_registers,
+                             struct rp2040_gpio_control volatile *gpio_control_registers) {
+    pwm_slices = pwm_slice_registers;
+    gpio_controls = gpio_control_registers;
+}
+
+void servo_pwm_initialize(uint8_t pin, uint32_t signal_period_us) {
+    slice = pwm_slices + ((pin >> 1) & 0x7);
+    channel = pin & 0x1;
+    period_us = signal_period_us;
+    pulse_width_us = 0;
+    slice->control_and_status = 0;                      // stop the slice while configuring it
+    slice->divider = SYSTEM_CLOCK_MHz << 4;             // integer part in bits 11:4
+    slice->top = period_us - 1;
+    slice->compare = 0;
+    slice->counter = 0;
+    gpio_controls[pin].control = (gpio_controls[pin].control & ~GPIO_FUNCTION_MASK) | GPIO_FUNCTION_PWM;
+    slice->control_and_status = PWM_ENABLE;
+}
+
+void servo_pwm_set_pulse_width(uint32_t requested_pulse_width_us) {
+    pulse_width_us = (requested_pulse_width_us < period_us) ? requested_pulse_width_us : period_us;
+    if (!slice) {
+        return;
+    }
+    uint32_t shift = channel ? 16 : 0;
+    slice->compare = (slice->compare & ~(0xFFFFu << shift)) | (pulse_width_us << shift);
+}
+
+uint32_t servo_pwm_get_pulse_width(void) {
+    return pulse_width_us;
+}
@@ -0,0 +1,91 @@
+/**************************************************************************//**
+ *
+ * @file servo-pwm.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Generates a servo control signal with an RP2040 PWM slice.
+ *
+ * The PWM counter is clocked at 1 MHz, so the pulse width and the signal
+ * period are both set with 1 µs resolution, and once the slice is running the
+ * signal costs no CPU time at all. The compare value is double-buffered by the
+ * hardware and takes effect at the start of the next period, so changing the
+ * pulse width never produces a runt or a stretched pulse.
+ *
+ * The register blocks are reached through pointers that default to the
+ * RP2040's addresses. A host program can call `servo_pwm_use_registers()` with
+ * ordinary structs to observe what the module writes.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_SERVO_PWM_H
+#define COMBOLOCK_SERVO_PWM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* One PWM slice's registers; the RP2040 has eight slices, 0x14 bytes apart. */
+struct rp2040_pwm_slice {
+    uint32_t control_and_status;    // CSR: bit 0 enables the slice
+    uint32_t divider;               // DIV: 8.4 fixed-point clock divider
+    uint32_t counter;               // CTR
+    uint32_t compare;               // CC: channel A in bits 15:0, channel B in bits 31:16
+    uint32_t top;                   // TOP: the counter wraps after reaching this value
+};
+
+/* One GPIO's status and control registers in IO_BANK0. */
+struct rp2040_gpio_control {
+    uint32_t status;
+    uint32_t control;               // bits 4:0 select the pin's function
+};
+
+/**
+ * @brief Redirects the module's register accesses, such as to structs in
+ * ordinary memory on a host computer.
+ *
+ * @param pwm_slices An array of eight PWM slices
+ * @param gpio_controls An array of 30 GPIO status and control register pairs
+ */
+void servo_pwm_use_registers(struct rp2040_pwm_slice volatile *pwm_slices,
+                             struct rp2040_gpio_control volatile *gpio_controls);
+
+/**
+ * @brief Routes a pin to its PWM slice and starts a signal with the specified
+ * period and a pulse width of 0 (the pin stays low).
+ *
+ * The slice's clock is divided down to 1 MHz from the 125 MHz system clock.
+ *
+ * @param pin The GPIO pin that carries the servo signal
+ * @param period_us The signal period, at most 65536 µs
+ */
+void servo_pwm_initialize(uint8_t pin, uint32_t period_us);
+
+/**
+ * @brief Sets the width of the pulses that begin each period, starting with
+ * the next period.
+ *
+ * @param pulse_width_us The pulse width, which is clamped to the signal period
+ */
+void servo_pwm_set_pulse_width(uint32_t pulse_width_us);
+
+/**
+ * @brief Reports the pulse width most recently set.
+ *
+ * @return The pulse width in microseconds
+ */
+uint32_t servo_pwm_get_pulse_width(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_SERVO_PWM_H
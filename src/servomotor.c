@@ -7,6 +7,21 @@
  *
  * @brief Code to control a servomotor.
  *
+ * Two backends generate the servo signal, selected at compile time with
+ * `SERVO_BACKEND`:
+ * <ul>
+ * <li> `SERVO_BACKEND_HARDWARE_PWM` (the default on the RP2040) drives the
+ *      pin from a PWM slice with 1 µs resolution and no interrupts.
+ * <li> `SERVO_BACKEND_EDGE_ALARM` sets the pin from a one-shot alarm shared
+ *      by all servo channels, two interrupts per signal period for a single
+ *      servo, with 1 µs resolution.
+ * <li> `SERVO_BACKEND_TIMER_ISR` bit-bangs the pin from a periodic timer
+ *      interrupt every `PULSE_INCREMENT_uS`.
+ * </ul>
+ *
+ * Whatever the backend, the servo moves along the velocity profile planned by
+ * servo-motion.c, and its signal is turned off once it has held its position.
+ *
  ******************************************************************************/
 
 /*
@@ -17,20 +32,153 @@
 #include <CowPi.h>
 #include "servomotor.h"
 #include "interrupt_support.h"
+#include "microsecond-timer.h"
+#include "servo-channels.h"
+#include "servo-motion.h"
+#include "servo-pwm.h"
+
+#define SERVO_BACKEND_TIMER_ISR     (0)
+#define SERVO_BACKEND_HARDWARE_PWM  (1)
+#define SERVO_BACKEND_EDGE_ALARM    (2)
+
+#ifndef SERVO_BACKEND
+#if defined (ARDUINO_ARCH_RP2040)
+#define SERVO_BACKEND SERVO_BACKEND_HARDWARE_PWM
+#else
+#define SERVO_BACKEND SERVO_BACKEND_TIMER_ISR
+#endif
+#endif //SERVO_BACKEND
+
+#if SERVO_BACKEND == SERVO_BACKEND_EDGE_ALARM && !defined (__MBED__)
+#error "SERVO_BACKEND_EDGE_ALARM requires the one-shot alarms that are available only on MBED"
+#endif
 
 #define SERVO_PIN           (22)
 #define PULSE_INCREMENT_uS  (500)
 #define SIGNAL_PERIOD_uS    (20000)
 
-static int volatile pulse_width_us;
+#define SERVO_ALARM         (0)
+#define MOTION_TIMER        (2)     // timer 0 drives the bit-banged servo; timer 1 samples the encoder
+
+#define DEFAULT_MAXIMUM_SPEED_uS_PER_S      (8000)
+#define DEFAULT_ACCELERATION_uS_PER_S2      (32000)
+#define DEFAULT_HOLD_TIME_uS                (500000)
+
+#if SERVO_BACKEND == SERVO_BACKEND_TIMER_ISR || SERVO_BACKEND == SERVO_BACKEND_EDGE_ALARM
 volatile cowpi_ioport_t* ioport = (cowpi_ioport_t *) (0xD0000000);
+#endif
+
+static void (*settled_callback)(void) = NULL;
+
+#if SERVO_BACKEND == SERVO_BACKEND_TIMER_ISR
+static int volatile pulse_width_us;
 
 static void handle_timer_interrupt();
+#endif
+
+#if SERVO_BACKEND == SERVO_BACKEND_EDGE_ALARM
+static void set_servo_alarm(uint32_t delay_us, void (*isr)(void)) {
+    register_alarm_ISR(SERVO_ALARM, delay_us, isr);
+}
+
+static void cancel_servo_alarm(void) {
+    cancel_alarm(SERVO_ALARM);
+}
+
+static void write_servo_pins(uint32_t pin_mask, bool level) {
+    if (level) {
+        ioport->output |= pin_mask;
+    } else {
+        ioport->output &= ~pin_mask;
+    }
+}
+
+static struct servo_alarm_clock const servo_clock = {
+        .now_us = get_microseconds,
+        .set_alarm = set_servo_alarm,
+        .cancel_alarm = cancel_servo_alarm,
+        .write_pins = write_servo_pins,
+};
+
+static servo_channel_t servo_channel = -1;
+#endif
+
+static bool volatile motion_timer_is_running = false;
+
+static void set_pulse_width(uint32_t width_us) {
+#if SERVO_BACKEND == SERVO_BACKEND_HARDWARE_PWM
+    servo_pwm_set_pulse_width(width_us);
+#elif SERVO_BACKEND == SERVO_BACKEND_EDGE_ALARM
+    servo_channel_set_pulse_width(servo_channel, width_us);
+#else
+    pulse_width_us = (int) width_us;
+#endif
+}
+
+static void enable_pulses(bool enable) {
+#if SERVO_BACKEND == SERVO_BACKEND_HARDWARE_PWM
+    if (!enable) {
+        servo_pwm_set_pulse_width(0);       // the slice keeps running, but costs nothing and holds the pin low
+    }
+#elif SERVO_BACKEND == SERVO_BACKEND_EDGE_ALARM
+    if (enable) {
+        servo_channels_start();
+    } else {
+        servo_channels_stop();
+    }
+#else
+    if (enable) {
+        reset_periodic_timer(0);
+    } else {
+        stop_periodic_timer(0);
+        ioport->output &= ~(1 << SERVO_PIN);
+    }
+#endif
+}
+
+static void handle_motion_timer_interrupt(void) {
+    if (!servo_motion_step()) {
+        stop_periodic_timer(MOTION_TIMER);
+        motion_timer_is_running = false;
+        if (!servo_motion_is_quiescent()) {
+            // a move began after the step that finished the hold
+            motion_timer_is_running = true;
+            reset_periodic_timer(MOTION_TIMER);
+        }
+    }
+}
+
+static void move_servo_to(uint32_t width_us) {
+    servo_motion_move_to(width_us, settled_callback);
+    if (!motion_timer_is_running) {
+        motion_timer_is_running = true;
+        register_periodic_timer_ISR(MOTION_TIMER, SIGNAL_PERIOD_uS, handle_motion_timer_interrupt);
+    }
+}
 
 void initialize_servo() {
+#if SERVO_BACKEND == SERVO_BACKEND_HARDWARE_PWM
+    servo_pwm_initialize(SERVO_PIN, SIGNAL_PERIOD_uS);
+#elif SERVO_BACKEND == SERVO_BACKEND_EDGE_ALARM
+    cowpi_set_output_pins(1 << SERVO_PIN);
+    servo_channels_initialize(&servo_clock, SIGNAL_PERIOD_uS);
+    servo_channel = servo_channel_attach(SERVO_PIN);
+#else
     cowpi_set_output_pins(1 << SERVO_PIN);
-    center_servo();
     register_periodic_timer_ISR(0, PULSE_INCREMENT_uS, handle_timer_interrupt);
+#endif
+    servo_motion_set_limits(DEFAULT_MAXIMUM_SPEED_uS_PER_S, DEFAULT_ACCELERATION_uS_PER_S2, DEFAULT_HOLD_TIME_uS);
+    servo_motion_initialize(set_pulse_width, enable_pulses, SIGNAL_PERIOD_uS, 1500);
+    motion_timer_is_running = true;         // run out the hold time at the center position
+    register_periodic_timer_ISR(MOTION_TIMER, SIGNAL_PERIOD_uS, handle_motion_timer_interrupt);
+}
+
+void configure_servo_motion(uint32_t maximum_speed_us_per_s, uint32_t acceleration_us_per_s2, uint32_t hold_time_us) {
+    servo_motion_set_limits(maximum_speed_us_per_s, acceleration_us_per_s2, hold_time_us);
+}
+
+void set_servo_settled_callback(void (*callback)(void)) {
+    settled_callback = callback;
 }
 
 char *test_servo(char *buffer) {
@@ -50,17 +198,18 @@ char *test_servo(char *buffer) {
 }
 
 void center_servo() {
-    pulse_width_us = 1500;
+    move_servo_to(1500);
 }
 
 void rotate_full_clockwise() {
-    pulse_width_us = 500;
+    move_servo_to(500);
 }
 
 void rotate_full_counterclockwise() {
-    pulse_width_us = 2500;
+    move_servo_to(2500);
 }
 
+#if SERVO_BACKEND == SERVO_BACKEND_TIMER_ISR
 static void handle_timer_interrupt() {
     static int rising_edge = 0;
     static int falling_edge = 0;
@@ -79,7 +228,5 @@ static void handle_timer_interrupt() {
     if (falling_edge == 0) {
         ioport->output &= ~(1<<SERVO_PIN);
     }
-
 }
-
-
+#endif //SERVO_BACKEND_TIMER_ISR
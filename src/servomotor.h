@@ -22,10 +22,22 @@
 #ifndef COMBOLOCK_SERVOMOTOR_H
 #define COMBOLOCK_SERVOMOTOR_H
 
+#include <stdint.h>
+
 void initialize_servo();
 void center_servo();
 void rotate_full_clockwise();
 void rotate_full_counterclockwise();
 char *test_servo(char buffer[]);
 
+/* The servo moves to each new position at no more than `maximum_speed_us_per_s`
+ * (in microseconds of pulse width per second), ramping its speed up and down at
+ * `acceleration_us_per_s2`, or immediately if the acceleration is 0. Its signal
+ * is turned off `hold_time_us` after it arrives. */
+void configure_servo_motion(uint32_t maximum_speed_us_per_s, uint32_t acceleration_us_per_s2, uint32_t hold_time_us);
+
+/* The callback, if not NULL, is called from an interrupt each time the servo
+ * reaches the position most recently requested. */
+void set_servo_settled_callback(void (*callback)(void));
+
 #endif //COMBOLOCK_SERVOMOTOR_H
@@ -0,0 +1,279 @@
+/**************************************************************************//**
+ *
+ * @file timer-wheel.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief timer-wheel.h
+ *
+ * @copydetails timer-wheel.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stddef.h>
+#include "timer-wheel.h"
+
+#if defined (__MBED__)
+#include <platform/mbed_critical.h>
+#define ENTER_CRITICAL_SECTION()    core_util_critical_section_enter()
+#define EXIT_CRITICAL_SECTION()     core_util_critical_section_exit()
+#else
+#define ENTER_CRITICAL_SECTION()    ((void) 0)
+#define EXIT_CRITICAL_SECTION()     ((void) 0)
+#endif //__MBED__
+
+#define SLOT_BITS           (6)
+#define SLOTS_PER_WHEEL     (1 << SLOT_BITS)
+#define SLOT_MASK           (SLOTS_PER_WHEEL - 1)
+#define NUMBER_OF_WHEELS    ((32 + SLOT_BITS - 1) / SLOT_BITS)
+
+#define MAXIMUM_ALARM_us    (0x40000000UL)     // longer waits are broken into several alarms
+
+/* Each slot is a circular list whose head is a sentinel timer. */
+static struct software_timer slots[NUMBER_OF_WHEELS][SLOTS_PER_WHEEL];
+static uint32_t volatile now = 0;
+static uint32_t tick_us = TIMER_WHEEL_TICK_us;
+static struct timer_wheel_clock const *wheel_clock = NULL;
+static uint32_t tick_start_us = 0;                  // when tick `now` began, if the wheel has a clock
+static bool is_catching_up = false;                 // callbacks see the tick being expired, not the clock
+static uint32_t number_of_armed_timers = 0;
+static bool is_alarm_set = false;
+static uint32_t alarm_tick = 0;                     // never after the next tick that has something to do
+
+static void handle_alarm(void);
+
+static inline uint32_t ticks_for(uint32_t time_us) {
+    return (time_us + tick_us - 1) / tick_us;
+}
+
+static inline void unlink_timer(struct software_timer *timer) {
+    timer->previous->next = timer->next;
+    timer->next->previous = timer->previous;
+    timer->next = NULL;
+    timer->previous = NULL;
+}
+
+/* Places the timer in the innermost wheel whose span covers its expiration, and returns the tick on which its slot
+ * is next visited: its expiration in the innermost wheel, or the slot's cascade in an outer wheel. */
+static uint32_t insert_timer(struct software_timer *timer) {
+    uint32_t ticks_remaining = timer->expiration_tick - now;
+    unsigned int wheel = 0;
+    while (wheel < NUMBER_OF_WHEELS - 1 && ticks_remaining >= (1UL << (SLOT_BITS * (wheel + 1)))) {
+        wheel++;
+    }
+    struct software_timer *head = &slots[wheel][(timer->expiration_tick >> (SLOT_BITS * wheel)) & SLOT_MASK];
+    timer->next = head;
+    timer->previous = head->previous;
+    head->previous->next = timer;
+    head->previous = timer;
+    unsigned int shift = SLOT_BITS * wheel;
+    return (timer->expiration_tick >> shift) << shift;
+}
+
+/* Redistributes one slot of an outer wheel among the wheels inside it. */
+static void cascade(unsigned int wheel) {
+    struct software_timer *head = &slots[wheel][(now >> (SLOT_BITS * wheel)) & SLOT_MASK];
+    while (head->next != head) {
+        struct software_timer *timer = head->next;
+        unlink_timer(timer);
+        insert_timer(timer);
+    }
+}
+
+/* Reports how many ticks from now the next timer expires or the next non-empty outer slot cascades, or 0 if no
+ * timer is armed. Nothing happens on the ticks before then, so they may be skipped. */
+static uint32_t ticks_until_next_event(void) {
+    uint32_t soonest = 0;
+    for (unsigned int wheel = 0; wheel < NUMBER_OF_WHEELS; wheel++) {
+        unsigned int shift = SLOT_BITS * wheel;
+        for (uint32_t turns = 1; turns <= SLOTS_PER_WHEEL; turns++) {
+            uint32_t slot_time = (now >> shift) + turns;
+            struct software_timer const *head = &slots[wheel][slot_time & SLOT_MASK];
+            if (head->next != head) {
+                uint32_t ticks = (slot_time << shift) - now;    // a cascade happens when the lower wheels are at 0
+                if (ticks && (!soonest || ticks < soonest)) {
+                    soonest = ticks;
+                }
+                break;
+            }
+        }
+    }
+    return soonest;
+}
+
+/* Expires the current tick's timers, after cascading any outer wheels that turned over. */
+static void process_tick(void) {
+    for (unsigned int wheel = 1; wheel < NUMBER_OF_WHEELS; wheel++) {
+        if (now & ((1UL << (SLOT_BITS * wheel)) - 1)) {
+            break;                                  // this wheel and those outside it have not turned over
+        }
+        cascade(wheel);
+    }
+    struct software_timer *head = &slots[0][now & SLOT_MASK];
+    while (head->next != head) {
+        struct software_timer *timer = head->next;
+        unlink_timer(timer);
+        if (timer->period_ticks) {
+            timer->expiration_tick += timer->period_ticks;
+            insert_timer(timer);
+        } else {
+            number_of_armed_timers--;
+        }
+        timer->callback(timer->context);
+    }
+}
+
+static inline void skip_ticks(uint32_t ticks) {
+    now += ticks;
+    tick_start_us += ticks * tick_us;
+}
+
+/* Brings the tick count up to the clock, expiring the timers that came due. Does nothing when called from a
+ * callback, which is already on the tick being expired. */
+static void catch_up(void) {
+    if (is_catching_up) {
+        return;
+    }
+    is_catching_up = true;
+    uint32_t elapsed;
+    while ((elapsed = (wheel_clock->now_us() - tick_start_us) / tick_us)) {
+        uint32_t ticks = ticks_until_next_event();
+        if (!ticks || ticks > elapsed) {
+            skip_ticks(elapsed);
+            break;
+        }
+        skip_ticks(ticks);
+        process_tick();
+    }
+    is_catching_up = false;
+}
+
+/* Brings the tick count up to the clock, but stops short of the alarm's tick, which is left to the alarm. Nothing
+ * happens before the alarm's tick, so this takes constant time. */
+static void catch_up_to_alarm(void) {
+    if (is_catching_up) {
+        return;
+    }
+    uint32_t elapsed = (wheel_clock->now_us() - tick_start_us) / tick_us;
+    if (is_alarm_set && alarm_tick - now <= elapsed) {
+        elapsed = (alarm_tick != now) ? alarm_tick - now - 1 : 0;
+    }
+    skip_ticks(elapsed);
+}
+
+/* Sets the alarm for `ticks` from the current tick, or as near as the alarm reaches. */
+static void set_alarm_after(uint32_t ticks) {
+    uint32_t const maximum_ticks = MAXIMUM_ALARM_us / tick_us;
+    uint32_t wait_ticks = (ticks < maximum_ticks) ? ticks : maximum_ticks;
+    alarm_tick = now + wait_ticks;
+    is_alarm_set = true;
+    int32_t delay_us = (int32_t) (tick_start_us + wait_ticks * tick_us - wheel_clock->now_us());
+    wheel_clock->set_alarm(delay_us > 0 ? (uint32_t) delay_us : 0, handle_alarm);
+}
+
+static void cancel_alarm(void) {
+    wheel_clock->cancel_alarm();
+    is_alarm_set = false;
+}
+
+/* Sets the alarm for the next tick that has something to do, or cancels it if no timer is armed. */
+static void reprogram_alarm(void) {
+    uint32_t ticks = ticks_until_next_event();
+    if (ticks) {
+        set_alarm_after(ticks);
+    } else {
+        cancel_alarm();
+    }
+}
+
+static void handle_alarm(void) {
+    ENTER_CRITICAL_SECTION();
+    is_alarm_set = false;
+    catch_up();
+    reprogram_alarm();
+    EXIT_CRITICAL_SECTION();
+}
+
+void timer_wheel_initialize(uint32_t tick_length_us, struct timer_wheel_clock const *clock) {
+    ENTER_CRITICAL_SECTION();
+    if (wheel_clock) {
+        wheel_clock->cancel_alarm();
+    }
+    wheel_clock = clock;
+    tick_us = tick_length_us ? tick_length_us : TIMER_WHEEL_TICK_us;
+    tick_start_us = wheel_clock ? wheel_clock->now_us() : 0;
+    is_catching_up = false;
+    number_of_armed_timers = 0;
+    is_alarm_set = false;
+    now = 0;
+    for (unsigned int wheel = 0; wheel < NUMBER_OF_WHEELS; wheel++) {
+        for (unsigned int slot = 0; slot < SLOTS_PER_WHEEL; slot++) {
+            slots[wheel][slot].next = &slots[wheel][slot];
+            slots[wheel][slot].previous = &slots[wheel][slot];
+        }
+    }
+    EXIT_CRITICAL_SECTION();
+}
+
+void timer_wheel_tick(void) {
+    ENTER_CRITICAL_SECTION();
+    now++;
+    process_tick();
+    EXIT_CRITICAL_SECTION();
+}
+
+void timer_wheel_arm(struct software_timer *timer, uint32_t delay_us, uint32_t period_us,
+                     void (*callback)(void *context), void *context) {
+    uint32_t delay_ticks = ticks_for(delay_us);
+    ENTER_CRITICAL_SECTION();
+    if (wheel_clock) {
+        catch_up_to_alarm();
+    }
+    if (timer->next) {
+        unlink_timer(timer);
+    } else {
+        number_of_armed_timers++;
+    }
+    timer->expiration_tick = now + (delay_ticks ? delay_ticks : 1);
+    timer->period_ticks = ticks_for(period_us);
+    timer->callback = callback;
+    timer->context = context;
+    uint32_t visit_tick = insert_timer(timer);
+    // a callback's timers are left to the alarm that is running it, which reprograms itself afterward
+    if (wheel_clock && !is_catching_up && (!is_alarm_set || visit_tick - now < alarm_tick - now)) {
+        set_alarm_after(visit_tick - now);
+    }
+    EXIT_CRITICAL_SECTION();
+}
+
+void timer_wheel_cancel(struct software_timer *timer) {
+    ENTER_CRITICAL_SECTION();
+    if (timer->next) {
+        unlink_timer(timer);
+        number_of_armed_timers--;
+        // an alarm left for an earlier timer finds nothing to do and reprograms itself
+        if (wheel_clock && !is_catching_up && !number_of_armed_timers) {
+            cancel_alarm();
+        }
+    }
+    EXIT_CRITICAL_SECTION();
+}
+
+bool timer_wheel_is_armed(struct software_timer const *timer) {
+    return timer->next != NULL;
+}
+
+uint32_t timer_wheel_now(void) {
+    if (wheel_clock) {
+        ENTER_CRITICAL_SECTION();
+        catch_up_to_alarm();
+        EXIT_CRITICAL_SECTION();
+    }
+    return now;
+}
@@ -0,0 +1,130 @@
+/**************************************************************************//**
+ *
+ * @file timer-wheel.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Any number of one-shot and periodic software timers, multiplexed on
+ *      one hardware alarm by a hierarchical timer wheel.
+ *
+ * Timers are allocated by the caller, so there is no limit on how many may be
+ * armed. Arming and cancelling take constant time. Each tick visits one slot
+ * of the innermost wheel; every 64 ticks, one slot of the next wheel out is
+ * redistributed among the inner wheels, and so on, so each timer is moved at
+ * most five times before it fires.
+ *
+ * The module does not touch the hardware. Given a `struct timer_wheel_clock`,
+ * the wheel keeps one one-shot alarm set for the next tick on which something
+ * happens -- a timer expiring or an outer slot cascading -- and skips the
+ * ticks in between, so the processor is not woken while nothing is due, and
+ * not at all while no timer is armed. Arming a timer moves the alarm earlier
+ * only if the timer's slot is visited before the alarm; cancelling a timer
+ * leaves the alarm alone unless no timer remains. Each alarm finds the next
+ * tick with something to do and sets itself for it, so arming and cancelling
+ * never search the wheels. Without a clock, the
+ * application instead registers `timer_wheel_tick()` as a periodic ISR with
+ * the period passed to `timer_wheel_initialize()`.
+ *
+ * On a host computer, a test can supply a simulated clock, or call
+ * `timer_wheel_tick()` directly.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_TIMER_WHEEL_H
+#define COMBOLOCK_TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIMER_WHEEL_TICK_us (1000)
+
+/* A software timer. Its contents are managed by the timer wheel; the caller
+ * only allocates it, which may be statically or as part of a larger struct. */
+struct software_timer {
+    struct software_timer *next;    // NULL if the timer is not armed
+    struct software_timer *previous;
+    uint32_t expiration_tick;
+    uint32_t period_ticks;          // 0 for a one-shot timer
+    void (*callback)(void *context);
+    void *context;
+};
+
+/* The clock and the one-shot alarm that drive the timer wheel. */
+struct timer_wheel_clock {
+    uint32_t (*now_us)(void);                                   // a free-running microsecond counter
+    void (*set_alarm)(uint32_t delay_us, void (*isr)(void));    // a one-shot alarm `delay_us` from now
+    void (*cancel_alarm)(void);
+};
+
+/**
+ * @brief Empties the timer wheel and sets the length of its tick.
+ *
+ * @param tick_us The resolution of the timers, and the period with which
+ *      `timer_wheel_tick()` will be called if there is no clock
+ * @param clock The clock and alarm that drive the wheel, which must outlive
+ *      it; or `NULL` if the application calls `timer_wheel_tick()` itself
+ */
+void timer_wheel_initialize(uint32_t tick_us, struct timer_wheel_clock const *clock);
+
+/**
+ * @brief Advances the timer wheel by one tick, calling the callbacks of the
+ * timers that expire. Register this as a periodic ISR if the wheel has no
+ * clock; do not call it if the wheel has one.
+ */
+void timer_wheel_tick(void);
+
+/**
+ * @brief Arms a timer, re-arming it if it is already armed.
+ *
+ * The callback is called from the timer wheel's ISR (the alarm's, if the
+ * wheel has a clock); it may arm or cancel any timer, including its own.
+ *
+ * @param timer The timer to be armed
+ * @param delay_us The time until the timer first expires, rounded up to a
+ *      whole number of ticks (at least one)
+ * @param period_us The time between subsequent expirations, or 0 for a
+ *      one-shot timer
+ * @param callback The function to be called when the timer expires
+ * @param context The argument to be passed to the callback
+ */
+void timer_wheel_arm(struct software_timer *timer, uint32_t delay_us, uint32_t period_us,
+                     void (*callback)(void *context), void *context);
+
+/**
+ * @brief Disarms a timer. Does nothing if the timer is not armed.
+ *
+ * @param timer The timer to be cancelled
+ */
+void timer_wheel_cancel(struct software_timer *timer);
+
+/**
+ * @brief Reports whether a timer is armed.
+ *
+ * @param timer The timer in question
+ * @return `true` if the timer will expire; `false` otherwise
+ */
+bool timer_wheel_is_armed(struct software_timer const *timer);
+
+/**
+ * @brief Reports how many ticks have passed since the timer wheel was
+ * initialized.
+ *
+ * @return The current tick
+ */
+uint32_t timer_wheel_now(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_TIMER_WHEEL_H
@@ -0,0 +1,186 @@
+/**************************************************************************//**
+ *
+ * @file virtual-ssd1306.cpp
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief virtual-ssd1306.h
+ *
+ * @copydetails virtual-ssd1306.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "virtual-ssd1306.h"
+
+typedef enum {
+    HORIZONTAL_ADDRESSING, VERTICAL_ADDRESSING, PAGE_ADDRESSING
+} addressing_mode_t;
+
+static uint8_t gddram[8][128];
+static addressing_mode_t addressing_mode;
+static uint8_t first_column, last_column, first_page, last_page;
+static uint8_t column, page;
+
+/* a command's opcode and arguments may be split across transactions */
+static uint8_t command[7];
+static int command_length = 0;
+static int expected_command_length = 0;
+
+static struct virtual_ssd1306_statistics statistics;
+static char const *capture_prefix = NULL;
+
+void virtual_ssd1306_reset(void) {
+    memset(gddram, 0, sizeof(gddram));
+    addressing_mode = PAGE_ADDRESSING;
+    first_column = 0;
+    last_column = 127;
+    first_page = 0;
+    last_page = 7;
+    column = 0;
+    page = 0;
+    command_length = 0;
+    expected_command_length = 0;
+    memset(&statistics, 0, sizeof(statistics));
+}
+
+static int length_of_command(uint8_t opcode) {
+    switch (opcode) {
+        case 0x20:                              // memory addressing mode
+        case 0x81:                              // contrast
+        case 0x8D:                              // charge pump
+        case 0xA8:                              // multiplex ratio
+        case 0xD3:                              // display offset
+        case 0xD5:                              // clock divide ratio
+        case 0xD9:                              // pre-charge period
+        case 0xDA:                              // COM pins configuration
+        case 0xDB:                              // VCOMH deselect level
+            return 2;
+        case 0x21:                              // column address range
+        case 0x22:                              // page address range
+        case 0xA3:                              // vertical scroll area
+            return 3;
+        case 0x29:                              // vertical and horizontal scroll
+        case 0x2A:
+            return 6;
+        case 0x26:                              // horizontal scroll
+        case 0x27:
+            return 7;
+        default:
+            return 1;
+    }
+}
+
+static void execute_command(void) {
+    uint8_t opcode = command[0];
+    if (opcode == 0x20) {
+        addressing_mode = (addressing_mode_t) (command[1] & 0x03);
+        if (addressing_mode > PAGE_ADDRESSING) addressing_mode = PAGE_ADDRESSING;
+    } else if (opcode == 0x21) {
+        first_column = command[1] & 0x7F;
+        last_column = command[2] & 0x7F;
+        column = first_column;
+    } else if (opcode == 0x22) {
+        first_page = command[1] & 0x07;
+        last_page = command[2] & 0x07;
+        page = first_page;
+    } else if (addressing_mode == PAGE_ADDRESSING && opcode <= 0x0F) {
+        column = (uint8_t) ((column & 0xF0) | opcode);
+    } else if (addressing_mode == PAGE_ADDRESSING && opcode >= 0x10 && opcode <= 0x17) {
+        column = (uint8_t) ((column & 0x0F) | ((opcode & 0x07) << 4));
+    } else if (addressing_mode == PAGE_ADDRESSING && opcode >= 0xB0 && opcode <= 0xB7) {
+        page = opcode & 0x07;
+    }
+    // other commands configure the panel and have no effect on GDDRAM
+}
+
+static void write_data(uint8_t byte) {
+    gddram[page][column] = byte;
+    switch (addressing_mode) {
+        case HORIZONTAL_ADDRESSING:
+            if (column++ >= last_column) {
+                column = first_column;
+                page = (page >= last_page) ? first_page : (uint8_t) (page + 1);
+            }
+            break;
+        case VERTICAL_ADDRESSING:
+            if (page++ >= last_page) {
+                page = first_page;
+                column = (column >= last_column) ? first_column : (uint8_t) (column + 1);
+            }
+            break;
+        case PAGE_ADDRESSING:
+            column = (uint8_t) ((column + 1) & 0x7F);
+            break;
+    }
+}
+
+void virtual_ssd1306_transmit(uint8_t control_byte, uint8_t const bytes[], size_t number_of_bytes) {
+    statistics.transactions++;
+    statistics.bytes += number_of_bytes + 2;    // address byte + control byte + payload
+    bool is_data = (control_byte & 0x40) != 0;
+    for (size_t i = 0; i < number_of_bytes; i++) {
+        if (is_data) {
+            statistics.data_bytes++;
+            write_data(bytes[i]);
+        } else {
+            statistics.command_bytes++;
+            if (command_length == 0) {
+                expected_command_length = length_of_command(bytes[i]);
+            }
+            command[command_length++] = bytes[i];
+            if (command_length == expected_command_length) {
+                execute_command();
+                command_length = 0;
+            }
+        }
+    }
+}
+
+void virtual_ssd1306_end_frame(void) {
+    statistics.frames++;
+    if (capture_prefix) {
+        char filename[256];
+        snprintf(filename, sizeof(filename), "%s-%06lu.pbm", capture_prefix, (unsigned long) statistics.frames);
+        virtual_ssd1306_write_pbm(filename);
+    }
+}
+
+void virtual_ssd1306_capture_frames(char const *filename_prefix) {
+    capture_prefix = filename_prefix;
+}
+
+bool virtual_ssd1306_write_pbm(char const *filename) {
+    FILE *file = fopen(filename, "wb");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "P4\n128 64\n");
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 128; x += 8) {
+            uint8_t packed = 0;
+            for (int bit = 0; bit < 8; bit++) {
+                if (gddram[y / 8][x + bit] & (1 << (y % 8))) {
+                    packed |= (uint8_t) (0x80 >> bit);      // PBM: 1 is black, so lit pixels print dark on white
+                }
+            }
+            fputc(packed, file);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+struct virtual_ssd1306_statistics virtual_ssd1306_get_statistics(void) {
+    return statistics;
+}
+
+uint8_t const *virtual_ssd1306_gddram(void) {
+    return &gddram[0][0];
+}
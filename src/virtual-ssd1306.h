@@ -0,0 +1,123 @@
+/**************************************************************************//**
+ *
+ * @file virtual-ssd1306.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief An in-memory stand-in for an SSD1306 display module on an I2C bus.
+ *
+ * The virtual SSD1306 interprets the same command and data streams that
+ * display.cpp sends to a real display module, including the page and column
+ * addressing modes, and keeps the resulting GDDRAM contents in RAM. It counts
+ * the I2C transactions and bytes that those streams would have cost, and it
+ * can write frames out as PBM images.
+ *
+ * Building display.cpp with `VIRTUAL_SSD1306` defined selects this backend.
+ * Without the Arduino framework (that is, on a Linux host), this header also
+ * supplies the few Arduino facilities that display.cpp relies on, so that a
+ * host program can be built with, for example,
+ *
+ *      g++ -DVIRTUAL_SSD1306 -Isrc driver.cpp src/display.cpp src/virtual-ssd1306.cpp \
+ *          src/loop-profiler.c src/microsecond-timer.c
+ *
+ * (display.cpp's `count_loop_pass()` marks each pass for the loop profiler,
+ * so loop-profiler.c must be linked even when `LOOP_PROFILING` is not defined;
+ * a program that simulates time supplies its own `get_microseconds()` in
+ * place of microsecond-timer.c.)
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_VIRTUAL_SSD1306_H
+#define COMBOLOCK_VIRTUAL_SSD1306_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined (ARDUINO)
+#include <stdio.h>
+#include <string.h>
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#define COWPI_VERSION ("host")
+#define COWPI_STDIO_VERSION ("host")
+#endif //ARDUINO
+
+struct virtual_ssd1306_statistics {
+    uint32_t transactions;      // I2C transactions, each a start, address byte, and stop
+    uint32_t bytes;             // bytes on the bus, including address and control bytes
+    uint32_t command_bytes;     // command and command-argument bytes
+    uint32_t data_bytes;        // bytes written to GDDRAM
+    uint32_t frames;            // calls to virtual_ssd1306_end_frame()
+};
+
+/**
+ * @brief Returns the virtual display module to its power-on state and zeroes
+ * its statistics.
+ */
+void virtual_ssd1306_reset(void);
+
+/**
+ * @brief Delivers one I2C transaction to the virtual display module.
+ *
+ * @param control_byte 0x00 if `bytes` are commands, 0x40 if they are data
+ * @param bytes The commands or data that follow the control byte
+ * @param number_of_bytes The number of commands or data bytes
+ */
+void virtual_ssd1306_transmit(uint8_t control_byte, uint8_t const bytes[], size_t number_of_bytes);
+
+/**
+ * @brief Marks the end of a display refresh. If frame capture is enabled, the
+ * GDDRAM contents are written to the next numbered PBM file.
+ */
+void virtual_ssd1306_end_frame(void);
+
+/**
+ * @brief Enables or disables writing each frame to a PBM file.
+ *
+ * Frames are written to `<filename_prefix>-NNNNNN.pbm`.
+ *
+ * @param filename_prefix The path prefix for captured frames, or `NULL` to
+ *      stop capturing frames
+ */
+void virtual_ssd1306_capture_frames(char const *filename_prefix);
+
+/**
+ * @brief Writes the current GDDRAM contents as a 128x64 binary PBM image.
+ *
+ * @param filename The file to be written
+ * @return `true` if the file was written; `false` otherwise
+ */
+bool virtual_ssd1306_write_pbm(char const *filename);
+
+/**
+ * @brief Reports the bus traffic that the virtual display module has received.
+ *
+ * @return The counts accumulated since the last reset
+ */
+struct virtual_ssd1306_statistics virtual_ssd1306_get_statistics(void);
+
+/**
+ * @brief Provides read-only access to the virtual GDDRAM, organized as eight
+ * pages of 128 columns, with bit 0 of each byte at the top of its page.
+ *
+ * @return The 1024-byte GDDRAM contents
+ */
+uint8_t const *virtual_ssd1306_gddram(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_VIRTUAL_SSD1306_H
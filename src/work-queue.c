@@ -0,0 +1,154 @@
+/**************************************************************************//**
+ *
+ * @file work-queue.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief  @copybrief work-queue.h
+ *
+ * @copydetails work-queue.h
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stdio.h>
+#include "work-queue.h"
+
+#define INDEX_MASK (WORK_QUEUE_LENGTH - 1)
+
+#if (WORK_QUEUE_LENGTH & INDEX_MASK) != 0
+#error "WORK_QUEUE_LENGTH must be a power of two"
+#endif
+
+struct cell {
+    uint32_t sequence;              // position when free for a producer; position + 1 when filled
+    void (*function)(uint32_t payload);
+    uint32_t payload;
+};
+
+static struct cell cells[WORK_QUEUE_LENGTH];
+static uint32_t enqueue_position = 0;
+static uint32_t dequeue_position = 0;
+static void (*notify_function)(void) = NULL;
+
+static uint32_t posted_count = 0;
+static uint32_t overflow_count = 0;
+static uint32_t high_water_mark = 0;
+
+#if defined (__ARM_ARCH_6M__)
+/* The Cortex-M0+ has no exclusive loads and stores; with a single core,
+ * masking interrupts for the comparison and store makes them atomic. */
+static inline bool compare_and_swap(uint32_t *location, uint32_t expected, uint32_t desired) {
+    uint32_t interrupt_mask;
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (interrupt_mask) :: "memory");
+    bool is_swapped = (*location == expected);
+    if (is_swapped) {
+        *location = desired;
+    }
+    __asm volatile ("msr primask, %0" :: "r" (interrupt_mask) : "memory");
+    return is_swapped;
+}
+#else
+static inline bool compare_and_swap(uint32_t *location, uint32_t expected, uint32_t desired) {
+    return __atomic_compare_exchange_n(location, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+#endif //__ARM_ARCH_6M__
+
+static inline void atomic_increment(uint32_t *location) {
+    uint32_t value;
+    do {
+        value = __atomic_load_n(location, __ATOMIC_RELAXED);
+    } while (!compare_and_swap(location, value, value + 1));
+}
+
+static inline void atomic_raise(uint32_t *location, uint32_t candidate) {
+    uint32_t value;
+    do {
+        value = __atomic_load_n(location, __ATOMIC_RELAXED);
+    } while (candidate > value && !compare_and_swap(location, value, candidate));
+}
+
+void work_queue_initialize(void) {
+    for (uint32_t i = 0; i < WORK_QUEUE_LENGTH; i++) {
+        __atomic_store_n(&cells[i].sequence, i, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&enqueue_position, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&dequeue_position, 0, __ATOMIC_RELAXED);
+    posted_count = 0;
+    overflow_count = 0;
+    high_water_mark = 0;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void work_queue_set_notify(void (*notify)(void)) {
+    notify_function = notify;
+}
+
+bool work_queue_post(void (*function)(uint32_t payload), uint32_t payload) {
+    struct cell *cell;
+    uint32_t position = __atomic_load_n(&enqueue_position, __ATOMIC_RELAXED);
+    for (;;) {
+        cell = cells + (position & INDEX_MASK);
+        int32_t difference = (int32_t) (__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - position);
+        if (difference == 0) {
+            if (compare_and_swap(&enqueue_position, position, position + 1)) {
+                break;                      // this producer owns the cell
+            }
+            position = __atomic_load_n(&enqueue_position, __ATOMIC_RELAXED);
+        } else if (difference < 0) {
+            atomic_increment(&overflow_count);  // the consumer has not yet emptied the cell
+            return false;
+        } else {
+            position = __atomic_load_n(&enqueue_position, __ATOMIC_RELAXED);   // another producer claimed it
+        }
+    }
+    // until this cell is filled, the consumer cannot dequeue beyond it
+    uint32_t depth = position + 1 - __atomic_load_n(&dequeue_position, __ATOMIC_RELAXED);
+    cell->function = function;
+    cell->payload = payload;
+    __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+    atomic_increment(&posted_count);
+    atomic_raise(&high_water_mark, depth);
+    if (notify_function) {
+        notify_function();
+    }
+    return true;
+}
+
+size_t work_queue_drain(size_t maximum_number_of_items) {
+    size_t number_of_items = 0;
+    uint32_t position = __atomic_load_n(&dequeue_position, __ATOMIC_RELAXED);
+    while (number_of_items < maximum_number_of_items) {
+        struct cell *cell = cells + (position & INDEX_MASK);
+        if ((int32_t) (__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - (position + 1)) < 0) {
+            break;                          // the next cell has not been filled
+        }
+        void (*function)(uint32_t) = cell->function;
+        uint32_t payload = cell->payload;
+        __atomic_store_n(&cell->sequence, position + WORK_QUEUE_LENGTH, __ATOMIC_RELEASE);
+        position++;
+        __atomic_store_n(&dequeue_position, position, __ATOMIC_RELAXED);
+        function(payload);
+        number_of_items++;
+    }
+    return number_of_items;
+}
+
+struct work_queue_statistics work_queue_get_statistics(void) {
+    return (struct work_queue_statistics) {
+            .posted = __atomic_load_n(&posted_count, __ATOMIC_RELAXED),
+            .overflows = __atomic_load_n(&overflow_count, __ATOMIC_RELAXED),
+            .high_water_mark = __atomic_load_n(&high_water_mark, __ATOMIC_RELAXED),
+    };
+}
+
+void print_work_queue_statistics(void) {
+    struct work_queue_statistics statistics = work_queue_get_statistics();
+    printf("work: %lu posted, %lu overflows, high water %lu of %u\n", (unsigned long) statistics.posted,
+           (unsigned long) statistics.overflows, (unsigned long) statistics.high_water_mark, WORK_QUEUE_LENGTH);
+}
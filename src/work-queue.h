@@ -0,0 +1,99 @@
+/**************************************************************************//**
+ *
+ * @file work-queue.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief A bounded, lock-free queue of work that ISRs defer to the main
+ *      context.
+ *
+ * A work item is a function and a 32-bit payload. Any number of ISRs may post
+ * items (even ISRs that preempt each other), and the main context drains them
+ * and calls each function with its payload, so an ISR need do no more than
+ * capture its data and post. The queue is Dmitry Vyukov's bounded queue: each
+ * slot carries a sequence number that tells producers whether the slot is free
+ * and tells the consumer whether the slot has been filled, so producers
+ * coordinate with one compare-and-swap and never wait on the consumer.
+ *
+ * The queue records how many items were posted, how many were rejected
+ * because the queue was full, and the greatest number of items that it has
+ * held at once.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_WORK_QUEUE_H
+#define COMBOLOCK_WORK_QUEUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WORK_QUEUE_LENGTH (32)      // must be a power of two
+
+struct work_queue_statistics {
+    uint32_t posted;
+    uint32_t overflows;             // items rejected because the queue was full
+    uint32_t high_water_mark;       // the most items queued at once
+};
+
+/**
+ * @brief Empties the queue and zeroes its statistics. Call this before any
+ * ISR can post work.
+ */
+void work_queue_initialize(void);
+
+/**
+ * @brief Registers a function to be called each time an item is posted, such
+ * as one that posts a scheduler event so that the queue is drained.
+ *
+ * @param notify The function to be called, or `NULL` for none; it is called
+ *      from the posting context
+ */
+void work_queue_set_notify(void (*notify)(void));
+
+/**
+ * @brief Queues a function to be called later from the main context. Safe to
+ * call from any ISR.
+ *
+ * @param function The function to be called
+ * @param payload The argument to be passed to the function
+ * @return `true` if the item was queued; `false` if the queue was full
+ */
+bool work_queue_post(void (*function)(uint32_t payload), uint32_t payload);
+
+/**
+ * @brief Removes queued items and calls their functions, in the order that the
+ * items were posted. Call this only from the main context.
+ *
+ * @param maximum_number_of_items The most items to be run by this call
+ * @return The number of items run
+ */
+size_t work_queue_drain(size_t maximum_number_of_items);
+
+/**
+ * @brief Reports the queue's statistics since it was initialized.
+ *
+ * @return The queue's statistics
+ */
+struct work_queue_statistics work_queue_get_statistics(void);
+
+/**
+ * @brief Prints the queue's statistics.
+ */
+void print_work_queue_statistics(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_WORK_QUEUE_H
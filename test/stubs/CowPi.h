@@ -0,0 +1,54 @@
+/**************************************************************************//**
+ *
+ * @file CowPi.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host stand-in for the CowPi library header, for the native unit
+ *      tests.
+ *
+ * Only the declarations that the modules under test use are here. A test
+ * suite that links a module calling one of these functions supplies its own
+ * fake, so each suite controls the inputs that its module sees.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_TEST_COWPI_H
+#define COMBOLOCK_TEST_COWPI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool cowpi_left_button_is_pressed(void);
+bool cowpi_right_button_is_pressed(void);
+bool cowpi_left_switch_is_in_left_position(void);
+bool cowpi_left_switch_is_in_right_position(void);
+bool cowpi_right_switch_is_in_left_position(void);
+bool cowpi_right_switch_is_in_right_position(void);
+void cowpi_illuminate_left_led(void);
+void cowpi_illuminate_right_led(void);
+void cowpi_deluminate_left_led(void);
+void cowpi_deluminate_right_led(void);
+uint8_t cowpi_get_keypress(void);
+void cowpi_set_output_pins(uint32_t pin_mask);
+void cowpi_set_pullup_input_pins(uint32_t pin_mask);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif //COMBOLOCK_TEST_COWPI_H
@@ -0,0 +1,151 @@
+/**************************************************************************//**
+ *
+ * @file test_avr_timer_search.cpp
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for the compile-time AVR timer search in
+ *      interrupt_support.h, checked against the floating-point search that
+ *      `configure_timer()` performs at run time.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <unity.h>
+
+#define __AVR__         // the compile-time search is only declared for AVR targets
+#include "interrupt_support.h"
+
+using namespace avr_timer_search;
+
+/* the searches must be usable in constant expressions */
+static_assert(best_configuration(1, 1000).is_valid, "TIMER1 can produce 1 ms");
+static_assert(best_configuration(1, 1000).prescaler_index == 0 && best_configuration(1, 1000).count == 16000,
+              "TIMER1 produces 1 ms with no prescaling");
+static_assert(best_configuration(2, 1000).prescaler_index == 3 && best_configuration(2, 1000).count == 250,
+              "TIMER2 produces 1 ms with a prescaler of 64");
+static_assert(!best_configuration(2, 20000).is_valid, "TIMER2 cannot count to 20 ms");
+
+static unsigned int loaded_timer;
+static unsigned int loaded_prescaler_index;
+static uint32_t loaded_count;
+
+void load_timer_configuration(unsigned int timer_number, unsigned int prescaler_index, uint32_t count) {
+    loaded_timer = timer_number;
+    loaded_prescaler_index = prescaler_index;
+    loaded_count = count;
+}
+
+/* configure_timer()'s search, copied from interrupt_support.cpp without the register writes */
+static bool reference_search(unsigned int timer_number, float desired_period_us,
+                             unsigned int *best_index, uint32_t *best_count) {
+    float const system_clock = 16.0;
+    float best_error = INFINITY;
+    for (unsigned int i = 0; i < number_of_prescalers(timer_number); i++) {
+        int prescaler = (int) avr_timer_search::prescaler(timer_number, i);
+        float closest_count_above = ceilf(desired_period_us * system_clock / prescaler);
+        float closest_count_below = floorf(desired_period_us * system_clock / prescaler);
+        float actual_period_us = closest_count_above * prescaler / system_clock;
+        float error = fabsf(actual_period_us - desired_period_us);
+        if (closest_count_above <= number_of_counter_values(timer_number) && error < best_error) {
+            best_error = error;
+            *best_count = (uint32_t) closest_count_above;
+            *best_index = i;
+        }
+        actual_period_us = closest_count_below * prescaler / system_clock;
+        error = fabsf(actual_period_us - desired_period_us);
+        if (closest_count_below <= number_of_counter_values(timer_number) && error < best_error) {
+            best_error = error;
+            *best_count = (uint32_t) closest_count_below;
+            *best_index = i;
+        }
+    }
+    return best_error != INFINITY;
+}
+
+static uint32_t error_cycles(unsigned int timer_number, uint32_t period_us, unsigned int index, uint32_t count) {
+    return difference(count * prescaler(timer_number, index), period_us * CYCLES_PER_MICROSECOND);
+}
+
+void setUp(void) {
+    loaded_timer = 0;
+    loaded_prescaler_index = 0;
+    loaded_count = 0;
+}
+
+void tearDown(void) {}
+
+static void compare_searches(unsigned int timer_number, uint32_t longest_period_us) {
+    unsigned int agreements = 0;
+    unsigned int comparisons = 0;
+    for (uint32_t period_us = 1; period_us <= longest_period_us; period_us += 1 + period_us / 64) {
+        unsigned int reference_index = 0;
+        uint32_t reference_count = 0;
+        bool reference_is_valid = reference_search(timer_number, (float) period_us, &reference_index, &reference_count);
+        candidate configuration = best_configuration(timer_number, period_us);
+        TEST_ASSERT_EQUAL(reference_is_valid, configuration.is_valid);
+        if (!reference_is_valid) {
+            continue;
+        }
+        comparisons++;
+        if (configuration.prescaler_index == reference_index && configuration.count == reference_count) {
+            agreements++;
+        } else {
+            // single-precision rounding can reorder near-ties; the integer search must never be the worse of the two
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32(error_cycles(timer_number, period_us, reference_index, reference_count),
+                                             configuration.error_cycles);
+        }
+        TEST_ASSERT_EQUAL_UINT32(error_cycles(timer_number, period_us, configuration.prescaler_index,
+                                              configuration.count),
+                                 configuration.error_cycles);
+    }
+    char message[80];
+    snprintf(message, sizeof(message), "TIMER%u: %u of %u periods chose the same configuration",
+             timer_number, agreements, comparisons);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_GREATER_THAN_UINT32(comparisons * 99 / 100, agreements);
+}
+
+static void test_timer1_search_matches_run_time_search(void) {
+    compare_searches(1, 4194304);                   // 1024 * 65536 cycles
+}
+
+static void test_timer2_search_matches_run_time_search(void) {
+    compare_searches(2, 16384 + 100);               // 1024 * 256 cycles, and a little beyond
+}
+
+static void test_template_loads_the_chosen_configuration(void) {
+    float period_us = configure_timer<2, 1000>();
+    TEST_ASSERT_EQUAL_UINT(2, loaded_timer);
+    TEST_ASSERT_EQUAL_UINT(3, loaded_prescaler_index);
+    TEST_ASSERT_EQUAL_UINT32(250, loaded_count);
+    TEST_ASSERT_FLOAT_WITHIN(0.0f, 1000.0f, period_us);
+    period_us = configure_timer<1, 20000>();
+    TEST_ASSERT_EQUAL_UINT(1, loaded_timer);
+    TEST_ASSERT_EQUAL_UINT(1, loaded_prescaler_index);      // 320000 cycles need a prescaler of 8
+    TEST_ASSERT_EQUAL_UINT32(40000, loaded_count);
+    TEST_ASSERT_FLOAT_WITHIN(0.0f, 20000.0f, period_us);
+}
+
+static void test_template_reports_an_inexact_period(void) {
+    float period_us = configure_timer<2, 16001, 100000>();  // no prescaler divides 256016 cycles
+    TEST_ASSERT_EQUAL_UINT32(best_configuration(2, 16001).count, loaded_count);
+    TEST_ASSERT_FLOAT_WITHIN(64.0f, 16001.0f, period_us);
+    TEST_ASSERT_TRUE(period_us != 16001.0f);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_timer1_search_matches_run_time_search);
+    RUN_TEST(test_timer2_search_matches_run_time_search);
+    RUN_TEST(test_template_loads_the_chosen_configuration);
+    RUN_TEST(test_template_reports_an_inexact_period);
+    return UNITY_END();
+}
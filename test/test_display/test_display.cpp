@@ -0,0 +1,386 @@
+/**************************************************************************//**
+ *
+ * @file test_display.cpp
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for display.cpp against the virtual SSD1306: partial row
+ *      updates, the background flush, and the frame-rate governor.
+ *
+ * The virtual display module interprets the command and data streams that
+ * display.cpp sends, so these tests can check which GDDRAM windows each
+ * refresh addresses and what the bus traffic costs.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#define VIRTUAL_SSD1306
+
+#include <unity.h>
+#include "display.cpp"
+#include "loop-profiler.c"
+#include "virtual-ssd1306.cpp"
+
+#define COMMAND_TRANSACTION_BYTES(commands) (2 + (commands))    // address byte + control byte + commands
+#define DATA_TRANSACTION_BYTES(data)        (2 + (data))
+
+static uint32_t simulated_time_us;
+static uint8_t gddram_before[1024];
+static struct virtual_ssd1306_statistics statistics_before;
+static uint32_t bytes_sent_before;
+static unsigned completed_flushes;
+
+/* fake for the module's dependency */
+
+uint32_t get_microseconds(void) {
+    return simulated_time_us;
+}
+
+static void count_completed_flush(void) {
+    completed_flushes++;
+}
+
+/* helpers */
+
+#define FRAME_RATE          (30)
+#define FRAME_INTERVAL_us   (1000000 / FRAME_RATE)
+
+static void take_snapshot(void) {
+    memcpy(gddram_before, virtual_ssd1306_gddram(), sizeof(gddram_before));
+    statistics_before = virtual_ssd1306_get_statistics();
+    bytes_sent_before = get_display_bytes_sent();
+}
+
+static struct virtual_ssd1306_statistics traffic_since_snapshot(void) {
+    struct virtual_ssd1306_statistics now = virtual_ssd1306_get_statistics();
+    return (struct virtual_ssd1306_statistics) {
+            .transactions = now.transactions - statistics_before.transactions,
+            .bytes = now.bytes - statistics_before.bytes,
+            .command_bytes = now.command_bytes - statistics_before.command_bytes,
+            .data_bytes = now.data_bytes - statistics_before.data_bytes,
+            .frames = now.frames - statistics_before.frames,
+    };
+}
+
+/* Asserts that GDDRAM changed only within the window, and somewhere within it. */
+static void assert_only_window_changed(struct ssd1306_window window) {
+    uint8_t const *gddram = virtual_ssd1306_gddram();
+    bool window_changed = false;
+    for (int page = 0; page < 8; page++) {
+        for (int x = 0; x < 128; x++) {
+            bool is_inside = page >= window.first_page && page <= window.last_page
+                             && x >= window.first_x && x <= window.last_x;
+            bool is_changed = gddram[128 * page + x] != gddram_before[128 * page + x];
+            if (is_inside) {
+                window_changed |= is_changed;
+            } else if (is_changed) {
+                char message[40];
+                snprintf(message, sizeof(message), "page %d, x %d", page, x);
+                TEST_FAIL_MESSAGE(message);
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(window_changed);
+}
+
+/* Calls service_display() until the flush finishes, and reports how many calls sent something. */
+static int drain_background_flush(void) {
+    int calls = 0;
+    while (display_flush_is_in_progress()) {
+        uint32_t transactions = virtual_ssd1306_get_statistics().transactions;
+        service_display();
+        TEST_ASSERT_EQUAL_UINT32(transactions + 1, virtual_ssd1306_get_statistics().transactions);
+        TEST_ASSERT_LESS_THAN_INT(1000, ++calls);
+    }
+    return calls;
+}
+
+void setUp(void) {
+    simulated_time_us = 0;
+    set_display_flush_mode(DISPLAY_FLUSH_BLOCKING);
+    set_display_flush_callback(NULL);
+    number_of_coalesced_refreshes = 0;
+    completed_flushes = 0;
+    number_of_records = 0;                  // initialize_display() records its build timestamp each time
+    set_display_frame_rate(0);
+    initialize_display(21);
+    display_string(2, "Combo: 05-10-15");
+    refresh_display();
+    number_of_dropped_frames = 0;
+    number_of_merged_frames = 0;
+    frame_start_us = 0;
+    take_snapshot();
+}
+
+void tearDown(void) {}
+
+static void test_update_row_marks_only_the_changed_span(void) {
+    update_row(2, "Combo: 05-23-15", 0, 14);
+    TEST_ASSERT_EQUAL_HEX8(1 << 2, dirty_rows);
+    TEST_ASSERT_EQUAL_INT(10, dirty_first_column[2]);
+    TEST_ASSERT_EQUAL_INT(11, dirty_last_column[2]);
+    update_row(2, "9", 14, 14);                                     // a second change widens the span
+    TEST_ASSERT_EQUAL_INT(10, dirty_first_column[2]);
+    TEST_ASSERT_EQUAL_INT(14, dirty_last_column[2]);
+    update_row(2, "Combo: ", 0, 6);                                 // unchanged text marks nothing
+    TEST_ASSERT_EQUAL_INT(10, dirty_first_column[2]);
+    TEST_ASSERT_EQUAL_UINT32(1, get_display_dropped_frame_count());
+}
+
+static void test_render_dirty_rows_reports_one_window_per_row(void) {
+    update_row(2, "23", 10, 11);
+    update_row(5, "x", 0, 0);
+    struct ssd1306_window windows[8];
+    TEST_ASSERT_EQUAL_INT(2, render_dirty_rows(windows));
+    TEST_ASSERT_EQUAL_UINT8(2, windows[0].first_page);
+    TEST_ASSERT_EQUAL_UINT8(2, windows[0].last_page);
+    TEST_ASSERT_EQUAL_UINT8(60, windows[0].first_x);
+    TEST_ASSERT_EQUAL_UINT8(71, windows[0].last_x);
+    TEST_ASSERT_EQUAL_UINT8(5, windows[1].first_page);
+    TEST_ASSERT_EQUAL_UINT8(0, windows[1].first_x);
+    TEST_ASSERT_EQUAL_UINT8(5, windows[1].last_x);
+    TEST_ASSERT_EQUAL_HEX8(0, dirty_rows);
+    TEST_ASSERT_EQUAL_INT(0, render_dirty_rows(windows));
+}
+
+static void test_two_column_change_sends_only_its_window(void) {
+    display_string(2, "Combo: 05-23-15");
+    refresh_display();
+    /* the virtual module's address registers hold the window that the refresh set */
+    TEST_ASSERT_EQUAL_UINT8(60, first_column);
+    TEST_ASSERT_EQUAL_UINT8(71, last_column);
+    TEST_ASSERT_EQUAL_UINT8(2, first_page);
+    TEST_ASSERT_EQUAL_UINT8(2, last_page);
+    assert_only_window_changed((struct ssd1306_window) {.first_page = 2, .last_page = 2, .first_x = 60, .last_x = 71});
+    struct virtual_ssd1306_statistics traffic = traffic_since_snapshot();
+    TEST_ASSERT_EQUAL_UINT32(2, traffic.transactions);
+    TEST_ASSERT_EQUAL_UINT32(6, traffic.command_bytes);
+    TEST_ASSERT_EQUAL_UINT32(2 * 6, traffic.data_bytes);
+    TEST_ASSERT_EQUAL_UINT32(1, traffic.frames);
+    TEST_ASSERT_EQUAL_UINT32(COMMAND_TRANSACTION_BYTES(6) + DATA_TRANSACTION_BYTES(12), traffic.bytes);
+    TEST_ASSERT_EQUAL_UINT32(traffic.bytes, get_display_bytes_per_refresh());
+}
+
+static void test_wide_window_is_sent_in_chunks(void) {
+    display_string(2, "Combo: 99-99-99");                     // columns 7-14 except the dashes at 9 and 12
+    refresh_display();
+    assert_only_window_changed((struct ssd1306_window) {.first_page = 2, .last_page = 2, .first_x = 42, .last_x = 89});
+    struct virtual_ssd1306_statistics traffic = traffic_since_snapshot();
+    TEST_ASSERT_EQUAL_UINT32(1 + 3, traffic.transactions);      // 48 bytes in chunks of I2C_CHUNK_SIZE
+    TEST_ASSERT_EQUAL_UINT32(COMMAND_TRANSACTION_BYTES(6) + 3 * DATA_TRANSACTION_BYTES(I2C_CHUNK_SIZE), traffic.bytes);
+    TEST_ASSERT_EQUAL_UINT32(traffic.bytes, get_display_bytes_per_refresh());
+    TEST_ASSERT_EQUAL_UINT32(traffic.bytes, get_display_bytes_sent() - bytes_sent_before);
+}
+
+static void test_unchanged_text_sends_nothing(void) {
+    display_string(2, "Combo: 05-10-15");
+    refresh_display();
+    struct virtual_ssd1306_statistics traffic = traffic_since_snapshot();
+    TEST_ASSERT_EQUAL_UINT32(0, traffic.transactions);
+    TEST_ASSERT_EQUAL_UINT32(0, traffic.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, get_display_bytes_per_refresh());
+}
+
+static void test_service_display_sends_one_transaction_per_call(void) {
+    set_display_flush_mode(DISPLAY_FLUSH_BACKGROUND);
+    display_string(2, "Combo: 99-99-99");
+    refresh_display();                                          // latches the frame and sends the window address
+    TEST_ASSERT_TRUE(display_flush_is_in_progress());
+    TEST_ASSERT_EQUAL_UINT32(1, traffic_since_snapshot().transactions);
+    TEST_ASSERT_EQUAL_UINT32(0, traffic_since_snapshot().data_bytes);
+    TEST_ASSERT_EQUAL_INT(3, drain_background_flush());         // 48 bytes in chunks of I2C_CHUNK_SIZE
+    service_display();                                          // nothing left to send
+    struct virtual_ssd1306_statistics traffic = traffic_since_snapshot();
+    TEST_ASSERT_EQUAL_UINT32(1 + 3, traffic.transactions);
+    TEST_ASSERT_EQUAL_UINT32(1, traffic.frames);
+    TEST_ASSERT_EQUAL_UINT32(traffic.bytes, get_display_bytes_per_refresh());
+    TEST_ASSERT_EQUAL_MEMORY(backbuffer, virtual_ssd1306_gddram(), sizeof(backbuffer));
+}
+
+static void test_flush_sends_the_latched_frame(void) {
+    set_display_flush_mode(DISPLAY_FLUSH_BACKGROUND);
+    display_string(2, "Combo: 99-99-99");
+    refresh_display();
+    uint8_t latched[1024];
+    memcpy(latched, backbuffer, sizeof(latched));
+    display_string(2, "Combo: 11-11-11");
+    library_specific_render_row(2, 0, column_count - 1);        // the framebuffer moves on during the flush
+    drain_background_flush();
+    TEST_ASSERT_EQUAL_UINT32(1, traffic_since_snapshot().frames);
+    TEST_ASSERT_EQUAL_MEMORY(latched, virtual_ssd1306_gddram(), sizeof(latched));
+}
+
+static void test_mid_flush_requests_are_coalesced(void) {
+    set_display_flush_mode(DISPLAY_FLUSH_BACKGROUND);
+    display_string(2, "Combo: 99-99-99");
+    refresh_display();
+    display_string(5, "first");
+    refresh_display();                                          // deferred until the flush completes
+    TEST_ASSERT_EQUAL_UINT32(0, get_display_coalesced_refresh_count());
+    display_string(6, "second");
+    refresh_display();                                          // merged into the deferred refresh
+    display_string(6, "third");
+    refresh_display();
+    TEST_ASSERT_EQUAL_UINT32(2, get_display_coalesced_refresh_count());
+    refresh_display();                                          // nothing new to merge
+    TEST_ASSERT_EQUAL_UINT32(2, get_display_coalesced_refresh_count());
+    drain_background_flush();
+    struct virtual_ssd1306_statistics traffic = traffic_since_snapshot();
+    TEST_ASSERT_EQUAL_UINT32(2, traffic.frames);                // the first flush and one for all of the requests
+    TEST_ASSERT_EQUAL_UINT32(traffic.bytes, get_display_bytes_sent() - bytes_sent_before);
+    TEST_ASSERT_EQUAL_MEMORY(backbuffer, virtual_ssd1306_gddram(), sizeof(backbuffer));
+}
+
+static void test_completion_callback_fires_once_per_flush(void) {
+    set_display_flush_mode(DISPLAY_FLUSH_BACKGROUND);
+    set_display_flush_callback(count_completed_flush);
+    display_string(2, "Combo: 99-99-99");
+    refresh_display();
+    display_string(5, "pending");
+    refresh_display();
+    while (display_flush_is_in_progress() && traffic_since_snapshot().frames == 0) {
+        TEST_ASSERT_EQUAL_UINT(0, completed_flushes);
+        service_display();
+    }
+    TEST_ASSERT_EQUAL_UINT(1, completed_flushes);
+    TEST_ASSERT_TRUE(display_flush_is_in_progress());           // the deferred refresh started at once
+    drain_background_flush();
+    TEST_ASSERT_EQUAL_UINT(2, completed_flushes);
+    service_display();
+    refresh_display();
+    TEST_ASSERT_EQUAL_UINT(2, completed_flushes);
+}
+
+static void test_switching_to_blocking_finishes_the_flush(void) {
+    set_display_flush_mode(DISPLAY_FLUSH_BACKGROUND);
+    set_display_flush_callback(count_completed_flush);
+    display_string(2, "Combo: 99-99-99");
+    refresh_display();
+    set_display_flush_mode(DISPLAY_FLUSH_BLOCKING);
+    TEST_ASSERT_FALSE(display_flush_is_in_progress());
+    TEST_ASSERT_EQUAL_UINT(1, completed_flushes);
+    TEST_ASSERT_EQUAL_MEMORY(backbuffer, virtual_ssd1306_gddram(), sizeof(backbuffer));
+}
+
+static void test_updates_within_a_frame_interval_merge_into_one_flush(void) {
+    set_display_frame_rate(FRAME_RATE);
+    simulated_time_us = 1000000;
+    display_string(1, "a");
+    refresh_display();                                          // begins a frame
+    TEST_ASSERT_EQUAL_UINT32(1, traffic_since_snapshot().frames);
+    simulated_time_us += 1000;
+    display_string(2, "Combo: 05-23-15");
+    refresh_display();
+    simulated_time_us += 1000;
+    display_string(3, "c");
+    refresh_display();
+    simulated_time_us += FRAME_INTERVAL_us - 2000 - 1;
+    refresh_display();                                          // still held back, so merged as well
+    TEST_ASSERT_EQUAL_UINT32(1, traffic_since_snapshot().frames);
+    TEST_ASSERT_EQUAL_UINT32(3, get_display_merged_frame_count());
+    simulated_time_us += 1;
+    refresh_display();
+    struct virtual_ssd1306_statistics traffic = traffic_since_snapshot();
+    TEST_ASSERT_EQUAL_UINT32(2, traffic.frames);                        // one flush carried both rows
+    TEST_ASSERT_EQUAL_MEMORY(backbuffer, virtual_ssd1306_gddram(), sizeof(backbuffer));
+    TEST_ASSERT_EQUAL_UINT32(3, get_display_merged_frame_count());
+    TEST_ASSERT_EQUAL_UINT32(0, get_display_dropped_frame_count());     // no row changed twice
+}
+
+static void test_idle_refreshes_are_not_counted_as_merged(void) {
+    set_display_frame_rate(FRAME_RATE);
+    simulated_time_us = 1000000;
+    display_string(1, "a");
+    refresh_display();
+    for (int i = 0; i < 10; i++) {
+        simulated_time_us += 100;
+        refresh_display();
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, get_display_merged_frame_count());
+    TEST_ASSERT_EQUAL_UINT32(1, traffic_since_snapshot().frames);
+}
+
+static void test_changing_a_held_row_again_drops_a_frame(void) {
+    set_display_frame_rate(FRAME_RATE);
+    simulated_time_us = 1000000;
+    display_string(1, "a");
+    refresh_display();
+    simulated_time_us += 1000;
+    display_string(2, "Combo: 05-23-15");
+    refresh_display();
+    simulated_time_us += 1000;
+    display_string(2, "Combo: 05-24-15");                       // "05-23-15" never reaches the display
+    refresh_display();
+    simulated_time_us += 1000;
+    display_string(2, "Combo: 05-24-15");                       // unchanged text drops nothing
+    refresh_display();
+    TEST_ASSERT_EQUAL_UINT32(1, get_display_dropped_frame_count());
+    TEST_ASSERT_EQUAL_UINT32(3, get_display_merged_frame_count());      // each refresh found the row still held back
+    simulated_time_us += FRAME_INTERVAL_us;
+    refresh_display();
+    TEST_ASSERT_EQUAL_UINT32(2, traffic_since_snapshot().frames);
+    TEST_ASSERT_EQUAL_STRING("Combo: 05-24-15      ", rows[2]);
+}
+
+static void test_urgent_refresh_bypasses_the_governor(void) {
+    set_display_frame_rate(FRAME_RATE);
+    simulated_time_us = 1000000;
+    display_string(1, "a");
+    refresh_display();
+    simulated_time_us += 1000;
+    display_string(3, "held");
+    refresh_display();
+    TEST_ASSERT_EQUAL_UINT32(1, traffic_since_snapshot().frames);
+    simulated_time_us += 1000;
+    display_string(2, "OPEN\n");                               // a trailing newline requests an immediate refresh
+    struct virtual_ssd1306_statistics traffic = traffic_since_snapshot();
+    TEST_ASSERT_EQUAL_UINT32(2, traffic.frames);
+    TEST_ASSERT_EQUAL_MEMORY(backbuffer, virtual_ssd1306_gddram(), sizeof(backbuffer));   // and carries the held row
+    TEST_ASSERT_EQUAL_UINT32(1, get_display_merged_frame_count());
+    simulated_time_us += 1000;                                  // the urgent frame restarts the interval
+    display_string(4, "next");
+    refresh_display();
+    TEST_ASSERT_EQUAL_UINT32(2, traffic_since_snapshot().frames);
+    TEST_ASSERT_EQUAL_UINT32(2, get_display_merged_frame_count());
+    refresh_display_immediately();
+    TEST_ASSERT_EQUAL_UINT32(3, traffic_since_snapshot().frames);
+}
+
+static void test_frame_interval_survives_clock_wraparound(void) {
+    set_display_frame_rate(FRAME_RATE);
+    simulated_time_us = UINT32_MAX - 1000;
+    display_string(1, "a");
+    refresh_display();
+    simulated_time_us += 2000;                                  // wraps past zero
+    display_string(1, "b");
+    refresh_display();
+    TEST_ASSERT_EQUAL_UINT32(1, get_display_merged_frame_count());
+    simulated_time_us += FRAME_INTERVAL_us;
+    refresh_display();
+    TEST_ASSERT_EQUAL_UINT32(2, traffic_since_snapshot().frames);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_update_row_marks_only_the_changed_span);
+    RUN_TEST(test_render_dirty_rows_reports_one_window_per_row);
+    RUN_TEST(test_two_column_change_sends_only_its_window);
+    RUN_TEST(test_wide_window_is_sent_in_chunks);
+    RUN_TEST(test_unchanged_text_sends_nothing);
+    RUN_TEST(test_service_display_sends_one_transaction_per_call);
+    RUN_TEST(test_flush_sends_the_latched_frame);
+    RUN_TEST(test_mid_flush_requests_are_coalesced);
+    RUN_TEST(test_completion_callback_fires_once_per_flush);
+    RUN_TEST(test_switching_to_blocking_finishes_the_flush);
+    RUN_TEST(test_updates_within_a_frame_interval_merge_into_one_flush);
+    RUN_TEST(test_idle_refreshes_are_not_counted_as_merged);
+    RUN_TEST(test_changing_a_held_row_again_drops_a_frame);
+    RUN_TEST(test_urgent_refresh_bypasses_the_governor);
+    RUN_TEST(test_frame_interval_survives_clock_wraparound);
+    return UNITY_END();
+}
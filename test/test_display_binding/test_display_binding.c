@@ -0,0 +1,109 @@
+/**************************************************************************//**
+ *
+ * @file test_display_binding.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for display-binding.c: which updates render, which are
+ *      counted as skipped, and the hash that keys unversioned state.
+ *
+ * `display_string()` is faked to record each write, so the tests can check
+ * that a skipped render writes nothing and that the statistics agree with the
+ * writes that were made.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "display-binding.c"
+
+static char written[DISPLAY_BINDING_BUFFER_SIZE];
+static int written_row;
+static unsigned display_writes;
+static uint32_t state_key;
+static unsigned renders;
+
+/* fake for the module's dependency */
+
+void display_string(int row, char const string[]) {
+    strncpy(written, string, sizeof(written) - 1);
+    written_row = row;
+    display_writes++;
+}
+
+static uint32_t get_state_key(void) {
+    return state_key;
+}
+
+static void render(char buffer[]) {
+    snprintf(buffer, DISPLAY_BINDING_BUFFER_SIZE, "key %lu", (unsigned long) state_key);
+    renders++;
+}
+
+static struct display_binding binding;
+
+void setUp(void) {
+    statistics = (struct display_binding_statistics) {0, 0};
+    memset(written, 0, sizeof(written));
+    written_row = -1;
+    display_writes = 0;
+    state_key = 0;
+    renders = 0;
+    display_binding_bind(&binding, 3, get_state_key, render);
+}
+
+void tearDown(void) {}
+
+static void test_first_update_renders_even_for_key_zero(void) {
+    TEST_ASSERT_TRUE(display_binding_update(&binding));
+    TEST_ASSERT_EQUAL_INT(3, written_row);
+    TEST_ASSERT_EQUAL_STRING("key 0", written);
+    TEST_ASSERT_EQUAL_UINT32(1, display_binding_get_statistics().renders);
+    TEST_ASSERT_EQUAL_UINT32(0, display_binding_get_statistics().skipped_renders);
+}
+
+static void test_unchanged_state_is_skipped_and_counted(void) {
+    display_binding_update(&binding);
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_FALSE(display_binding_update(&binding));
+    }
+    state_key = 42;
+    TEST_ASSERT_TRUE(display_binding_update(&binding));
+    TEST_ASSERT_EQUAL_STRING("key 42", written);
+    TEST_ASSERT_FALSE(display_binding_update(&binding));
+    struct display_binding_statistics counts = display_binding_get_statistics();
+    TEST_ASSERT_EQUAL_UINT32(2, counts.renders);
+    TEST_ASSERT_EQUAL_UINT32(11, counts.skipped_renders);
+    TEST_ASSERT_EQUAL_UINT(counts.renders, display_writes);     // a skipped render writes nothing
+    TEST_ASSERT_EQUAL_UINT(counts.renders, renders);            // nor formats anything
+}
+
+static void test_invalidated_row_renders_without_a_change(void) {
+    display_binding_update(&binding);
+    display_binding_invalidate(&binding);
+    TEST_ASSERT_TRUE(display_binding_update(&binding));
+    TEST_ASSERT_FALSE(display_binding_update(&binding));
+    TEST_ASSERT_EQUAL_UINT32(2, display_binding_get_statistics().renders);
+    TEST_ASSERT_EQUAL_UINT32(1, display_binding_get_statistics().skipped_renders);
+}
+
+static void test_hash_is_fnv_1a(void) {
+    TEST_ASSERT_EQUAL_HEX32(0x811C9DC5, display_binding_hash("", 0));
+    TEST_ASSERT_EQUAL_HEX32(0xE40C292C, display_binding_hash("a", 1));
+    TEST_ASSERT_EQUAL_HEX32(0xBF9CF968, display_binding_hash("foobar", 6));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_update_renders_even_for_key_zero);
+    RUN_TEST(test_unchanged_state_is_skipped_and_counted);
+    RUN_TEST(test_invalidated_row_renders_without_a_change);
+    RUN_TEST(test_hash_is_fnv_1a);
+    return UNITY_END();
+}
@@ -0,0 +1,146 @@
+/**************************************************************************//**
+ *
+ * @file test_fixed_format.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Checks the fixed-width formatters against `sprintf()` and compares
+ *      their speed on the patterns that the display code uses.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+#include "fixed-format.h"
+
+#define BENCHMARK_ITERATIONS (1000000)
+
+static char volatile sink;      // keeps the benchmark loops from being optimized away
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+static void format_combination(char buffer[], int first, int second, int third) {
+    char *end = format_decimal_2(buffer, first);
+    *end++ = '-';
+    end = format_decimal_2(end, second);
+    *end++ = '-';
+    format_end(format_decimal_2(end, third));
+}
+
+static void test_decimal_2_matches_sprintf(void) {
+    for (unsigned int value = 0; value < 100; value++) {
+        char expected[8], actual[8];
+        sprintf(expected, "%02u", value);
+        format_end(format_decimal_2(actual, value));
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+}
+
+static void test_hex_byte_matches_sprintf(void) {
+    for (unsigned int value = 0; value < 256; value++) {
+        char expected[8], actual[8];
+        sprintf(expected, "%02X", value);
+        format_end(format_hex_byte(actual, (uint8_t) value));
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+}
+
+static void test_unsigned_matches_sprintf(void) {
+    uint32_t const values[] = {0, 1, 9, 10, 99, 100, 12345, 999999, 1000000, UINT32_MAX};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        char expected[16], actual[16];
+        sprintf(expected, "%lu", (unsigned long) values[i]);
+        format_end(format_unsigned(actual, values[i]));
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+}
+
+static void test_padded_string_matches_sprintf(void) {
+    char const *sources[] = {"", "OPEN", "bad try 2", "exactly twenty-one ch", "longer than twenty-one characters"};
+    for (size_t i = 0; i < sizeof(sources) / sizeof(sources[0]); i++) {
+        for (int width = 1; width <= 21; width++) {
+            char expected[32], actual[32];
+            sprintf(expected, "%-*.*s", width, width, sources[i]);
+            format_end(format_padded_string(actual, sources[i], width));
+            TEST_ASSERT_EQUAL_STRING(expected, actual);
+        }
+    }
+}
+
+static void test_combination_line_matches_sprintf(void) {
+    for (int value = 0; value < 16; value++) {
+        char expected[16], actual[16];
+        sprintf(expected, "%02d-%02d-%02d", value, 15 - value, (value * 7) % 16);
+        format_combination(actual, value, 15 - value, (value * 7) % 16);
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+}
+
+static void benchmark_combination_line(void) {
+    char buffer[22];
+    uint64_t start = now_ns();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        sprintf(buffer, "%02d-%02d-%02d", i & 15, (i >> 4) & 15, (i >> 8) & 15);
+        sink = buffer[7];
+    }
+    uint64_t sprintf_ns = now_ns() - start;
+    start = now_ns();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        format_combination(buffer, i & 15, (i >> 4) & 15, (i >> 8) & 15);
+        sink = buffer[7];
+    }
+    uint64_t formatter_ns = now_ns() - start;
+    char message[96];
+    snprintf(message, sizeof(message), "\"%%02d-%%02d-%%02d\": sprintf %.1f ns, formatter %.1f ns per call",
+             (double) sprintf_ns / BENCHMARK_ITERATIONS, (double) formatter_ns / BENCHMARK_ITERATIONS);
+    TEST_MESSAGE(message);
+}
+
+static void benchmark_padded_row(void) {
+    char const *sources[] = {"- - -", "05-10-  ", "bad try 1", "CW:123 CCW:45"};
+    char buffer[22];
+    uint64_t start = now_ns();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        sprintf(buffer, "%-*.*s", 21, 21, sources[i & 3]);
+        sink = buffer[20];
+    }
+    uint64_t sprintf_ns = now_ns() - start;
+    start = now_ns();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        format_end(format_padded_string(buffer, sources[i & 3], 21));
+        sink = buffer[20];
+    }
+    uint64_t formatter_ns = now_ns() - start;
+    char message[96];
+    snprintf(message, sizeof(message), "\"%%-21.21s\": sprintf %.1f ns, formatter %.1f ns per call",
+             (double) sprintf_ns / BENCHMARK_ITERATIONS, (double) formatter_ns / BENCHMARK_ITERATIONS);
+    TEST_MESSAGE(message);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_decimal_2_matches_sprintf);
+    RUN_TEST(test_hex_byte_matches_sprintf);
+    RUN_TEST(test_unsigned_matches_sprintf);
+    RUN_TEST(test_padded_string_matches_sprintf);
+    RUN_TEST(test_combination_line_matches_sprintf);
+    RUN_TEST(benchmark_combination_line);
+    RUN_TEST(benchmark_padded_row);
+    return UNITY_END();
+}
@@ -0,0 +1,196 @@
+/**************************************************************************//**
+ *
+ * @file test_gpio_dispatch.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for gpio-dispatch.c against a simulated interrupt
+ *      controller: nibble gathering, dispatch order, acknowledgement, and
+ *      chaining to the previous bank-level handler.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "gpio-dispatch.c"
+
+#define EDGE_LOW(pin)   (0x4u << (4 * ((pin) % 8)))
+#define EDGE_HIGH(pin)  (0x8u << (4 * ((pin) % 8)))
+#define LEVEL_LOW(pin)  (0x1u << (4 * ((pin) % 8)))
+
+static struct rp2040_gpio_interrupts simulated_interrupts;
+static uint32_t simulated_pads[NUMBER_OF_PINS];
+static uint32_t simulated_gpio_input;
+static struct cortex_m_systick simulated_systick;
+
+static unsigned dispatched_pins[64];
+static int number_of_dispatches;
+static unsigned chained_calls;
+
+static unsigned pin_numbers[NUMBER_OF_PINS];
+
+static void record_pin_number(void *context) {
+    TEST_ASSERT_LESS_THAN_INT(64, number_of_dispatches);
+    dispatched_pins[number_of_dispatches++] = *(unsigned *) context;
+}
+
+static unsigned plain_isr_calls;
+
+static void plain_isr(void) {
+    plain_isr_calls++;
+}
+
+static void previous_handler(void) {
+    chained_calls++;
+}
+
+/* Sets the status bits that the interrupt controller would set for an edge. */
+static void raise_edge(unsigned pin, uint32_t kind) {
+    simulated_interrupts.status[pin / 8] |= kind;
+}
+
+void setUp(void) {
+    memset(&simulated_interrupts, 0, sizeof(simulated_interrupts));
+    memset(simulated_pads, 0, sizeof(simulated_pads));
+    simulated_gpio_input = 0;
+    simulated_systick = (struct cortex_m_systick) {.reload_value = 0x00FFFFFF, .current_value = 0x00FFFFFF};
+    gpio_dispatch_use_registers(&simulated_interrupts, simulated_pads, &simulated_gpio_input, &simulated_systick);
+    gpio_dispatch_register((1UL << NUMBER_OF_PINS) - 1, NULL);
+    memset(&simulated_interrupts, 0, sizeof(simulated_interrupts));
+    gpio_dispatch_chain(NULL);
+    gpio_dispatch_reset_statistics();
+    for (unsigned pin = 0; pin < NUMBER_OF_PINS; pin++) {
+        pin_numbers[pin] = pin;
+    }
+    number_of_dispatches = 0;
+    chained_calls = 0;
+    plain_isr_calls = 0;
+}
+
+void tearDown(void) {}
+
+static void test_gather_nibbles_collects_bit_0_of_each_nibble(void) {
+    TEST_ASSERT_EQUAL_HEX32(0x00, gather_nibbles(0x00000000));
+    TEST_ASSERT_EQUAL_HEX32(0xFF, gather_nibbles(0x11111111));
+    TEST_ASSERT_EQUAL_HEX32(0xFF, gather_nibbles(0xFFFFFFFF));
+    TEST_ASSERT_EQUAL_HEX32(0x00, gather_nibbles(0xEEEEEEEE));
+    for (unsigned nibble = 0; nibble < 8; nibble++) {
+        TEST_ASSERT_EQUAL_HEX32(1u << nibble, gather_nibbles(0x1u << (4 * nibble)));
+    }
+    TEST_ASSERT_EQUAL_HEX32(0xA5, gather_nibbles(0x10100101));
+}
+
+static void test_each_pins_edges_reach_its_handler(void) {
+    gpio_dispatch_register_with_context((1UL << NUMBER_OF_PINS) - 1, record_pin_number, pin_numbers, sizeof(unsigned));
+    for (unsigned pin = 0; pin < NUMBER_OF_PINS; pin++) {
+        uint32_t kinds[] = {EDGE_LOW(pin), EDGE_HIGH(pin), EDGE_LOW(pin) | EDGE_HIGH(pin)};
+        for (int k = 0; k < 3; k++) {
+            number_of_dispatches = 0;
+            memset(simulated_interrupts.raw, 0, sizeof(simulated_interrupts.raw));
+            raise_edge(pin, kinds[k]);
+            gpio_dispatch_handle_interrupt();
+            TEST_ASSERT_EQUAL_INT(1, number_of_dispatches);
+            TEST_ASSERT_EQUAL_UINT(pin, dispatched_pins[0]);
+            TEST_ASSERT_EQUAL_HEX32(kinds[k], simulated_interrupts.raw[pin / 8]);      // acknowledged
+            simulated_interrupts.status[pin / 8] = 0;
+        }
+    }
+}
+
+static void test_pins_across_banks_are_dispatched_in_ascending_order(void) {
+    gpio_dispatch_register_with_context((1UL << NUMBER_OF_PINS) - 1, record_pin_number, pin_numbers, sizeof(unsigned));
+    unsigned pins[] = {0, 7, 8, 15, 16, 21, 22, 29};
+    for (int i = 7; i >= 0; i--) {
+        raise_edge(pins[i], (i & 1) ? EDGE_HIGH(pins[i]) : EDGE_LOW(pins[i]));
+    }
+    gpio_dispatch_handle_interrupt();
+    TEST_ASSERT_EQUAL_INT(8, number_of_dispatches);
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_UINT(pins[i], dispatched_pins[i]);
+    }
+    struct gpio_dispatch_statistics statistics = gpio_dispatch_get_statistics();
+    TEST_ASSERT_EQUAL_UINT32(1, statistics.interrupts);
+    TEST_ASSERT_EQUAL_UINT32(8, statistics.dispatches);
+}
+
+static void test_registration_configures_pads_and_enables(void) {
+    simulated_pads[2] = PAD_PULL_DOWN_ENABLE;
+    simulated_interrupts.raw[0] = EDGE_LOW(2);                  // an edge from before registration
+    gpio_dispatch_register((1UL << 2) | (1UL << 20), plain_isr);
+    TEST_ASSERT_EQUAL_HEX32(PAD_INPUT_ENABLE | PAD_PULL_UP_ENABLE, simulated_pads[2]);
+    TEST_ASSERT_EQUAL_HEX32(PAD_INPUT_ENABLE | PAD_PULL_UP_ENABLE, simulated_pads[20]);
+    TEST_ASSERT_EQUAL_HEX32(EDGE_LOW(2) | EDGE_HIGH(2), simulated_interrupts.enable[0]);
+    TEST_ASSERT_EQUAL_HEX32(EDGE_LOW(20) | EDGE_HIGH(20), simulated_interrupts.enable[2]);
+    TEST_ASSERT_EQUAL_HEX32(EDGE_LOW(2) | EDGE_HIGH(2), simulated_interrupts.raw[0]);     // stale edges discarded
+    raise_edge(20, EDGE_HIGH(20));
+    gpio_dispatch_handle_interrupt();
+    TEST_ASSERT_EQUAL_UINT(1, plain_isr_calls);
+    gpio_dispatch_register(1UL << 20, NULL);
+    TEST_ASSERT_EQUAL_HEX32(0, simulated_interrupts.enable[2]);
+    TEST_ASSERT_EQUAL_HEX32(EDGE_LOW(2) | EDGE_HIGH(2), simulated_interrupts.enable[0]);
+}
+
+static void test_context_handler_receives_its_pins_element(void) {
+    gpio_dispatch_register_with_context(1UL << 5, record_pin_number, pin_numbers, sizeof(unsigned));
+    raise_edge(5, EDGE_LOW(5));
+    gpio_dispatch_handle_interrupt();
+    TEST_ASSERT_EQUAL_INT(1, number_of_dispatches);
+    TEST_ASSERT_EQUAL_UINT(5, dispatched_pins[0]);
+}
+
+static void test_other_drivers_pins_go_to_chained_handler(void) {
+    gpio_dispatch_chain(previous_handler);
+    gpio_dispatch_register(1UL << 3, plain_isr);
+    simulated_interrupts.enable[1] |= EDGE_LOW(12) | EDGE_HIGH(12);     // as mbed::InterruptIn would
+    raise_edge(12, EDGE_HIGH(12));
+    gpio_dispatch_handle_interrupt();
+    TEST_ASSERT_EQUAL_UINT(0, plain_isr_calls);
+    TEST_ASSERT_EQUAL_UINT(1, chained_calls);
+    TEST_ASSERT_EQUAL_HEX32(0, simulated_interrupts.raw[1]);           // left for the chained handler to acknowledge
+    simulated_interrupts.status[1] = 0;
+
+    raise_edge(3, EDGE_LOW(3));
+    gpio_dispatch_handle_interrupt();
+    TEST_ASSERT_EQUAL_UINT(1, plain_isr_calls);
+    TEST_ASSERT_EQUAL_UINT(1, chained_calls);                          // nothing of its own was pending
+    simulated_interrupts.status[0] = 0;
+
+    raise_edge(12, LEVEL_LOW(12));                                      // other drivers' level interrupts, too
+    gpio_dispatch_handle_interrupt();
+    TEST_ASSERT_EQUAL_UINT(1, plain_isr_calls);
+    TEST_ASSERT_EQUAL_UINT(2, chained_calls);
+}
+
+static void test_unregistered_pins_are_not_acknowledged_without_a_chain(void) {
+    gpio_dispatch_register(1UL << 3, plain_isr);
+    raise_edge(12, EDGE_HIGH(12));
+    gpio_dispatch_handle_interrupt();
+    TEST_ASSERT_EQUAL_UINT(0, plain_isr_calls);
+    TEST_ASSERT_EQUAL_HEX32(0, simulated_interrupts.raw[1]);
+}
+
+static void test_read_pin_reads_gpio_input(void) {
+    simulated_gpio_input = (1UL << 4) | (1UL << 29);
+    TEST_ASSERT_TRUE(gpio_dispatch_read_pin(4));
+    TEST_ASSERT_FALSE(gpio_dispatch_read_pin(5));
+    TEST_ASSERT_TRUE(gpio_dispatch_read_pin(29));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_gather_nibbles_collects_bit_0_of_each_nibble);
+    RUN_TEST(test_each_pins_edges_reach_its_handler);
+    RUN_TEST(test_pins_across_banks_are_dispatched_in_ascending_order);
+    RUN_TEST(test_registration_configures_pads_and_enables);
+    RUN_TEST(test_context_handler_receives_its_pins_element);
+    RUN_TEST(test_other_drivers_pins_go_to_chained_handler);
+    RUN_TEST(test_unregistered_pins_are_not_acknowledged_without_a_chain);
+    RUN_TEST(test_read_pin_reads_gpio_input);
+    return UNITY_END();
+}
@@ -0,0 +1,151 @@
+/**************************************************************************//**
+ *
+ * @file test_isr_instrumentation.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for isr-instrumentation.c's latency and cycle
+ *      measurements, its log2 histograms, and its handling of periodic ISRs
+ *      that run early or a whole period late.
+ *
+ * The probes read a simulated clock and a SysTick in ordinary memory; the
+ * measured ISR advances both by however much the test asks it to.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#define ISR_INSTRUMENTATION
+#include <unity.h>
+#include "isr-instrumentation.c"
+
+#define SYSTICK_RELOAD  (0x00FFFFFF)
+#define PERIOD_us       (1000)
+
+static uint32_t simulated_time_us;
+static struct cortex_m_systick simulated_systick;
+static uint32_t isr_cycles;                     // how long the next ISR runs
+static unsigned isr_calls;
+
+uint32_t get_microseconds(void) {
+    return simulated_time_us;
+}
+
+/* Counts SysTick down by `cycles`, wrapping to the reload value as the hardware does. */
+static void consume_cycles(uint32_t cycles) {
+    uint32_t current = simulated_systick.current_value;
+    simulated_systick.current_value = (cycles <= current)
+                                      ? current - cycles
+                                      : current + SYSTICK_RELOAD + 1 - cycles;
+}
+
+static void measured_isr(void) {
+    isr_calls++;
+    consume_cycles(isr_cycles);
+}
+
+static struct isr_probe probe;
+
+/* Runs the probe's ISR at `time_us`, taking `cycles` cycles. */
+static void run_at(uint32_t time_us, uint32_t triggered_us, uint32_t cycles) {
+    simulated_time_us = time_us;
+    isr_cycles = cycles;
+    isr_probe_run(&probe, triggered_us);
+}
+
+void setUp(void) {
+    simulated_time_us = 5000;
+    simulated_systick = (struct cortex_m_systick) {.reload_value = SYSTICK_RELOAD, .current_value = SYSTICK_RELOAD};
+    isr_calls = 0;
+    isr_instrumentation_use_clock(get_microseconds, &simulated_systick);
+}
+
+void tearDown(void) {}
+
+static void test_buckets_are_log2_with_zero_and_overflow_in_the_end_buckets(void) {
+    TEST_ASSERT_EQUAL_UINT(0, log2_bucket(0));
+    TEST_ASSERT_EQUAL_UINT(0, log2_bucket(1));
+    TEST_ASSERT_EQUAL_UINT(1, log2_bucket(2));
+    TEST_ASSERT_EQUAL_UINT(1, log2_bucket(3));
+    TEST_ASSERT_EQUAL_UINT(10, log2_bucket(1024));
+    TEST_ASSERT_EQUAL_UINT(ISR_HISTOGRAM_BUCKETS - 1, log2_bucket(1UL << (ISR_HISTOGRAM_BUCKETS - 1)));
+    TEST_ASSERT_EQUAL_UINT(ISR_HISTOGRAM_BUCKETS - 1, log2_bucket(0xFFFFFFFF));
+}
+
+static void test_pin_probe_records_cycles_and_latency(void) {
+    isr_probe_initialize(&probe, measured_isr, 'p', 16, 0);
+    run_at(5000, 5000, 0);
+    run_at(6003, 6000, 100);
+    run_at(7040, 7000, 100);
+    run_at(8000, 7990, 70000);
+    TEST_ASSERT_EQUAL_UINT(4, isr_calls);
+    TEST_ASSERT_EQUAL_UINT32(4, probe.calls);
+    TEST_ASSERT_EQUAL_UINT64(70200, probe.total_cycles);
+    TEST_ASSERT_EQUAL_UINT32(70000, probe.maximum_cycles);
+    TEST_ASSERT_EQUAL_UINT32(40, probe.maximum_latency_us);
+    uint32_t expected_cycles[ISR_HISTOGRAM_BUCKETS] = {[0] = 1, [6] = 2, [ISR_HISTOGRAM_BUCKETS - 1] = 1};
+    uint32_t expected_latencies[ISR_HISTOGRAM_BUCKETS] = {[0] = 1, [1] = 1, [3] = 1, [5] = 1};
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected_cycles, probe.cycle_histogram, ISR_HISTOGRAM_BUCKETS);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected_latencies, probe.latency_histogram, ISR_HISTOGRAM_BUCKETS);
+}
+
+static void test_cycles_are_counted_across_systick_wraparound(void) {
+    isr_probe_initialize(&probe, measured_isr, 'p', 16, 0);
+    simulated_systick.current_value = 10;
+    run_at(5000, 5000, 30);
+    TEST_ASSERT_EQUAL_UINT32(30, probe.maximum_cycles);
+}
+
+static void test_periodic_latency_is_measured_against_the_schedule(void) {
+    isr_probe_initialize(&probe, measured_isr, 't', 3, PERIOD_us);
+    TEST_ASSERT_EQUAL_UINT32(5000 + PERIOD_us, probe.expected_us);
+    run_at(5000 + PERIOD_us + 7, 0, 10);
+    run_at(5000 + 2 * PERIOD_us + 3, 0, 10);        // the schedule does not drift with the latency
+    run_at(5000 + 3 * PERIOD_us + 12, 0, 10);
+    TEST_ASSERT_EQUAL_UINT32(12, probe.maximum_latency_us);
+    TEST_ASSERT_EQUAL_UINT32(5000 + 4 * PERIOD_us, probe.expected_us);
+}
+
+static void test_late_period_restarts_the_schedule(void) {
+    isr_probe_initialize(&probe, measured_isr, 't', 3, PERIOD_us);
+    uint32_t late_us = 5000 + 2 * PERIOD_us + 5;    // a whole period and then some after it was due
+    run_at(late_us, 0, 10);
+    TEST_ASSERT_EQUAL_UINT32(0, probe.maximum_latency_us);
+    TEST_ASSERT_EQUAL_UINT32(late_us + PERIOD_us, probe.expected_us);
+    run_at(late_us + PERIOD_us + 4, 0, 10);
+    TEST_ASSERT_EQUAL_UINT32(4, probe.maximum_latency_us);
+    TEST_ASSERT_EQUAL_UINT32(1, probe.latency_histogram[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, probe.latency_histogram[2]);
+}
+
+static void test_early_period_restarts_the_schedule(void) {
+    isr_probe_initialize(&probe, measured_isr, 't', 3, PERIOD_us);
+    run_at(5000 + PERIOD_us - 20, 0, 10);
+    TEST_ASSERT_EQUAL_UINT32(0, probe.maximum_latency_us);
+    TEST_ASSERT_EQUAL_UINT32(5000 + 2 * PERIOD_us - 20, probe.expected_us);
+}
+
+static void test_without_a_systick_cycles_are_zero(void) {
+    isr_instrumentation_use_clock(get_microseconds, NULL);
+    isr_probe_initialize(&probe, measured_isr, 'p', 16, 0);
+    run_at(5000, 5000, 500);
+    TEST_ASSERT_EQUAL_UINT(1, isr_calls);
+    TEST_ASSERT_EQUAL_UINT32(0, probe.maximum_cycles);
+    TEST_ASSERT_EQUAL_UINT32(1, probe.cycle_histogram[0]);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_buckets_are_log2_with_zero_and_overflow_in_the_end_buckets);
+    RUN_TEST(test_pin_probe_records_cycles_and_latency);
+    RUN_TEST(test_cycles_are_counted_across_systick_wraparound);
+    RUN_TEST(test_periodic_latency_is_measured_against_the_schedule);
+    RUN_TEST(test_late_period_restarts_the_schedule);
+    RUN_TEST(test_early_period_restarts_the_schedule);
+    RUN_TEST(test_without_a_systick_cycles_are_zero);
+    return UNITY_END();
+}
@@ -0,0 +1,165 @@
+/**************************************************************************//**
+ *
+ * @file test_led_pattern.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for led-pattern.c, running over the timer wheel with the
+ *      CowPi's LEDs faked.
+ *
+ * The fakes remember the LEDs' levels, and each tick records any change along
+ * with the tick on which it happened, so that the tests can check the whole
+ * on/off sequence and the tick on which a pattern reports that it ended.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "timer-wheel.c"
+#include "led-pattern.c"
+
+#define TICK_us         (1000)
+#define MAXIMUM_CHANGES (64)
+
+/* fakes for the CowPi's LEDs */
+
+static uint8_t lit_leds;
+
+void cowpi_illuminate_left_led(void) {
+    lit_leds |= LED_PATTERN_LEFT;
+}
+
+void cowpi_illuminate_right_led(void) {
+    lit_leds |= LED_PATTERN_RIGHT;
+}
+
+void cowpi_deluminate_left_led(void) {
+    lit_leds &= ~LED_PATTERN_LEFT;
+}
+
+void cowpi_deluminate_right_led(void) {
+    lit_leds &= ~LED_PATTERN_RIGHT;
+}
+
+struct led_change {
+    uint32_t tick;
+    uint8_t leds;
+};
+
+static struct led_change changes[MAXIMUM_CHANGES];
+static int number_of_changes;
+static uint8_t previous_leds;
+static unsigned completions;
+static uint32_t completion_tick;
+
+static void record_completion(void) {
+    completions++;
+    completion_tick = timer_wheel_now();
+}
+
+static void run_ticks(uint32_t ticks) {
+    for (uint32_t i = 0; i < ticks; i++) {
+        timer_wheel_tick();
+        if (lit_leds != previous_leds && number_of_changes < MAXIMUM_CHANGES) {
+            changes[number_of_changes++] = (struct led_change) {.tick = timer_wheel_now(), .leds = lit_leds};
+        }
+        previous_leds = lit_leds;
+    }
+}
+
+static void assert_changes(struct led_change const *expected, int number_expected) {
+    TEST_ASSERT_EQUAL_INT(number_expected, number_of_changes);
+    for (int i = 0; i < number_expected; i++) {
+        TEST_ASSERT_EQUAL_UINT32(expected[i].tick, changes[i].tick);
+        TEST_ASSERT_EQUAL_UINT8(expected[i].leds, changes[i].leds);
+    }
+}
+
+void setUp(void) {
+    timer_wheel_initialize(TICK_us, NULL);
+    memset(&pattern_timer, 0, sizeof(pattern_timer));
+    is_running = false;
+    leds_are_on = false;
+    lit_leds = 0;
+    previous_leds = 0;
+    number_of_changes = 0;
+    completions = 0;
+    completion_tick = 0;
+}
+
+void tearDown(void) {}
+
+static void test_finite_pattern_blinks_then_completes_once(void) {
+    struct led_pattern const twice = {
+            .leds = LED_PATTERN_LEFT, .on_time_us = 3 * TICK_us, .off_time_us = 2 * TICK_us, .repetitions = 2,
+            .on_complete = record_completion
+    };
+    led_pattern_start(&twice);
+    TEST_ASSERT_EQUAL_UINT8(LED_PATTERN_LEFT, lit_leds);   // it begins illuminated
+    previous_leds = lit_leds;
+    TEST_ASSERT_TRUE(led_pattern_is_running());
+    run_ticks(9);
+    TEST_ASSERT_TRUE(led_pattern_is_running());             // the last off time has not yet passed
+    TEST_ASSERT_EQUAL_UINT(0, completions);
+    run_ticks(1);
+    TEST_ASSERT_FALSE(led_pattern_is_running());
+    TEST_ASSERT_EQUAL_UINT(1, completions);
+    TEST_ASSERT_EQUAL_UINT32(10, completion_tick);
+    run_ticks(100);
+    TEST_ASSERT_EQUAL_UINT(1, completions);
+    struct led_change const expected[] = {{3, 0}, {5, LED_PATTERN_LEFT}, {8, 0}};
+    assert_changes(expected, sizeof(expected) / sizeof(expected[0]));
+}
+
+static void test_forever_pattern_never_completes(void) {
+    struct led_pattern const forever = {
+            .leds = LED_PATTERN_BOTH, .on_time_us = TICK_us, .off_time_us = TICK_us,
+            .repetitions = LED_PATTERN_FOREVER, .on_complete = record_completion
+    };
+    led_pattern_start(&forever);
+    previous_leds = lit_leds;
+    run_ticks(1000);
+    TEST_ASSERT_TRUE(led_pattern_is_running());
+    TEST_ASSERT_EQUAL_UINT(0, completions);
+    TEST_ASSERT_EQUAL_INT(MAXIMUM_CHANGES, number_of_changes);
+    for (int i = 0; i < number_of_changes; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i + 1, changes[i].tick);
+        TEST_ASSERT_EQUAL_UINT8((i % 2) ? LED_PATTERN_BOTH : 0, changes[i].leds);
+    }
+}
+
+static void test_stopped_or_replaced_pattern_does_not_complete(void) {
+    struct led_pattern const once = {
+            .leds = LED_PATTERN_RIGHT, .on_time_us = 2 * TICK_us, .off_time_us = 2 * TICK_us, .repetitions = 1,
+            .on_complete = record_completion
+    };
+    struct led_pattern const silent = {
+            .leds = LED_PATTERN_LEFT, .on_time_us = TICK_us, .off_time_us = TICK_us, .repetitions = 1
+    };
+    led_pattern_start(&once);
+    run_ticks(1);
+    led_pattern_stop();
+    TEST_ASSERT_EQUAL_UINT8(0, lit_leds);
+    run_ticks(10);
+    TEST_ASSERT_EQUAL_UINT(0, completions);
+    led_pattern_start(&once);
+    run_ticks(3);
+    led_pattern_start(&silent);                             // replaced during its off time
+    run_ticks(10);
+    TEST_ASSERT_FALSE(led_pattern_is_running());            // the replacement ran out, without a callback to call
+    TEST_ASSERT_EQUAL_UINT(0, completions);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_finite_pattern_blinks_then_completes_once);
+    RUN_TEST(test_forever_pattern_never_completes);
+    RUN_TEST(test_stopped_or_replaced_pattern_does_not_complete);
+    return UNITY_END();
+}
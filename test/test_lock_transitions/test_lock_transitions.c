@@ -0,0 +1,386 @@
+/**************************************************************************//**
+ *
+ * @file test_lock_transitions.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for the root lock-controller.c's transition table, and a
+ *      benchmark of its dispatch against the if/else controller it replaced.
+ *
+ * The exhaustive test dispatches every event in every state from the same
+ * mid-entry context, and compares everything that the controller can change
+ * -- its state, its variables, the display, the servo, and the LEDs --
+ * against an expectation that is written out here independently of the
+ * table. A pair that the expectations do not list must change nothing.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+#include "../../lock-controller.c"
+
+#define BENCHMARK_ITERATIONS (1000000)
+
+void previous_initialize_lock_controller(void);
+void previous_control_lock(void);
+
+/* fakes for the controller's dependencies, shared with previous_lock_controller.c */
+
+static char displayed[22];
+static unsigned display_writes;
+static unsigned clockwise_rotations;
+static unsigned counterclockwise_rotations;
+static struct led_pattern const *started_pattern;
+static direction_t simulated_direction;
+static bool is_left_button_pressed;
+static bool is_right_button_pressed;
+static bool is_left_switch_left;
+static uint8_t simulated_key;
+static bool is_pattern_running;
+
+void display_string(int row, char const string[]) {
+    strncpy(displayed, string, sizeof(displayed) - 1);
+    display_writes++;
+}
+
+direction_t get_direction() {
+    return simulated_direction;
+}
+
+void rotate_full_clockwise() {
+    clockwise_rotations++;
+}
+
+void rotate_full_counterclockwise() {
+    counterclockwise_rotations++;
+}
+
+void led_pattern_start(struct led_pattern const *pattern) {
+    started_pattern = pattern;
+}
+
+bool led_pattern_is_running(void) {
+    return is_pattern_running;
+}
+
+void lock_tasks_post_input_change(void) {}
+
+bool cowpi_left_button_is_pressed(void) {
+    return is_left_button_pressed;
+}
+
+bool cowpi_right_button_is_pressed(void) {
+    return is_right_button_pressed;
+}
+
+bool cowpi_left_switch_is_in_left_position(void) {
+    return is_left_switch_left;
+}
+
+bool cowpi_left_switch_is_in_right_position(void) {
+    return !is_left_switch_left;
+}
+
+uint8_t cowpi_get_keypress(void) {
+    return simulated_key;
+}
+
+/* everything that a transition can change */
+
+struct lock_context {
+    lock_state_t state;
+    int entered_combination[COMBO_LENGTH];
+    int current_value;
+    int first_seen_count;
+    int second_seen_count;
+    int third_seen_count;
+    int bad_attempts;
+    bool user_has_interacted;
+    uint8_t combination[COMBO_LENGTH];
+    int new_combo1[6];
+    int new_combo2[6];
+    int input_index;
+    int confirm_phase;
+    char displayed[22];
+    unsigned display_writes;
+    unsigned clockwise_rotations;
+    unsigned counterclockwise_rotations;
+    struct led_pattern const *started_pattern;
+};
+
+static void capture(struct lock_context *context) {
+    memset(context, 0, sizeof(*context));
+    context->state = current_state;
+    memcpy(context->entered_combination, entered_combination, sizeof(entered_combination));
+    context->current_value = current_value;
+    context->first_seen_count = first_seen_count;
+    context->second_seen_count = second_seen_count;
+    context->third_seen_count = third_seen_count;
+    context->bad_attempts = bad_attempts;
+    context->user_has_interacted = user_has_interacted;
+    memcpy(context->combination, combination, sizeof(combination));
+    memcpy(context->new_combo1, new_combo1, sizeof(new_combo1));
+    memcpy(context->new_combo2, new_combo2, sizeof(new_combo2));
+    context->input_index = input_index;
+    context->confirm_phase = confirm_phase;
+    memcpy(context->displayed, displayed, sizeof(displayed));
+    context->display_writes = display_writes;
+    context->clockwise_rotations = clockwise_rotations;
+    context->counterclockwise_rotations = counterclockwise_rotations;
+    context->started_pattern = started_pattern;
+}
+
+/* a combination part-way through entry, and a new combination one digit short of confirmed */
+static void prepare(lock_state_t state) {
+    current_state = state;
+    force_combination_reset();
+    entered_combination[0] = 5;
+    entered_combination[1] = 10;
+    entered_combination[2] = -1;
+    current_value = 7;
+    first_seen_count = 3;
+    second_seen_count = 2;
+    third_seen_count = 1;
+    bad_attempts = 1;
+    user_has_interacted = true;
+    int const digits[6] = {0, 3, 1, 1, 1, 4};
+    memcpy(new_combo1, digits, sizeof(digits));
+    memcpy(new_combo2, digits, sizeof(digits));
+    new_combo2[5] = -1;
+    input_index = 5;
+    confirm_phase = 1;
+    last_digit = 4;
+    strcpy(displayed, "");
+    display_writes = 0;
+    clockwise_rotations = 0;
+    counterclockwise_rotations = 0;
+    started_pattern = NULL;
+}
+
+/* expected effects, applied to the context captured before the event */
+
+static void display(struct lock_context *expected, char const *string) {
+    memset(expected->displayed, 0, sizeof(expected->displayed));
+    strcpy(expected->displayed, string);
+    expected->display_writes++;
+}
+
+static void expect_reset_entry(struct lock_context *expected) {
+    for (int i = 0; i < COMBO_LENGTH; i++) {
+        expected->entered_combination[i] = -1;
+    }
+    expected->current_value = 0;
+    expected->first_seen_count = 0;
+    expected->second_seen_count = 0;
+    expected->third_seen_count = 0;
+    expected->user_has_interacted = false;
+}
+
+static void expect_step_up(struct lock_context *expected) {
+    expected->current_value = 8;
+}
+
+static void expect_step_down(struct lock_context *expected) {
+    expected->current_value = 6;
+}
+
+static void expect_first_number(struct lock_context *expected) {
+    expected->entered_combination[0] = 7;           // the number the dial was on before it reversed
+    expected->current_value = 0;
+}
+
+static void expect_second_number(struct lock_context *expected) {
+    expected->entered_combination[1] = 7;
+    expected->current_value = 0;
+}
+
+static void expect_open(struct lock_context *expected) {
+    display(expected, "OPEN");
+    expected->counterclockwise_rotations++;
+}
+
+static void expect_bad_try(struct lock_context *expected) {
+    expected->bad_attempts = 2;
+    display(expected, "bad try 2");
+    expected->started_pattern = &bad_try_pattern;
+}
+
+static void expect_alarm(struct lock_context *expected) {
+    expected->bad_attempts = 2;
+    display(expected, "alert!");
+    expected->started_pattern = &alarm_pattern;
+}
+
+static void expect_begin_change(struct lock_context *expected) {
+    display(expected, "enter - - -");
+    for (int i = 0; i < 6; i++) {
+        expected->new_combo1[i] = -1;
+        expected->new_combo2[i] = -1;
+    }
+    expected->input_index = 0;
+    expected->confirm_phase = 0;
+}
+
+static void expect_last_digit(struct lock_context *expected) {
+    expected->new_combo2[5] = 4;
+    expected->input_index = 6;
+}
+
+static void expect_incomplete_change(struct lock_context *expected) {
+    display(expected, "no change");
+}
+
+struct expected_transition {
+    lock_state_t state;
+    lock_event_t event;
+    lock_state_t next_state;
+    void (*expect)(struct lock_context *expected);
+};
+
+static struct expected_transition const expected_transitions[] = {
+        {LOCKED_ENTERING_FIRST,  EVENT_CLOCKWISE,        LOCKED_ENTERING_FIRST,  expect_step_up},
+        {LOCKED_ENTERING_FIRST,  EVENT_COUNTERCLOCKWISE, LOCKED_ENTERING_SECOND, expect_first_number},
+        {LOCKED_ENTERING_SECOND, EVENT_OVERCOUNT,        LOCKED_ENTERING_FIRST,  expect_reset_entry},
+        {LOCKED_ENTERING_SECOND, EVENT_CLOCKWISE,        LOCKED_ENTERING_THIRD,  expect_second_number},
+        {LOCKED_ENTERING_SECOND, EVENT_COUNTERCLOCKWISE, LOCKED_ENTERING_SECOND, expect_step_down},
+        {LOCKED_ENTERING_THIRD,  EVENT_OVERCOUNT,        LOCKED_ENTERING_FIRST,  expect_reset_entry},
+        {LOCKED_ENTERING_THIRD,  EVENT_CLOCKWISE,        LOCKED_ENTERING_THIRD,  expect_step_up},
+        {LOCKED_ENTERING_THIRD,  EVENT_COUNTERCLOCKWISE, LOCKED_ENTERING_FIRST,  expect_reset_entry},
+        {LOCKED_ENTERING_THIRD,  EVENT_GOOD_ENTRY,       UNLOCKED,               expect_open},
+        {LOCKED_ENTERING_THIRD,  EVENT_BAD_ENTRY,        FAILED,                 expect_bad_try},
+        {LOCKED_ENTERING_THIRD,  EVENT_FINAL_BAD_ENTRY,  ALARMED,                expect_alarm},
+        {UNLOCKED,               EVENT_RELOCK,           LOCKED_ENTERING_FIRST,  expect_reset_entry},
+        {UNLOCKED,               EVENT_BEGIN_CHANGE,     CHANGING,               expect_begin_change},
+        {CHANGING,               EVENT_DIGIT,            CHANGING,               expect_last_digit},
+        {CHANGING,               EVENT_END_CHANGE,       UNLOCKED,               expect_incomplete_change},
+        {FAILED,                 EVENT_PATTERN_DONE,     LOCKED_ENTERING_FIRST,  expect_reset_entry},
+};
+
+#define NUMBER_OF_EXPECTED_TRANSITIONS (sizeof(expected_transitions) / sizeof(expected_transitions[0]))
+
+static struct expected_transition const *find_expected_transition(lock_state_t state, lock_event_t event) {
+    for (size_t i = 0; i < NUMBER_OF_EXPECTED_TRANSITIONS; i++) {
+        if (expected_transitions[i].state == state && expected_transitions[i].event == event) {
+            return &expected_transitions[i];
+        }
+    }
+    return NULL;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+void setUp(void) {
+    simulated_direction = STATIONARY;
+    is_left_button_pressed = false;
+    is_right_button_pressed = false;
+    is_left_switch_left = true;
+    simulated_key = 0xFF;
+    is_pattern_running = false;
+}
+
+void tearDown(void) {}
+
+static void test_every_state_and_event_pair(void) {
+    unsigned transitions_seen = 0;
+    for (lock_state_t state = 0; state < NUMBER_OF_LOCK_STATES; state++) {
+        for (lock_event_t event = 0; event < NUMBER_OF_LOCK_EVENTS; event++) {
+            char pair[40];
+            snprintf(pair, sizeof(pair), "state %d, event %d", (int) state, (int) event);
+            struct expected_transition const *transition = find_expected_transition(state, event);
+            struct lock_context expected, actual;
+            prepare(state);
+            capture(&expected);
+            if (transition) {
+                expected.state = transition->next_state;
+                transition->expect(&expected);
+                transitions_seen++;
+            }
+            bool is_state_changed = dispatch(event);
+            capture(&actual);
+            TEST_ASSERT_EQUAL_INT_MESSAGE(expected.state, actual.state, pair);
+            TEST_ASSERT_EQUAL_INT_MESSAGE(expected.state != state, is_state_changed, pair);
+            TEST_ASSERT_EQUAL_STRING_MESSAGE(expected.displayed, actual.displayed, pair);
+            TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&expected, &actual, sizeof(expected), pair);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT(NUMBER_OF_EXPECTED_TRANSITIONS, transitions_seen);
+}
+
+static void test_confirmed_change_replaces_combination(void) {
+    prepare(CHANGING);
+    TEST_ASSERT_FALSE(dispatch(EVENT_DIGIT));
+    TEST_ASSERT_TRUE(dispatch(EVENT_END_CHANGE));
+    TEST_ASSERT_EQUAL_INT(UNLOCKED, get_lock_state());
+    TEST_ASSERT_EQUAL_STRING("changed", displayed);
+    TEST_ASSERT_EQUAL_UINT8(3, combination[0]);
+    TEST_ASSERT_EQUAL_UINT8(11, combination[1]);
+    TEST_ASSERT_EQUAL_UINT8(14, combination[2]);
+    prepare(CHANGING);
+    new_combo1[0] = new_combo2[0] = 9;                  // 93 is not on the dial
+    dispatch(EVENT_DIGIT);
+    dispatch(EVENT_END_CHANGE);
+    TEST_ASSERT_EQUAL_STRING("no change", displayed);
+}
+
+static void test_first_state_changing_event_ends_the_pass(void) {
+    prepare(LOCKED_ENTERING_THIRD);
+    second_seen_count = 3;                              // over-counted: EVENT_OVERCOUNT comes first
+    simulated_direction = CLOCKWISE;
+    is_left_button_pressed = true;
+    control_lock();
+    TEST_ASSERT_EQUAL_INT(LOCKED_ENTERING_FIRST, get_lock_state());
+    TEST_ASSERT_EQUAL_INT(0, current_value);            // the turn was not also applied
+    TEST_ASSERT_EQUAL_INT(1, bad_attempts);             // nor was the entry judged
+}
+
+/* FAILED lasts as long as its pattern, so the pattern's end must wake the controller; the alarm never ends */
+static void test_bad_try_pattern_wakes_the_controller(void) {
+    TEST_ASSERT_EQUAL_PTR(lock_tasks_post_input_change, bad_try_pattern.on_complete);
+    TEST_ASSERT_NULL(alarm_pattern.on_complete);
+}
+
+static uint64_t time_passes(void (*initialize)(void), void (*control)(void)) {
+    initialize();
+    uint64_t start = now_ns();
+    for (int i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        control();
+    }
+    return now_ns() - start;
+}
+
+/* passes of both controllers while locked, with the dial turning and with it still */
+static void benchmark_dispatch(void) {
+    char message[112];
+    direction_t const directions[] = {CLOCKWISE, STATIONARY};
+    char const *descriptions[] = {"turning", "idle"};
+    for (int i = 0; i < 2; i++) {
+        simulated_direction = directions[i];
+        uint64_t previous_ns = time_passes(previous_initialize_lock_controller, previous_control_lock);
+        uint64_t table_ns = time_passes(initialize_lock_controller, control_lock);
+        TEST_ASSERT_EQUAL_INT(LOCKED_ENTERING_FIRST, get_lock_state());
+        snprintf(message, sizeof(message), "locked, %s: if/else %.1f ns, table %.1f ns per pass", descriptions[i],
+                 (double) previous_ns / BENCHMARK_ITERATIONS, (double) table_ns / BENCHMARK_ITERATIONS);
+        TEST_MESSAGE(message);
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_state_and_event_pair);
+    RUN_TEST(test_confirmed_change_replaces_combination);
+    RUN_TEST(test_first_state_changing_event_ends_the_pass);
+    RUN_TEST(test_bad_try_pattern_wakes_the_controller);
+    RUN_TEST(benchmark_dispatch);
+    return UNITY_END();
+}
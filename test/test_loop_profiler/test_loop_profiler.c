@@ -0,0 +1,133 @@
+/**************************************************************************//**
+ *
+ * @file test_loop_profiler.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for loop-profiler.c.
+ *
+ * `get_microseconds()` reads a simulated clock, so each test chooses the exact
+ * loop periods that the profiler sees.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#define LOOP_PROFILING
+
+#include <unity.h>
+#include "loop-profiler.c"
+
+static uint32_t simulated_time_us;
+
+/* fake for the module's dependency */
+
+uint32_t get_microseconds(void) {
+    return simulated_time_us;
+}
+
+/* helpers */
+
+static void run_loop_passes(uint32_t count, uint32_t period_us) {
+    for (uint32_t i = 0; i < count; i++) {
+        simulated_time_us += period_us;
+        mark_loop_iteration();
+    }
+}
+
+/* Starts a fresh window at the current time, as though the previous one had just been published. */
+static void start_window(void) {
+    run_loop_passes(1, WINDOW_LENGTH_us);
+}
+
+void setUp(void) {
+    simulated_time_us = 0;
+    loop_timestamp_us = 0;
+    window_start_us = 0;
+    iterations_in_window = 0;
+    minimum_period_us = UINT32_MAX;
+    maximum_period_us = 0;
+    memset(histogram, 0, sizeof(histogram));
+    memset(&published_profile, 0, sizeof(published_profile));
+    start_window();
+}
+
+void tearDown(void) {}
+
+static void test_nothing_is_published_before_the_window_ends(void) {
+    run_loop_passes(999, 1000);             // 1 ms short of a full window
+    TEST_ASSERT_EQUAL_UINT32(1, get_loop_profile().iterations_per_second);      // still the window from setUp
+    run_loop_passes(1, 1000);
+    TEST_ASSERT_EQUAL_UINT32(1000, get_loop_profile().iterations_per_second);
+}
+
+static void test_steady_loop_reports_rate_and_periods(void) {
+    run_loop_passes(4000, 250);
+    struct loop_profile profile = get_loop_profile();
+    TEST_ASSERT_EQUAL_UINT32(4000, profile.iterations_per_second);
+    TEST_ASSERT_EQUAL_UINT32(250, profile.minimum_period_us);
+    TEST_ASSERT_EQUAL_UINT32(250, profile.mean_period_us);
+    TEST_ASSERT_EQUAL_UINT32(250, profile.maximum_period_us);
+    /* the window's first pass has no period within the window, so it is counted but not binned */
+    TEST_ASSERT_EQUAL_UINT32(3999, profile.histogram[7]);                       // 128 <= 250 < 256
+}
+
+static void test_mixed_periods_fill_log2_buckets(void) {
+    run_loop_passes(1, 20);         // opens the window; its period is not binned
+    run_loop_passes(100, 0);        // bucket 0 also counts 0 us
+    run_loop_passes(100, 1);        // bucket 0
+    run_loop_passes(100, 3);        // bucket 1
+    run_loop_passes(100, 1024);     // bucket 10
+    run_loop_passes(10, 70000);     // beyond the last bucket's lower bound of 32768 us
+    run_loop_passes(1, 1000000 - 20 - 100 - 300 - 102400 - 700000);             // closes the window at exactly 1 s
+    struct loop_profile profile = get_loop_profile();
+    TEST_ASSERT_EQUAL_UINT32(412, profile.iterations_per_second);
+    TEST_ASSERT_EQUAL_UINT32(0, profile.minimum_period_us);
+    TEST_ASSERT_EQUAL_UINT32(1000000 / 412, profile.mean_period_us);
+    TEST_ASSERT_EQUAL_UINT32(197180, profile.maximum_period_us);
+    TEST_ASSERT_EQUAL_UINT32(200, profile.histogram[0]);
+    TEST_ASSERT_EQUAL_UINT32(100, profile.histogram[1]);
+    TEST_ASSERT_EQUAL_UINT32(100, profile.histogram[10]);
+    TEST_ASSERT_EQUAL_UINT32(10 + 1, profile.histogram[LOOP_PROFILE_BUCKETS - 1]);
+    uint32_t binned = 0;
+    for (int bucket = 0; bucket < LOOP_PROFILE_BUCKETS; bucket++) {
+        binned += profile.histogram[bucket];
+    }
+    TEST_ASSERT_EQUAL_UINT32(profile.iterations_per_second - 1, binned);
+}
+
+static void test_each_window_starts_afresh(void) {
+    run_loop_passes(100, 10000);
+    run_loop_passes(10, 100000);
+    struct loop_profile profile = get_loop_profile();
+    TEST_ASSERT_EQUAL_UINT32(10, profile.iterations_per_second);
+    TEST_ASSERT_EQUAL_UINT32(100000, profile.minimum_period_us);                // the 10 ms periods belong to the previous window
+    TEST_ASSERT_EQUAL_UINT32(0, profile.histogram[13]);
+    TEST_ASSERT_EQUAL_UINT32(9, profile.histogram[LOOP_PROFILE_BUCKETS - 1]);
+}
+
+static void test_clock_wraparound_is_harmless(void) {
+    simulated_time_us = UINT32_MAX - 500000;
+    loop_timestamp_us = simulated_time_us;
+    window_start_us = simulated_time_us;
+    iterations_in_window = 0;
+    run_loop_passes(1, 0);
+    run_loop_passes(2000, 500);
+    struct loop_profile profile = get_loop_profile();
+    TEST_ASSERT_EQUAL_UINT32(2001, profile.iterations_per_second);
+    TEST_ASSERT_EQUAL_UINT32(500, profile.maximum_period_us);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_nothing_is_published_before_the_window_ends);
+    RUN_TEST(test_steady_loop_reports_rate_and_periods);
+    RUN_TEST(test_mixed_periods_fill_log2_buckets);
+    RUN_TEST(test_each_window_starts_afresh);
+    RUN_TEST(test_clock_wraparound_is_harmless);
+    return UNITY_END();
+}
@@ -0,0 +1,193 @@
+/**************************************************************************//**
+ *
+ * @file test_pin_filter.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for pin-filter.c in both of its modes.
+ *
+ * The filter's clock is simulated: time advances only when a test says so,
+ * the pin's level is a variable, and the settling timer is a single pending
+ * deadline that fires when the simulated time reaches it.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <unity.h>
+#include "pin-filter.c"
+
+#define PIN                 (2)
+#define INTERVAL_us         (1000)
+
+static uint32_t simulated_time_us;
+static bool simulated_level;
+static struct pin_filter *settling_filter;
+static uint32_t settling_deadline_us;
+static unsigned isr_calls;
+
+static uint32_t now_us(void) {
+    return simulated_time_us;
+}
+
+static bool read_pin(uint8_t pin) {
+    return simulated_level;
+}
+
+static void start_settling_timer(struct pin_filter *filter, uint32_t delay_us) {
+    settling_filter = filter;
+    settling_deadline_us = simulated_time_us + delay_us;
+}
+
+static struct pin_filter_clock const clock = {
+        .now_us = now_us,
+        .read_pin = read_pin,
+        .start_settling_timer = start_settling_timer,
+};
+
+static void count_isr_call(void) {
+    isr_calls++;
+}
+
+static struct pin_filter filter;
+
+/* Moves the simulated time forward, firing the settling timer if its deadline passes. */
+static void advance(uint32_t delay_us) {
+    uint32_t end = simulated_time_us + delay_us;
+    if (settling_filter != NULL && (int32_t) (settling_deadline_us - end) <= 0) {
+        simulated_time_us = settling_deadline_us;
+        struct pin_filter *expired = settling_filter;
+        settling_filter = NULL;
+        pin_filter_handle_settling_timeout(expired);
+    }
+    simulated_time_us = end;
+}
+
+/* Changes the pin's level and reports the edge to the filter, as the pin's interrupt would. */
+static void edge(bool level) {
+    simulated_level = level;
+    pin_filter_handle_edge(&filter);
+}
+
+void setUp(void) {
+    simulated_time_us = 0xFFFFF000;        // close enough to wrap during a test
+    simulated_level = true;
+    settling_filter = NULL;
+    isr_calls = 0;
+}
+
+void tearDown(void) {}
+
+/* PIN_FILTER_MINIMUM_INTERVAL */
+
+static void test_first_edge_passes_immediately(void) {
+    pin_filter_initialize(&filter, PIN, count_isr_call, PIN_FILTER_MINIMUM_INTERVAL, INTERVAL_us, &clock);
+    edge(false);
+    TEST_ASSERT_EQUAL_UINT(1, isr_calls);
+    TEST_ASSERT_EQUAL_UINT32(0, pin_filter_get_rejected_edge_count(&filter));
+}
+
+static void test_edges_within_the_interval_are_rejected_and_counted(void) {
+    pin_filter_initialize(&filter, PIN, count_isr_call, PIN_FILTER_MINIMUM_INTERVAL, INTERVAL_us, &clock);
+    edge(false);
+    advance(50);
+    edge(true);
+    advance(50);
+    edge(false);
+    advance(INTERVAL_us - 101);
+    edge(true);
+    TEST_ASSERT_EQUAL_UINT(1, isr_calls);
+    TEST_ASSERT_EQUAL_UINT32(3, pin_filter_get_rejected_edge_count(&filter));
+}
+
+static void test_edge_after_the_interval_passes_across_wraparound(void) {
+    pin_filter_initialize(&filter, PIN, count_isr_call, PIN_FILTER_MINIMUM_INTERVAL, INTERVAL_us, &clock);
+    for (int i = 0; i < 8; i++) {                   // the clock wraps partway through
+        edge(i & 1);
+        advance(INTERVAL_us);
+    }
+    TEST_ASSERT_EQUAL_UINT(8, isr_calls);
+    TEST_ASSERT_EQUAL_UINT32(0, pin_filter_get_rejected_edge_count(&filter));
+}
+
+/* PIN_FILTER_SETTLE_THEN_CONFIRM */
+
+static void test_settled_change_passes_once_after_the_settling_time(void) {
+    pin_filter_initialize(&filter, PIN, count_isr_call, PIN_FILTER_SETTLE_THEN_CONFIRM, INTERVAL_us, &clock);
+    edge(false);
+    advance(INTERVAL_us - 1);
+    TEST_ASSERT_EQUAL_UINT(0, isr_calls);
+    advance(1);
+    TEST_ASSERT_EQUAL_UINT(1, isr_calls);
+    TEST_ASSERT_FALSE(filter.accepted_level);
+    TEST_ASSERT_EQUAL_UINT32(0, pin_filter_get_rejected_edge_count(&filter));
+}
+
+static void test_bounces_restart_the_settling_time(void) {
+    pin_filter_initialize(&filter, PIN, count_isr_call, PIN_FILTER_SETTLE_THEN_CONFIRM, INTERVAL_us, &clock);
+    edge(false);
+    advance(300);
+    edge(true);
+    advance(300);
+    edge(false);
+    advance(INTERVAL_us - 1);                       // would have expired had the first edge's timer not been restarted
+    TEST_ASSERT_EQUAL_UINT(0, isr_calls);
+    advance(1);
+    TEST_ASSERT_EQUAL_UINT(1, isr_calls);
+    TEST_ASSERT_EQUAL_UINT32(2, pin_filter_get_rejected_edge_count(&filter));
+}
+
+static void test_bounce_back_to_the_accepted_level_is_rejected(void) {
+    pin_filter_initialize(&filter, PIN, count_isr_call, PIN_FILTER_SETTLE_THEN_CONFIRM, INTERVAL_us, &clock);
+    edge(false);
+    advance(20);
+    edge(true);
+    advance(2 * INTERVAL_us);
+    TEST_ASSERT_EQUAL_UINT(0, isr_calls);
+    TEST_ASSERT_TRUE(filter.accepted_level);
+    TEST_ASSERT_EQUAL_UINT32(2, pin_filter_get_rejected_edge_count(&filter));    // the superseded edge and the bounce-back
+}
+
+static void test_press_and_release_each_pass_once(void) {
+    pin_filter_initialize(&filter, PIN, count_isr_call, PIN_FILTER_SETTLE_THEN_CONFIRM, INTERVAL_us, &clock);
+    bool level = true;
+    for (int change = 0; change < 6; change++) {
+        level = !level;
+        for (int bounce = 0; bounce < 4; bounce++) {
+            edge(!level);
+            advance(40);
+            edge(level);
+            advance(40);
+        }
+        advance(5 * INTERVAL_us);
+        TEST_ASSERT_EQUAL_UINT(change + 1, isr_calls);
+        TEST_ASSERT_EQUAL(level, filter.accepted_level);
+    }
+    TEST_ASSERT_EQUAL_UINT32(6 * 7, pin_filter_get_rejected_edge_count(&filter));
+}
+
+static void test_reinitializing_abandons_the_settling_time(void) {
+    pin_filter_initialize(&filter, PIN, count_isr_call, PIN_FILTER_SETTLE_THEN_CONFIRM, INTERVAL_us, &clock);
+    edge(false);
+    pin_filter_initialize(&filter, PIN, count_isr_call, PIN_FILTER_SETTLE_THEN_CONFIRM, INTERVAL_us, &clock);
+    advance(2 * INTERVAL_us);                       // a timeout that was not cancelled still arrives
+    TEST_ASSERT_EQUAL_UINT(0, isr_calls);
+    TEST_ASSERT_FALSE(filter.accepted_level);       // the new filter took the pin's level as it found it
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_edge_passes_immediately);
+    RUN_TEST(test_edges_within_the_interval_are_rejected_and_counted);
+    RUN_TEST(test_edge_after_the_interval_passes_across_wraparound);
+    RUN_TEST(test_settled_change_passes_once_after_the_settling_time);
+    RUN_TEST(test_bounces_restart_the_settling_time);
+    RUN_TEST(test_bounce_back_to_the_accepted_level_is_rejected);
+    RUN_TEST(test_press_and_release_each_pass_once);
+    RUN_TEST(test_reinitializing_abandons_the_settling_time);
+    return UNITY_END();
+}
@@ -0,0 +1,68 @@
+/**************************************************************************//**
+ *
+ * @file spin_profiles.h
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Step-timestamp traces of hand spins, for replay through the rotary
+ *      encoder's velocity estimate and acceleration curve.
+ *
+ * Each trace lists the steps of one spin in the form that
+ * `drain_encoder_events()` reports them: the step's timestamp in microseconds
+ * and its direction. The traces are shaped after turns of a 20-detent encoder
+ * by hand:
+ * <ul>
+ * <li> a slow, deliberate turn of 15 detents, 140-260 ms apart, as when
+ *      dialing a number precisely;
+ * <li> a flick that speeds up to about 18 ms per detent and then coasts to a
+ *      stop;
+ * <li> a quick spin that overshoots, a pause, and three slow corrections back.
+ * </ul>
+ * To replay a captured spin, add its steps here in the same form.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#ifndef COMBOLOCK_SPIN_PROFILES_H
+#define COMBOLOCK_SPIN_PROFILES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "rotary-encoder.h"
+
+struct spin_step {
+    uint32_t timestamp_us;
+    direction_t direction;
+};
+
+static struct spin_step const slow_turn[] = {
+        {1178859, CLOCKWISE}, {1336960, CLOCKWISE}, {1555072, CLOCKWISE}, {1703764, CLOCKWISE},
+        {1908069, CLOCKWISE}, {2091951, CLOCKWISE}, {2238910, CLOCKWISE}, {2439802, CLOCKWISE},
+        {2584301, CLOCKWISE}, {2776338, CLOCKWISE}, {2924720, CLOCKWISE}, {3075605, CLOCKWISE},
+        {3266547, CLOCKWISE}, {3505769, CLOCKWISE}, {3660625, CLOCKWISE},
+};
+
+static struct spin_step const flick[] = {
+        {1085018, CLOCKWISE}, {1156802, CLOCKWISE}, {1213458, CLOCKWISE}, {1254074, CLOCKWISE},
+        {1284433, CLOCKWISE}, {1311814, CLOCKWISE}, {1330909, CLOCKWISE}, {1351271, CLOCKWISE},
+        {1368513, CLOCKWISE}, {1385696, CLOCKWISE}, {1404167, CLOCKWISE}, {1427247, CLOCKWISE},
+        {1459143, CLOCKWISE}, {1494716, CLOCKWISE}, {1545532, CLOCKWISE}, {1612337, CLOCKWISE},
+        {1695167, CLOCKWISE}, {1806217, CLOCKWISE},
+};
+
+static struct spin_step const spin_and_correct[] = {
+        {1059428, CLOCKWISE}, {1099906, CLOCKWISE}, {1130281, CLOCKWISE}, {1152129, CLOCKWISE},
+        {1172160, CLOCKWISE}, {1190474, CLOCKWISE}, {1206401, CLOCKWISE}, {1223441, CLOCKWISE},
+        {1241908, CLOCKWISE}, {1263079, CLOCKWISE}, {1285130, CLOCKWISE}, {1313950, CLOCKWISE},
+        {1348839, CLOCKWISE},
+        {2045996, COUNTERCLOCKWISE}, {2309208, COUNTERCLOCKWISE}, {2494233, COUNTERCLOCKWISE},
+};
+
+#define NUMBER_OF_STEPS(trace) (sizeof(trace) / sizeof((trace)[0]))
+
+#endif //COMBOLOCK_SPIN_PROFILES_H
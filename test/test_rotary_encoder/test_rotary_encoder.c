@@ -0,0 +1,715 @@
+/**************************************************************************//**
+ *
+ * @file test_rotary_encoder.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for the rotary encoder's quadrature decoding, its queue
+ *      of step events, its velocity estimate and acceleration curve, its
+ *      deferral of step bookkeeping to the work queue, and its debouncing
+ *      timer-sampled mode.
+ *
+ * The suite includes rotary-encoder.c directly so that it can drive the
+ * decoder's ISRs and inspect its state. The wipers are read from a variable
+ * in place of SIO's GPIO_IN register, and `get_microseconds()` reads a simulated clock.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#define __MBED__                    // the firmware targets the Arduino mbed core
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+#include "rotary-encoder.c"
+#include "work-queue.c"
+#include "spin_profiles.h"
+
+static uint32_t simulated_gpio_input;
+static uint32_t simulated_time_us;
+
+/* fakes for the module's dependencies */
+
+uint32_t get_microseconds(void) {
+    return simulated_time_us;
+}
+
+void cowpi_set_pullup_input_pins(uint32_t pin_mask) {}
+
+static uint32_t filtered_pins;
+static void (*filtered_pin_isr)(void);
+static pin_filter_mode_t filter_mode;
+static uint32_t rejected_edges[32];
+
+void register_filtered_pin_ISR(uint32_t interrupt_mask, void (*isr)(void), pin_filter_mode_t mode, uint32_t interval_us) {
+    filtered_pins = interrupt_mask;
+    filtered_pin_isr = isr;
+    filter_mode = mode;
+}
+
+uint32_t get_rejected_edge_count(unsigned int pin) {
+    return rejected_edges[pin];
+}
+
+bool register_periodic_timer_ISR(unsigned int timer_number, uint32_t period_us, void (*isr)(void)) {
+    return true;
+}
+
+void stop_periodic_timer(unsigned int timer_number) {}
+
+/* helpers */
+
+static void set_wipers(uint8_t quadrature) {
+    simulated_gpio_input = (uint32_t) quadrature << A_WIPER_PIN;
+}
+
+/* presents each state to the pin-change ISR, as each edge would */
+static void present(uint8_t const states[], size_t number_of_states) {
+    for (size_t i = 0; i < number_of_states; i++) {
+        set_wipers(states[i]);
+        handle_quadrature_interrupt();
+    }
+}
+
+static uint8_t const clockwise_cycle[] = {0b10, 0b00, 0b01, 0b11};
+static uint8_t const counterclockwise_cycle[] = {0b01, 0b00, 0b10, 0b11};
+
+static size_t drain_all(void) {
+    encoder_event_t events[EVENT_QUEUE_LENGTH];
+    return drain_encoder_events(events, EVENT_QUEUE_LENGTH);
+}
+
+void setUp(void) {
+    rotary_encoder_use_registers(&simulated_gpio_input);
+    set_wipers(0b11);
+    previous_quadrature = 0b11;
+    set_encoder_resolution(ENCODER_1X, 1);
+    clockwise_count = 0;
+    counterclockwise_count = 0;
+    illegal_transition_count = 0;
+    drain_all();
+    event_overflow_count = 0;
+    set_encoder_event_callback(NULL);
+    set_encoder_acceleration(NULL, 0);
+    set_encoder_step_deferral(false);
+    work_queue_initialize();
+    memset(rejected_edges, 0, sizeof(rejected_edges));
+}
+
+void tearDown(void) {
+    set_wipers(0b11);
+    set_encoder_mode(ENCODER_INTERRUPT_DRIVEN, 0);
+}
+
+/* quadrature decoding (user-008) */
+
+static void test_transition_table_is_antisymmetric(void) {
+    for (uint8_t from = 0; from < 4; from++) {
+        for (uint8_t to = 0; to < 4; to++) {
+            int8_t forward = transitions[(from << 2) | to];
+            int8_t backward = transitions[(to << 2) | from];
+            if (from == to) {
+                TEST_ASSERT_EQUAL_INT(0, forward);
+            } else if ((from ^ to) == 0b11) {
+                TEST_ASSERT_EQUAL_INT(ILLEGAL, forward);
+            } else {
+                TEST_ASSERT_EQUAL_INT(-backward, forward);
+                TEST_ASSERT_EQUAL_INT(1, abs(forward));
+            }
+        }
+    }
+}
+
+static void test_full_cycles_decode_to_steps(void) {
+    present(clockwise_cycle, 4);
+    present(clockwise_cycle, 4);
+    present(counterclockwise_cycle, 4);
+    TEST_ASSERT_EQUAL_INT(2, clockwise_count);
+    TEST_ASSERT_EQUAL_INT(1, counterclockwise_count);
+    TEST_ASSERT_EQUAL(CLOCKWISE, get_direction());
+    TEST_ASSERT_EQUAL(CLOCKWISE, get_direction());
+    TEST_ASSERT_EQUAL(COUNTERCLOCKWISE, get_direction());
+    TEST_ASSERT_EQUAL(STATIONARY, get_direction());
+}
+
+static void test_bounce_back_to_detent_is_not_a_step(void) {
+    uint8_t const bounce[] = {0b10, 0b11, 0b10, 0b11};
+    present(bounce, 4);
+    TEST_ASSERT_EQUAL_INT(0, clockwise_count + counterclockwise_count);
+    TEST_ASSERT_EQUAL_UINT32(0, illegal_transition_count);
+}
+
+static void test_double_change_counts_as_illegal(void) {
+    uint8_t const skip[] = {0b00, 0b11};           // both wipers change at once, twice
+    present(skip, 2);
+    TEST_ASSERT_EQUAL_UINT32(2, get_illegal_transition_count());
+    TEST_ASSERT_EQUAL_INT(0, clockwise_count + counterclockwise_count);
+}
+
+static void test_single_lost_sample_still_steps(void) {
+    uint8_t const missing_one[] = {0b10, 0b01, 0b11};  // 00 was missed, so 10 -> 01 is illegal
+    present(missing_one, 3);
+    TEST_ASSERT_EQUAL_UINT32(1, illegal_transition_count);
+    TEST_ASSERT_EQUAL_INT(1, clockwise_count);          // the two edges seen round to one step
+}
+
+static void test_4x_resolution_steps_on_every_edge(void) {
+    set_encoder_resolution(ENCODER_4X, 1);
+    present(clockwise_cycle, 4);
+    TEST_ASSERT_EQUAL_INT(4, clockwise_count);
+    present(counterclockwise_cycle, 2);
+    TEST_ASSERT_EQUAL_INT(2, counterclockwise_count);
+    present(counterclockwise_cycle + 2, 2);
+    TEST_ASSERT_EQUAL_INT(4, counterclockwise_count);
+    TEST_ASSERT_EQUAL_INT(4, clockwise_count);
+}
+
+static void test_steps_per_detent_divides_steps(void) {
+    set_encoder_resolution(ENCODER_2X, 2);
+    present(clockwise_cycle, 4);
+    TEST_ASSERT_EQUAL_INT(1, clockwise_count);
+    present(clockwise_cycle, 4);
+    TEST_ASSERT_EQUAL_INT(2, clockwise_count);
+}
+
+/* Seeded stress test: random sequences of wiper states in which every change
+ * bounces, as a mechanical contact does. Each sequence is a full detent in
+ * either direction or a half turn that returns to the detent. */
+
+#define STRESS_SEED             (0x2024C0DEu)
+#define STRESS_SEQUENCES        (1UL << 21)
+#define SEQUENCES_PER_BATCH     (4096)
+#define MAXIMUM_BOUNCES         (3)                 // returns to the old level before a change settles
+#define MAXIMUM_SEQUENCE_LENGTH (4 * (2 * MAXIMUM_BOUNCES + 1))
+
+static uint32_t random_state;
+
+static uint32_t next_random(void) {                 // xorshift32
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+/* Appends the change from `from` to `to`, preceded by up to MAXIMUM_BOUNCES returns to `from`. */
+static size_t append_bouncing_change(uint8_t states[], size_t length, uint8_t from, uint8_t to) {
+    for (uint32_t bounces = next_random() % (MAXIMUM_BOUNCES + 1); bounces > 0; bounces--) {
+        states[length++] = to;
+        states[length++] = from;
+    }
+    states[length++] = to;
+    return length;
+}
+
+/* Generates one sequence that starts and ends at the detent, and reports the step that it should decode to. */
+static size_t generate_sequence(uint8_t states[], int *expected_step) {
+    uint8_t const *cycle = (next_random() & 1) ? clockwise_cycle : counterclockwise_cycle;
+    bool is_full_detent = next_random() & 1;
+    uint8_t const half_turn_and_back[] = {cycle[0], cycle[1], cycle[0], 0b11};
+    uint8_t const *path = is_full_detent ? cycle : half_turn_and_back;
+    size_t length = 0;
+    uint8_t from = 0b11;
+    for (int i = 0; i < 4; i++) {
+        length = append_bouncing_change(states, length, from, path[i]);
+        from = path[i];
+    }
+    *expected_step = !is_full_detent ? 0 : cycle == clockwise_cycle ? 1 : -1;
+    return length;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+static void test_bouncing_sequences_decode_correctly(void) {
+    uint8_t states[MAXIMUM_SEQUENCE_LENGTH];
+    uint32_t correct_sequences = 0;
+    uint64_t edges = 0;
+    random_state = STRESS_SEED;
+    for (uint32_t i = 0; i < STRESS_SEQUENCES; i++) {
+        int expected_step;
+        size_t length = generate_sequence(states, &expected_step);
+        int clockwise_before = clockwise_count;
+        int counterclockwise_before = counterclockwise_count;
+        present(states, length);
+        discard_encoder_events();
+        int step = (clockwise_count - clockwise_before) - (counterclockwise_count - counterclockwise_before);
+        correct_sequences += step == expected_step;
+        edges += length;
+    }
+    char message[120];
+    snprintf(message, sizeof(message), "%lu of %lu bouncing sequences (%llu edges) decoded correctly",
+             (unsigned long) correct_sequences, (unsigned long) STRESS_SEQUENCES, (unsigned long long) edges);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_SEQUENCES, correct_sequences);
+    TEST_ASSERT_EQUAL_UINT32(0, illegal_transition_count);      // one wiper changes at a time, however much it bounces
+}
+
+static void benchmark_decoding(void) {
+    static uint8_t states[SEQUENCES_PER_BATCH * MAXIMUM_SEQUENCE_LENGTH];
+    uint64_t edges = 0;
+    uint64_t elapsed_ns = 0;
+    int expected_steps = 0;
+    random_state = STRESS_SEED;
+    for (uint32_t i = 0; i < STRESS_SEQUENCES; i += SEQUENCES_PER_BATCH) {
+        size_t length = 0;
+        for (uint32_t j = 0; j < SEQUENCES_PER_BATCH; j++) {
+            int expected_step;
+            length += generate_sequence(states + length, &expected_step);
+            expected_steps += expected_step;
+        }
+        uint64_t start = now_ns();
+        present(states, length);
+        elapsed_ns += now_ns() - start;
+        discard_encoder_events();
+        edges += length;
+    }
+    char message[120];
+    snprintf(message, sizeof(message), "pin-change ISR: %.1f ns per edge over %llu edges",
+             (double) elapsed_ns / (double) edges, (unsigned long long) edges);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_INT(expected_steps, clockwise_count - counterclockwise_count);
+}
+
+/* step-event ring (user-009) */
+
+static void turn_clockwise(int detents) {
+    for (int i = 0; i < detents; i++) {
+        simulated_time_us += 1000;
+        present(clockwise_cycle, 4);
+    }
+}
+
+static void turn_counterclockwise(int detents) {
+    for (int i = 0; i < detents; i++) {
+        simulated_time_us += 1000;
+        present(counterclockwise_cycle, 4);
+    }
+}
+
+static void test_ring_holds_events_in_order(void) {
+    encoder_event_t events[EVENT_QUEUE_LENGTH];
+    uint32_t first_timestamp = simulated_time_us + 1000;
+    turn_clockwise(5);
+    TEST_ASSERT_EQUAL_UINT32(5, drain_encoder_events(events, EVENT_QUEUE_LENGTH));
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(CLOCKWISE, events[i].direction);
+        TEST_ASSERT_EQUAL_UINT32(first_timestamp + 1000 * i, events[i].timestamp_us);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, drain_all());
+}
+
+static void test_ring_drains_in_bounded_batches(void) {
+    encoder_event_t events[3];
+    turn_clockwise(7);
+    TEST_ASSERT_EQUAL_UINT32(3, drain_encoder_events(events, 3));
+    TEST_ASSERT_EQUAL_UINT32(3, drain_encoder_events(events, 3));
+    TEST_ASSERT_EQUAL_UINT32(1, drain_encoder_events(events, 3));
+}
+
+static void test_full_ring_counts_overflows_and_keeps_oldest(void) {
+    encoder_event_t events[EVENT_QUEUE_LENGTH];
+    uint32_t first_timestamp = simulated_time_us + 1000;
+    turn_clockwise(EVENT_QUEUE_LENGTH + 3);
+    TEST_ASSERT_EQUAL_UINT32(3, get_encoder_overflow_count());
+    TEST_ASSERT_EQUAL_INT(EVENT_QUEUE_LENGTH + 3, clockwise_count);     // the counts still see every step
+    TEST_ASSERT_EQUAL_UINT32(EVENT_QUEUE_LENGTH, drain_encoder_events(events, EVENT_QUEUE_LENGTH));
+    TEST_ASSERT_EQUAL_UINT32(first_timestamp, events[0].timestamp_us);
+    turn_clockwise(1);
+    TEST_ASSERT_EQUAL_UINT32(1, drain_all());                           // draining made room again
+    TEST_ASSERT_EQUAL_UINT32(3, get_encoder_overflow_count());
+}
+
+static void test_indices_wrap_around(void) {
+    for (int lap = 0; lap < 5; lap++) {
+        turn_clockwise(EVENT_QUEUE_LENGTH - 1);
+        TEST_ASSERT_EQUAL_UINT32(EVENT_QUEUE_LENGTH - 1, drain_all());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, get_encoder_overflow_count());
+}
+
+/* step notifications for consumers that ignore the queue (user-021) */
+
+static unsigned step_notifications;
+static bool is_step_event_pending;
+
+static void notify_step(void) {
+    step_notifications++;
+    is_step_event_pending = true;
+}
+
+static void test_full_ring_still_notifies_every_step(void) {
+    step_notifications = 0;
+    set_encoder_event_callback(notify_step);
+    turn_clockwise(EVENT_QUEUE_LENGTH + 8);
+    TEST_ASSERT_EQUAL_UINT(EVENT_QUEUE_LENGTH + 8, step_notifications);
+    TEST_ASSERT_EQUAL_UINT32(8, get_encoder_overflow_count());
+    TEST_ASSERT_EQUAL_UINT32(EVENT_QUEUE_LENGTH, discard_encoder_events());
+    TEST_ASSERT_EQUAL_UINT32(0, drain_all());
+}
+
+/* as combolock.c's test mode does: each step event runs a task that reads the counts and discards the queue */
+static void test_test_mode_sees_every_detent_past_ring_length(void) {
+    unsigned task_runs = 0;
+    uint32_t shown_version = get_rotation_count_version();
+    step_notifications = 0;
+    is_step_event_pending = false;
+    set_encoder_event_callback(notify_step);
+    for (int detent = 0; detent < 3 * EVENT_QUEUE_LENGTH; detent++) {
+        turn_clockwise(1);
+        if (is_step_event_pending) {
+            is_step_event_pending = false;
+            task_runs++;
+            TEST_ASSERT_NOT_EQUAL(shown_version, get_rotation_count_version());
+            shown_version = get_rotation_count_version();
+            discard_encoder_events();
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT(3 * EVENT_QUEUE_LENGTH, task_runs);
+    TEST_ASSERT_EQUAL_INT(3 * EVENT_QUEUE_LENGTH, clockwise_count);
+    TEST_ASSERT_EQUAL_UINT32(0, get_encoder_overflow_count());
+}
+
+/* step bookkeeping deferred to the work queue (user-022) */
+
+static void test_deferred_steps_are_queued_when_work_is_drained(void) {
+    encoder_event_t events[EVENT_QUEUE_LENGTH];
+    uint32_t first_timestamp = simulated_time_us + 1000;
+    set_encoder_step_deferral(true);
+    turn_clockwise(3);
+    turn_counterclockwise(2);
+    TEST_ASSERT_EQUAL_INT(3, clockwise_count);                         // the ISR still counts
+    TEST_ASSERT_EQUAL_INT(2, counterclockwise_count);
+    TEST_ASSERT_EQUAL_UINT32(0, drain_all());                           // but queues no event itself
+    TEST_ASSERT_EQUAL_UINT32(5, work_queue_drain(WORK_QUEUE_LENGTH));
+    TEST_ASSERT_EQUAL_UINT32(5, drain_encoder_events(events, EVENT_QUEUE_LENGTH));
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(i < 3 ? CLOCKWISE : COUNTERCLOCKWISE, events[i].direction);
+        TEST_ASSERT_EQUAL_UINT32(first_timestamp + 1000 * i, events[i].timestamp_us);  // the ISR's time, not the drain's
+    }
+}
+
+static void test_full_work_queue_still_notifies_every_step(void) {
+    step_notifications = 0;
+    set_encoder_event_callback(notify_step);
+    set_encoder_step_deferral(true);
+    turn_clockwise(WORK_QUEUE_LENGTH + 4);
+    TEST_ASSERT_EQUAL_UINT(4, step_notifications);                     // the lost steps, from the ISR
+    TEST_ASSERT_EQUAL_UINT32(4, get_encoder_overflow_count());
+    TEST_ASSERT_EQUAL_UINT32(WORK_QUEUE_LENGTH, work_queue_drain(2 * WORK_QUEUE_LENGTH));
+    TEST_ASSERT_EQUAL_UINT(WORK_QUEUE_LENGTH + 4, step_notifications);  // the rest, as they are recorded
+    TEST_ASSERT_EQUAL_INT(WORK_QUEUE_LENGTH + 4, clockwise_count);
+}
+
+/* velocity and acceleration (user-010) */
+
+static encoder_event_t latest_event;
+
+static encoder_event_t last_event(void) {
+    return latest_event;
+}
+
+/* turns one detent per interval, draining as the main loop would so that the ring never fills */
+static void step_every(uint32_t interval_us, int detents, uint8_t const cycle[]) {
+    for (int i = 0; i < detents; i++) {
+        simulated_time_us += interval_us;
+        present(cycle, 4);
+        TEST_ASSERT_EQUAL_UINT32(1, drain_encoder_events(&latest_event, 1));
+    }
+}
+
+static void test_steady_turning_converges_to_step_rate(void) {
+    step_every(600000, 1, clockwise_cycle);                 // a long pause starts from rest
+    step_every(10000, 40, clockwise_cycle);
+    TEST_ASSERT_UINT32_WITHIN(2, 100, last_event().velocity_q8 >> 8);
+}
+
+static void test_velocity_is_smoothed(void) {
+    step_every(600000, 1, clockwise_cycle);
+    TEST_ASSERT_UINT32_WITHIN(1, 2, last_event().velocity_q8 >> 8);   // one step per 500 ms, the slowest rate
+    step_every(10000, 1, clockwise_cycle);
+    uint32_t after_one = last_event().velocity_q8 >> 8;
+    step_every(10000, 1, clockwise_cycle);
+    uint32_t after_two = last_event().velocity_q8 >> 8;
+    TEST_ASSERT_TRUE(after_one < after_two);                // rises toward 100 steps/s a quarter at a time
+    TEST_ASSERT_TRUE(after_two < 100);
+}
+
+static void test_reversal_restarts_from_rest(void) {
+    step_every(10000, 20, clockwise_cycle);
+    step_every(10000, 1, counterclockwise_cycle);
+    encoder_event_t event = last_event();
+    TEST_ASSERT_EQUAL(COUNTERCLOCKWISE, event.direction);
+    TEST_ASSERT_UINT32_WITHIN(1, 2, event.velocity_q8 >> 8);
+}
+
+static void test_acceleration_curve_selects_multiplier(void) {
+    static encoder_acceleration_point_t const curve[] = {
+            {.minimum_steps_per_second = 0, .multiplier = 1},
+            {.minimum_steps_per_second = 12, .multiplier = 2},
+            {.minimum_steps_per_second = 24, .multiplier = 3},
+    };
+    encoder_event_t event = {.timestamp_us = 0, .velocity_q8 = 5 << 8, .direction = CLOCKWISE};
+    TEST_ASSERT_EQUAL_INT(1, get_accelerated_delta(&event));       // no curve: always one
+    set_encoder_acceleration(curve, 3);
+    TEST_ASSERT_EQUAL_INT(1, get_accelerated_delta(&event));
+    event.velocity_q8 = 12 << 8;
+    TEST_ASSERT_EQUAL_INT(2, get_accelerated_delta(&event));
+    event.velocity_q8 = (24 << 8) - 1;
+    TEST_ASSERT_EQUAL_INT(2, get_accelerated_delta(&event));
+    event.velocity_q8 = 30 << 8;
+    event.direction = COUNTERCLOCKWISE;
+    TEST_ASSERT_EQUAL_INT(-3, get_accelerated_delta(&event));
+    event.direction = STATIONARY;
+    TEST_ASSERT_EQUAL_INT(0, get_accelerated_delta(&event));
+}
+
+/* replaying spin traces through the lock controller's curve (user-010) */
+
+static encoder_acceleration_point_t const dial_acceleration[] = {
+        {.minimum_steps_per_second = 0, .multiplier = 1},
+        {.minimum_steps_per_second = 12, .multiplier = 2},
+        {.minimum_steps_per_second = 24, .multiplier = 3},
+};
+
+/* Replays a trace through the decoder, as the wipers would present it, after
+ * a long enough pause that the spin starts from rest. Returns how far the dial
+ * moves; `multipliers` receives each step's multiplier. */
+static int replay(struct spin_step const trace[], size_t number_of_steps, int multipliers[]) {
+    int dial = 0;
+    uint32_t offset_us = simulated_time_us + MAXIMUM_STEP_INTERVAL_us + 1 - trace[0].timestamp_us;
+    set_encoder_acceleration(dial_acceleration, 3);
+    for (size_t i = 0; i < number_of_steps; i++) {
+        simulated_time_us = trace[i].timestamp_us + offset_us;
+        present(trace[i].direction == CLOCKWISE ? clockwise_cycle : counterclockwise_cycle, 4);
+        encoder_event_t event;
+        TEST_ASSERT_EQUAL_UINT32(1, drain_encoder_events(&event, 1));
+        TEST_ASSERT_EQUAL(trace[i].direction, event.direction);
+        TEST_ASSERT_EQUAL_UINT32(simulated_time_us, event.timestamp_us);
+        int delta = get_accelerated_delta(&event);
+        multipliers[i] = abs(delta);
+        dial += delta;
+    }
+    return dial;
+}
+
+static void test_slow_turn_moves_one_value_per_detent(void) {
+    int const expected[NUMBER_OF_STEPS(slow_turn)] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+    int multipliers[NUMBER_OF_STEPS(slow_turn)];
+    TEST_ASSERT_EQUAL_INT(15, replay(slow_turn, NUMBER_OF_STEPS(slow_turn), multipliers));
+    TEST_ASSERT_EQUAL_INT_ARRAY(expected, multipliers, NUMBER_OF_STEPS(slow_turn));
+}
+
+static void test_flick_accelerates_and_coasts(void) {
+    /* the smoothed rate needs eight quick detents to pass 12 steps/s, and lags the slowdown as well */
+    int const expected[NUMBER_OF_STEPS(flick)] = {1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 2, 2, 2, 2};
+    int multipliers[NUMBER_OF_STEPS(flick)];
+    TEST_ASSERT_EQUAL_INT(30, replay(flick, NUMBER_OF_STEPS(flick), multipliers));
+    TEST_ASSERT_EQUAL_INT_ARRAY(expected, multipliers, NUMBER_OF_STEPS(flick));
+}
+
+static void test_corrections_after_a_spin_are_precise(void) {
+    int const expected[NUMBER_OF_STEPS(spin_and_correct)] = {1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 1, 1, 1};
+    int multipliers[NUMBER_OF_STEPS(spin_and_correct)];
+    TEST_ASSERT_EQUAL_INT(19 - 3, replay(spin_and_correct, NUMBER_OF_STEPS(spin_and_correct), multipliers));
+    TEST_ASSERT_EQUAL_INT_ARRAY(expected, multipliers, NUMBER_OF_STEPS(spin_and_correct));
+}
+
+/* timer-sampled mode (user-011) */
+
+static void sample(uint8_t quadrature, int number_of_samples) {
+    set_wipers(quadrature);
+    for (int i = 0; i < number_of_samples; i++) {
+        handle_sampling_interrupt();
+    }
+}
+
+static void test_change_registers_after_integrator_crosses(void) {
+    set_encoder_mode(ENCODER_TIMER_SAMPLED, 1000);
+    sample(0b10, DEBOUNCE_INTEGRATOR_MAXIMUM - 1);
+    TEST_ASSERT_EQUAL_UINT8(0b11, debounced_quadrature);      // wiper A has not yet reached the low rail
+    sample(0b10, 1);
+    TEST_ASSERT_EQUAL_UINT8(0b10, debounced_quadrature);
+    TEST_ASSERT_EQUAL_UINT32(0, get_encoder_glitch_count());
+}
+
+static void test_short_glitch_is_rejected_and_counted(void) {
+    set_encoder_mode(ENCODER_TIMER_SAMPLED, 1000);
+    sample(0b10, 1);
+    sample(0b11, 1);
+    TEST_ASSERT_EQUAL_UINT8(0b11, debounced_quadrature);
+    TEST_ASSERT_EQUAL_UINT32(1, get_encoder_glitch_count());
+    TEST_ASSERT_EQUAL_INT(0, clockwise_count + counterclockwise_count);
+}
+
+static void test_chattering_edge_still_decodes_one_step(void) {
+    set_encoder_mode(ENCODER_TIMER_SAMPLED, 1000);
+    uint32_t glitches = get_encoder_glitch_count();
+    for (int i = 0; i < 4; i++) {
+        sample(clockwise_cycle[i], 1);                      // the contact chatters as it changes
+        sample(i ? clockwise_cycle[i - 1] : 0b11, 1);
+        sample(clockwise_cycle[i], DEBOUNCE_INTEGRATOR_MAXIMUM + 1);
+    }
+    TEST_ASSERT_EQUAL_INT(1, clockwise_count);
+    TEST_ASSERT_EQUAL_UINT32(0, illegal_transition_count);
+    TEST_ASSERT_EQUAL(CLOCKWISE, get_direction());
+    TEST_ASSERT_TRUE(get_encoder_glitch_count() > glitches);    // the chatter was seen and rejected
+}
+
+static void test_wiper_filter_follows_the_mode(void) {
+    uint32_t const wipers = (1 << A_WIPER_PIN) | (1 << B_WIPER_PIN);
+    initialize_rotary_encoder();
+    TEST_ASSERT_EQUAL_HEX32(wipers, filtered_pins);
+    TEST_ASSERT_EQUAL_PTR(handle_quadrature_interrupt, filtered_pin_isr);
+    TEST_ASSERT_EQUAL_INT(PIN_FILTER_SETTLE_THEN_CONFIRM, filter_mode);
+    set_encoder_mode(ENCODER_TIMER_SAMPLED, 1000);
+    TEST_ASSERT_EQUAL_HEX32(wipers, filtered_pins);
+    TEST_ASSERT_NULL(filtered_pin_isr);
+    set_encoder_mode(ENCODER_INTERRUPT_DRIVEN, 0);
+    TEST_ASSERT_EQUAL_PTR(handle_quadrature_interrupt, filtered_pin_isr);
+}
+
+static void test_interrupt_mode_reports_the_wipers_rejected_edges(void) {
+    set_encoder_mode(ENCODER_INTERRUPT_DRIVEN, 0);
+    rejected_edges[A_WIPER_PIN] = 5;
+    rejected_edges[B_WIPER_PIN] = 2;
+    TEST_ASSERT_EQUAL_UINT32(7, get_encoder_glitch_count());
+}
+
+/* The bouncing sequences again, now with timing: a bounce lasts 20-300 us, a
+ * settled change 4-12 ms, and the encoder rests at each detent for 20-60 ms.
+ * Interrupt-driven mode runs its ISR on every edge; sampled mode runs its ISR
+ * every SAMPLE_PERIOD_us, whether or not anything changed. Both modes see the
+ * same trace and must decode the same steps. */
+
+#define TIMED_SEQUENCES (20000)
+#define SAMPLE_PERIOD_us (1000)
+
+struct timed_trace {
+    uint8_t *states;
+    uint32_t *hold_us;
+    size_t length;
+    uint32_t duration_us;
+    int expected_steps;
+};
+
+static uint32_t random_between(uint32_t minimum, uint32_t maximum) {
+    return minimum + next_random() % (maximum - minimum + 1);
+}
+
+static struct timed_trace generate_timed_trace(void) {
+    struct timed_trace trace = {
+            .states = malloc(TIMED_SEQUENCES * MAXIMUM_SEQUENCE_LENGTH),
+            .hold_us = malloc(TIMED_SEQUENCES * MAXIMUM_SEQUENCE_LENGTH * sizeof(uint32_t)),
+            .length = 0, .duration_us = 0, .expected_steps = 0,
+    };
+    TEST_ASSERT_NOT_NULL(trace.states);
+    TEST_ASSERT_NOT_NULL(trace.hold_us);
+    random_state = STRESS_SEED;
+    for (int i = 0; i < TIMED_SEQUENCES; i++) {
+        int expected_step;
+        uint8_t *states = trace.states + trace.length;
+        size_t length = generate_sequence(states, &expected_step);
+        for (size_t j = 0; j < length; j++) {
+            uint8_t previous_state = j ? states[j - 1] : 0b11;
+            bool is_bounce = j + 1 < length && states[j + 1] == previous_state;
+            uint32_t hold_us = is_bounce ? random_between(20, 300)
+                                         : j + 1 < length ? random_between(4000, 12000) : random_between(20000, 60000);
+            trace.hold_us[trace.length + j] = hold_us;
+            trace.duration_us += hold_us;
+        }
+        trace.length += length;
+        trace.expected_steps += expected_step;
+    }
+    return trace;
+}
+
+static void benchmark_interrupt_and_sampled_modes(void) {
+    struct timed_trace trace = generate_timed_trace();
+    /* the levels that each sampling interrupt would read */
+    size_t number_of_samples = trace.duration_us / SAMPLE_PERIOD_us;
+    uint8_t *samples = malloc(number_of_samples);
+    TEST_ASSERT_NOT_NULL(samples);
+    size_t edge = 0;
+    uint32_t edge_ends_us = trace.hold_us[0];
+    for (size_t i = 0; i < number_of_samples; i++) {
+        uint32_t sample_time_us = (uint32_t) (i + 1) * SAMPLE_PERIOD_us;
+        while (edge + 1 < trace.length && edge_ends_us <= sample_time_us) {
+            edge_ends_us += trace.hold_us[++edge];
+        }
+        samples[i] = trace.states[edge];
+    }
+
+    uint64_t start = now_ns();
+    present(trace.states, trace.length);
+    uint64_t interrupt_ns = now_ns() - start;
+    int interrupt_steps = clockwise_count - counterclockwise_count;
+    discard_encoder_events();
+
+    set_wipers(0b11);
+    set_encoder_mode(ENCODER_TIMER_SAMPLED, SAMPLE_PERIOD_us);
+    clockwise_count = 0;
+    counterclockwise_count = 0;
+    start = now_ns();
+    for (size_t i = 0; i < number_of_samples; i++) {
+        set_wipers(samples[i]);
+        handle_sampling_interrupt();
+    }
+    uint64_t sampled_ns = now_ns() - start;
+    int sampled_steps = clockwise_count - counterclockwise_count;
+
+    char message[160];
+    snprintf(message, sizeof(message), "%d sequences over %.1f s: interrupt mode %lu ISRs in %.2f ms; "
+             "sampled mode (%u us) %lu ISRs in %.2f ms, %lu glitches rejected",
+             TIMED_SEQUENCES, trace.duration_us / 1e6, (unsigned long) trace.length, interrupt_ns / 1e6,
+             SAMPLE_PERIOD_us, (unsigned long) number_of_samples, sampled_ns / 1e6,
+             (unsigned long) get_encoder_glitch_count());
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_INT(trace.expected_steps, interrupt_steps);
+    TEST_ASSERT_EQUAL_INT(trace.expected_steps, sampled_steps);
+    free(samples);
+    free(trace.states);
+    free(trace.hold_us);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_transition_table_is_antisymmetric);
+    RUN_TEST(test_full_cycles_decode_to_steps);
+    RUN_TEST(test_bounce_back_to_detent_is_not_a_step);
+    RUN_TEST(test_double_change_counts_as_illegal);
+    RUN_TEST(test_single_lost_sample_still_steps);
+    RUN_TEST(test_4x_resolution_steps_on_every_edge);
+    RUN_TEST(test_steps_per_detent_divides_steps);
+    RUN_TEST(test_bouncing_sequences_decode_correctly);
+    RUN_TEST(benchmark_decoding);
+    RUN_TEST(test_ring_holds_events_in_order);
+    RUN_TEST(test_ring_drains_in_bounded_batches);
+    RUN_TEST(test_full_ring_counts_overflows_and_keeps_oldest);
+    RUN_TEST(test_indices_wrap_around);
+    RUN_TEST(test_full_ring_still_notifies_every_step);
+    RUN_TEST(test_test_mode_sees_every_detent_past_ring_length);
+    RUN_TEST(test_deferred_steps_are_queued_when_work_is_drained);
+    RUN_TEST(test_full_work_queue_still_notifies_every_step);
+    RUN_TEST(test_steady_turning_converges_to_step_rate);
+    RUN_TEST(test_velocity_is_smoothed);
+    RUN_TEST(test_reversal_restarts_from_rest);
+    RUN_TEST(test_acceleration_curve_selects_multiplier);
+    RUN_TEST(test_slow_turn_moves_one_value_per_detent);
+    RUN_TEST(test_flick_accelerates_and_coasts);
+    RUN_TEST(test_corrections_after_a_spin_are_precise);
+    RUN_TEST(test_change_registers_after_integrator_crosses);
+    RUN_TEST(test_short_glitch_is_rejected_and_counted);
+    RUN_TEST(test_chattering_edge_still_decodes_one_step);
+    RUN_TEST(test_wiper_filter_follows_the_mode);
+    RUN_TEST(test_interrupt_mode_reports_the_wipers_rejected_edges);
+    RUN_TEST(benchmark_interrupt_and_sampled_modes);
+    return UNITY_END();
+}
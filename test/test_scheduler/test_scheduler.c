@@ -0,0 +1,314 @@
+/**************************************************************************//**
+ *
+ * @file test_scheduler.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for scheduler.c driving the ComboLock's own tasks from
+ *      lock-tasks.c.
+ *
+ * The suite posts the events that the encoder, the inputs, and the frame
+ * timer would post, and checks which tasks run, in what order, and how often.
+ * The modules that the tasks call are fakes that log a letter each time they
+ * are called -- W for draining the work queue, L for the lock controller, T
+ * for the servo test, D for drawing the display -- and advance a simulated
+ * clock so that the tasks' run times can be checked too.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "scheduler.c"
+#include "lock-tasks.c"
+
+#define MAXIMUM_LOG_LENGTH  (64)
+
+static char task_log[MAXIMUM_LOG_LENGTH + 1];
+static int log_length;
+static uint32_t simulated_time_us;
+static size_t work_items_waiting;
+static int flushes_in_progress;                 // how many more frames the background flush takes
+static bool is_left_button_pressed;
+static bool is_right_button_pressed;
+static bool is_left_switch_left;
+static bool is_right_switch_left;
+static unsigned combination_resets;
+static int bound_rows[4];
+static unsigned binding_updates;
+static uint8_t const combination[3] = {5, 10, 15};
+
+static void log_call(char letter, uint32_t run_time_us) {
+    TEST_ASSERT_LESS_THAN_INT(MAXIMUM_LOG_LENGTH, log_length);
+    task_log[log_length++] = letter;
+    task_log[log_length] = '\0';
+    simulated_time_us += run_time_us;
+}
+
+/* fakes for the tasks' dependencies */
+
+uint32_t get_microseconds(void) {
+    return simulated_time_us;
+}
+
+size_t work_queue_drain(size_t maximum_number_of_items) {
+    log_call('W', 5);
+    size_t drained = work_items_waiting < maximum_number_of_items ? work_items_waiting : maximum_number_of_items;
+    work_items_waiting -= drained;
+    return drained;
+}
+
+void control_lock() {
+    log_call('L', 40);
+}
+
+uint8_t const *get_combination() {
+    return combination;
+}
+
+void force_combination_reset() {
+    combination_resets++;
+}
+
+char *test_servo(char buffer[]) {
+    log_call('T', 30);
+    strcpy(buffer, "SERVO: center");
+    return buffer;
+}
+
+void count_visits(int row) {
+    TEST_ASSERT_EQUAL_INT(LIVENESS_ROW, row);
+    log_call('D', 200);
+}
+
+bool display_flush_is_in_progress(void) {
+    if (flushes_in_progress) {
+        flushes_in_progress--;
+        return true;
+    }
+    return false;
+}
+
+size_t discard_encoder_events() {
+    return 0;
+}
+
+char *count_rotations(char buffer[]) {
+    strcpy(buffer, "CW:0 CCW:0");
+    return buffer;
+}
+
+uint32_t get_rotation_count_version() {
+    return 0;
+}
+
+void display_binding_bind(struct display_binding *binding, int row, uint32_t (*get_state_key)(void),
+                          void (*render)(char buffer[])) {
+    TEST_ASSERT_TRUE(row >= 1 && row <= 3);
+    bound_rows[row] = row;
+}
+
+bool display_binding_update(struct display_binding *binding) {
+    binding_updates++;
+    return false;
+}
+
+uint32_t display_binding_hash(void const *bytes, size_t number_of_bytes) {
+    return (uint32_t) number_of_bytes;
+}
+
+bool cowpi_left_button_is_pressed(void) {
+    return is_left_button_pressed;
+}
+
+bool cowpi_right_button_is_pressed(void) {
+    return is_right_button_pressed;
+}
+
+bool cowpi_left_switch_is_in_left_position(void) {
+    return is_left_switch_left;
+}
+
+bool cowpi_right_switch_is_in_left_position(void) {
+    return is_right_switch_left;
+}
+
+/* helpers */
+
+/* Runs scheduler passes until one finds nothing to do, and returns the letters that the passes logged. */
+static char const *run_until_idle(void) {
+    log_length = 0;
+    task_log[0] = '\0';
+    for (int pass = 0; scheduler_run(); pass++) {
+        TEST_ASSERT_LESS_THAN_INT(MAXIMUM_LOG_LENGTH, pass);
+    }
+    return task_log;
+}
+
+/* Runs one scheduler pass, and returns the letters that it logged. */
+static char const *run_once(void) {
+    log_length = 0;
+    task_log[0] = '\0';
+    scheduler_run();
+    return task_log;
+}
+
+static uint32_t runs_of(int task) {
+    return scheduler_get_task_statistics(task).runs;
+}
+
+#define WORK_TASK       (0)
+#define CONTROL_TASK    (1)                     // the lock controller, or the test task in test mode
+#define DISPLAY_TASK    (2)
+
+void setUp(void) {
+    number_of_tasks = 0;
+    pending_events = 0;
+    idle_count = 0;
+    simulated_time_us = 0;
+    work_items_waiting = 0;
+    flushes_in_progress = 0;
+    is_left_button_pressed = false;
+    is_right_button_pressed = false;
+    is_left_switch_left = false;
+    is_right_switch_left = false;
+    combination_resets = 0;
+    memset(bound_rows, 0, sizeof(bound_rows));
+    binding_updates = 0;
+}
+
+void tearDown(void) {}
+
+static void test_tasks_are_added_in_order(void) {
+    lock_tasks_add(false);
+    TEST_ASSERT_EQUAL_STRING("work", scheduler_get_task_statistics(WORK_TASK).name);
+    TEST_ASSERT_EQUAL_STRING("lock", scheduler_get_task_statistics(CONTROL_TASK).name);
+    TEST_ASSERT_EQUAL_STRING("display", scheduler_get_task_statistics(DISPLAY_TASK).name);
+    TEST_ASSERT_NULL(scheduler_get_task_statistics(DISPLAY_TASK + 1).name);
+}
+
+static void test_no_event_runs_nothing_and_counts_idle(void) {
+    lock_tasks_add(false);
+    TEST_ASSERT_EQUAL_STRING("", run_until_idle());
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler_get_idle_count());
+    TEST_ASSERT_EQUAL_UINT32(0, runs_of(WORK_TASK) + runs_of(CONTROL_TASK) + runs_of(DISPLAY_TASK));
+}
+
+static void test_encoder_step_runs_the_lock_then_the_display(void) {
+    lock_tasks_add(false);
+    lock_tasks_post_encoder_step();
+    TEST_ASSERT_EQUAL_STRING("L", run_once());
+    TEST_ASSERT_EQUAL_STRING("D", run_once());          // the lock controller asked for a frame
+    TEST_ASSERT_EQUAL_STRING("", run_once());
+    TEST_ASSERT_EQUAL_UINT32(0, runs_of(WORK_TASK));
+    TEST_ASSERT_EQUAL_UINT32(1, runs_of(CONTROL_TASK));
+    TEST_ASSERT_EQUAL_UINT32(1, runs_of(DISPLAY_TASK));
+}
+
+static void test_one_pass_takes_every_pending_event_in_task_order(void) {
+    lock_tasks_add(false);
+    lock_tasks_post_display_frame(NULL);                // posted in the opposite order to the tasks'
+    lock_tasks_post_input_change();
+    lock_tasks_post_encoder_step();
+    lock_tasks_post_deferred_work();
+    TEST_ASSERT_EQUAL_STRING("WLD", run_once());
+    TEST_ASSERT_EQUAL_STRING("D", run_once());          // the lock's frame request arrived after the display ran
+    TEST_ASSERT_EQUAL_UINT32(1, runs_of(CONTROL_TASK));  // two events, one run
+    TEST_ASSERT_EQUAL_UINT32(2, runs_of(DISPLAY_TASK));
+}
+
+static void test_work_backlog_is_drained_a_batch_per_pass(void) {
+    lock_tasks_add(false);
+    work_items_waiting = 2 * WORK_ITEMS_PER_RUN + 3;
+    lock_tasks_post_deferred_work();
+    lock_tasks_post_display_frame(NULL);
+    TEST_ASSERT_EQUAL_STRING("WDWW", run_until_idle());  // the display runs between batches
+    TEST_ASSERT_EQUAL_UINT(0, work_items_waiting);
+    TEST_ASSERT_EQUAL_UINT32(3, runs_of(WORK_TASK));
+    TEST_ASSERT_EQUAL_UINT32(1, runs_of(DISPLAY_TASK));
+}
+
+static void test_display_reruns_until_its_flush_finishes(void) {
+    lock_tasks_add(false);
+    flushes_in_progress = 2;
+    lock_tasks_post_display_frame(NULL);
+    TEST_ASSERT_EQUAL_STRING("DDD", run_until_idle());
+    TEST_ASSERT_EQUAL_UINT32(3, runs_of(DISPLAY_TASK));
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler_get_idle_count());
+}
+
+static void test_polling_posts_only_when_an_input_changes(void) {
+    lock_tasks_add(false);
+    lock_tasks_poll_inputs(NULL);                       // catch up with whatever the last test left
+    run_until_idle();
+    uint32_t lock_runs = runs_of(CONTROL_TASK);
+    lock_tasks_poll_inputs(NULL);
+    TEST_ASSERT_EQUAL_STRING("", run_until_idle());
+    is_left_button_pressed = true;
+    lock_tasks_poll_inputs(NULL);
+    lock_tasks_poll_inputs(NULL);
+    TEST_ASSERT_EQUAL_STRING("LD", run_until_idle());
+    is_left_switch_left = true;
+    lock_tasks_poll_inputs(NULL);
+    TEST_ASSERT_EQUAL_STRING("LD", run_until_idle());
+    TEST_ASSERT_EQUAL_UINT32(lock_runs + 2, runs_of(CONTROL_TASK));
+}
+
+static void test_test_mode_replaces_the_lock_controller(void) {
+    lock_tasks_add(true);
+    TEST_ASSERT_EQUAL_STRING("test", scheduler_get_task_statistics(CONTROL_TASK).name);
+    TEST_ASSERT_EQUAL_INT(1, bound_rows[1]);
+    TEST_ASSERT_EQUAL_INT(2, bound_rows[2]);
+    TEST_ASSERT_EQUAL_INT(3, bound_rows[3]);
+    lock_tasks_post_encoder_step();
+    TEST_ASSERT_EQUAL_STRING("TD", run_until_idle());
+    TEST_ASSERT_EQUAL_UINT(3, binding_updates);
+    TEST_ASSERT_EQUAL_STRING("SERVO: center", servo_status);
+    is_right_button_pressed = true;
+    lock_tasks_post_input_change();
+    run_until_idle();
+    lock_tasks_post_encoder_step();                     // still held
+    run_until_idle();
+    TEST_ASSERT_EQUAL_UINT(1, combination_resets);
+    is_right_button_pressed = false;
+    lock_tasks_post_input_change();
+    run_until_idle();
+    TEST_ASSERT_EQUAL_UINT32(4, runs_of(CONTROL_TASK));
+    TEST_ASSERT_EQUAL_UINT32(4, runs_of(DISPLAY_TASK));
+}
+
+static void test_run_times_are_recorded_per_task(void) {
+    lock_tasks_add(false);
+    for (int i = 0; i < 3; i++) {
+        lock_tasks_post_encoder_step();
+        lock_tasks_post_deferred_work();
+        run_until_idle();
+    }
+    struct task_statistics lock = scheduler_get_task_statistics(CONTROL_TASK);
+    struct task_statistics display = scheduler_get_task_statistics(DISPLAY_TASK);
+    struct task_statistics work = scheduler_get_task_statistics(WORK_TASK);
+    TEST_ASSERT_EQUAL_UINT32(3, lock.runs);
+    TEST_ASSERT_EQUAL_UINT32(3 * 40, lock.total_run_time_us);
+    TEST_ASSERT_EQUAL_UINT32(40, lock.maximum_run_time_us);
+    TEST_ASSERT_EQUAL_UINT32(3 * 200, display.total_run_time_us);
+    TEST_ASSERT_EQUAL_UINT32(3 * 5, work.total_run_time_us);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_tasks_are_added_in_order);
+    RUN_TEST(test_no_event_runs_nothing_and_counts_idle);
+    RUN_TEST(test_encoder_step_runs_the_lock_then_the_display);
+    RUN_TEST(test_one_pass_takes_every_pending_event_in_task_order);
+    RUN_TEST(test_work_backlog_is_drained_a_batch_per_pass);
+    RUN_TEST(test_display_reruns_until_its_flush_finishes);
+    RUN_TEST(test_polling_posts_only_when_an_input_changes);
+    RUN_TEST(test_test_mode_replaces_the_lock_controller);
+    RUN_TEST(test_run_times_are_recorded_per_task);
+    return UNITY_END();
+}
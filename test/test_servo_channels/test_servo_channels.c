@@ -0,0 +1,272 @@
+/**************************************************************************//**
+ *
+ * @file test_servo_channels.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for the edge timing that servo-channels.c produces against
+ *      a simulated alarm clock.
+ *
+ * A single attached channel must produce the same signal that servo-edges.c
+ * did: a rising edge at the start of each period, a falling edge
+ * `pulse_width_us` later, and deadlines chained from the previous deadline so
+ * that interrupt latency does not drift the period.
+ *
+ * A benchmark times the ISR work of one frame with 1 to
+ * `MAXIMUM_NUMBER_OF_SERVO_CHANNELS` channels attached.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+#include "servo-channels.c"
+
+#define PERIOD_us   (20000)
+#define MAXIMUM_NUMBER_OF_WRITES  (64)
+#define BENCHMARK_FRAMES (20000)
+
+struct pin_write {
+    uint32_t time_us;
+    uint32_t pin_mask;
+    bool level;
+};
+
+static uint32_t simulated_time_us;
+static uint32_t alarm_latency_us;               // how late each simulated alarm fires
+static bool is_alarm_pending;
+static uint32_t alarm_deadline_us;
+static void (*alarm_isr)(void);
+static unsigned alarms_fired;
+static struct pin_write writes[MAXIMUM_NUMBER_OF_WRITES];
+static int number_of_writes;
+
+static uint32_t simulated_now_us(void) {
+    return simulated_time_us;
+}
+
+static void simulated_set_alarm(uint32_t delay_us, void (*isr)(void)) {
+    is_alarm_pending = true;
+    alarm_deadline_us = simulated_time_us + delay_us;
+    alarm_isr = isr;
+}
+
+static void simulated_cancel_alarm(void) {
+    is_alarm_pending = false;
+}
+
+static void simulated_write_pins(uint32_t pin_mask, bool level) {
+    TEST_ASSERT_LESS_THAN_INT(MAXIMUM_NUMBER_OF_WRITES, number_of_writes);
+    writes[number_of_writes++] = (struct pin_write) {.time_us = simulated_time_us, .pin_mask = pin_mask, .level = level};
+}
+
+static struct servo_alarm_clock const simulated_clock = {
+        .now_us = simulated_now_us,
+        .set_alarm = simulated_set_alarm,
+        .cancel_alarm = simulated_cancel_alarm,
+        .write_pins = simulated_write_pins,
+};
+
+/* Fires every alarm whose deadline falls before `end_us`. */
+static void run_until(uint32_t end_us) {
+    while (is_alarm_pending && (int32_t) (alarm_deadline_us - end_us) < 0) {
+        is_alarm_pending = false;
+        simulated_time_us = alarm_deadline_us + alarm_latency_us;
+        alarms_fired++;
+        alarm_isr();
+    }
+    simulated_time_us = end_us;
+}
+
+static void assert_write(int index, uint32_t time_us, uint32_t pin_mask, bool level) {
+    TEST_ASSERT_LESS_THAN_INT(number_of_writes, index);
+    TEST_ASSERT_EQUAL_UINT32(time_us, writes[index].time_us);
+    TEST_ASSERT_EQUAL_HEX32(pin_mask, writes[index].pin_mask);
+    TEST_ASSERT_EQUAL(level, writes[index].level);
+}
+
+void setUp(void) {
+    for (servo_channel_t channel = 0; channel < MAXIMUM_NUMBER_OF_SERVO_CHANNELS; channel++) {
+        servo_channel_detach(channel);
+    }
+    simulated_time_us = 1000;
+    alarm_latency_us = 0;
+    is_alarm_pending = false;
+    alarms_fired = 0;
+    number_of_writes = 0;
+    servo_channels_initialize(&simulated_clock, PERIOD_us);
+}
+
+void tearDown(void) {
+    servo_channels_stop();
+}
+
+static void test_single_channel_matches_edge_scheduling(void) {
+    servo_channel_t channel = servo_channel_attach(22);
+    TEST_ASSERT_EQUAL_INT8(0, channel);
+    servo_channel_set_pulse_width(channel, 1500);
+    run_until(1000 + 3 * PERIOD_us);
+    TEST_ASSERT_EQUAL_INT(6, number_of_writes);
+    for (int period = 0; period < 3; period++) {
+        uint32_t start_us = 1000 + period * PERIOD_us;
+        assert_write(2 * period, start_us, 1UL << 22, true);
+        assert_write(2 * period + 1, start_us + 1500, 1UL << 22, false);
+    }
+    TEST_ASSERT_EQUAL_UINT(6, alarms_fired);
+}
+
+static void test_zero_width_keeps_pin_low_with_one_interrupt_per_period(void) {
+    servo_channel_attach(22);
+    run_until(1000 + 3 * PERIOD_us);
+    TEST_ASSERT_EQUAL_INT(0, number_of_writes);
+    TEST_ASSERT_EQUAL_UINT(3, alarms_fired);
+}
+
+static void test_channels_share_rising_edge_and_fall_in_order(void) {
+    servo_channel_t first = servo_channel_attach(2);
+    servo_channel_t second = servo_channel_attach(3);
+    servo_channel_t third = servo_channel_attach(4);
+    servo_channel_set_pulse_width(first, 2000);
+    servo_channel_set_pulse_width(second, 500);
+    servo_channel_set_pulse_width(third, 1200);
+    run_until(1000 + PERIOD_us);
+    TEST_ASSERT_EQUAL_INT(4, number_of_writes);
+    assert_write(0, 1000, (1UL << 2) | (1UL << 3) | (1UL << 4), true);
+    assert_write(1, 1000 + 500, 1UL << 3, false);
+    assert_write(2, 1000 + 1200, 1UL << 4, false);
+    assert_write(3, 1000 + 2000, 1UL << 2, false);
+    TEST_ASSERT_EQUAL_UINT(4, alarms_fired);
+}
+
+static void test_equal_widths_merge_into_one_falling_edge(void) {
+    servo_channel_t first = servo_channel_attach(2);
+    servo_channel_t second = servo_channel_attach(5);
+    servo_channel_set_pulse_width(first, 1500);
+    servo_channel_set_pulse_width(second, 1500);
+    run_until(1000 + PERIOD_us);
+    TEST_ASSERT_EQUAL_INT(2, number_of_writes);
+    assert_write(1, 1000 + 1500, (1UL << 2) | (1UL << 5), false);
+    TEST_ASSERT_EQUAL_UINT(2, alarms_fired);
+}
+
+static void test_new_width_waits_for_next_period(void) {
+    servo_channel_t channel = servo_channel_attach(22);
+    servo_channel_set_pulse_width(channel, 1000);
+    run_until(1000 + 500);                              // mid-pulse
+    servo_channel_set_pulse_width(channel, 2000);
+    run_until(1000 + 2 * PERIOD_us);
+    assert_write(1, 1000 + 1000, 1UL << 22, false);
+    assert_write(3, 1000 + PERIOD_us + 2000, 1UL << 22, false);
+}
+
+static void test_latency_does_not_drift_the_period(void) {
+    alarm_latency_us = 7;
+    servo_channel_t channel = servo_channel_attach(22);
+    servo_channel_set_pulse_width(channel, 1500);
+    run_until(1000 + 10 * PERIOD_us);
+    TEST_ASSERT_EQUAL_INT(20, number_of_writes);
+    assert_write(18, 1000 + 9 * PERIOD_us + 7, 1UL << 22, true);
+    assert_write(19, 1000 + 9 * PERIOD_us + 1500 + 7, 1UL << 22, false);
+    struct servo_edge_jitter jitter = servo_channels_get_jitter();
+    TEST_ASSERT_EQUAL_UINT32(20, jitter.edges);
+    TEST_ASSERT_EQUAL_UINT32(7, jitter.mean_lateness_us);
+    TEST_ASSERT_EQUAL_UINT32(7, jitter.maximum_lateness_us);
+    servo_channels_reset_jitter();
+    TEST_ASSERT_EQUAL_UINT32(0, servo_channels_get_jitter().edges);
+}
+
+static void test_pulse_width_is_limited_to_period(void) {
+    servo_channel_t channel = servo_channel_attach(22);
+    servo_channel_set_pulse_width(channel, PERIOD_us + 5);
+    run_until(1000 + PERIOD_us);
+    assert_write(1, 1000 + PERIOD_us - 1, 1UL << 22, false);
+}
+
+static void test_stop_leaves_pins_low_until_restarted(void) {
+    servo_channel_t channel = servo_channel_attach(22);
+    servo_channel_set_pulse_width(channel, 1500);
+    run_until(1000 + 100);                              // mid-pulse
+    servo_channels_stop();
+    TEST_ASSERT_FALSE(is_alarm_pending);
+    assert_write(number_of_writes - 1, 1000 + 100, 1UL << 22, false);
+    int writes_when_stopped = number_of_writes;
+    run_until(1000 + 3 * PERIOD_us);
+    TEST_ASSERT_EQUAL_INT(writes_when_stopped, number_of_writes);
+    servo_channels_start();
+    run_until(1000 + 3 * PERIOD_us + 1);
+    assert_write(writes_when_stopped, 1000 + 3 * PERIOD_us, 1UL << 22, true);
+}
+
+static void test_attach_fails_when_all_channels_are_in_use(void) {
+    for (uint8_t pin = 0; pin < MAXIMUM_NUMBER_OF_SERVO_CHANNELS; pin++) {
+        TEST_ASSERT_EQUAL_INT8(pin, servo_channel_attach(pin));
+    }
+    TEST_ASSERT_EQUAL_INT8(-1, servo_channel_attach(20));
+    servo_channel_detach(3);
+    TEST_ASSERT_EQUAL_INT8(3, servo_channel_attach(20));
+}
+
+/* benchmark */
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+/* As run_until(), but only the time spent in the ISR is counted. */
+static uint64_t run_frame_timed(uint32_t end_us) {
+    uint64_t elapsed_ns = 0;
+    while (is_alarm_pending && (int32_t) (alarm_deadline_us - end_us) < 0) {
+        is_alarm_pending = false;
+        simulated_time_us = alarm_deadline_us;
+        alarms_fired++;
+        uint64_t start = now_ns();
+        alarm_isr();
+        elapsed_ns += now_ns() - start;
+    }
+    simulated_time_us = end_us;
+    number_of_writes = 0;
+    return elapsed_ns;
+}
+
+static void benchmark_frame_isr_time_by_channel_count(void) {
+    for (int channels = 1; channels <= MAXIMUM_NUMBER_OF_SERVO_CHANNELS; channels++) {
+        setUp();
+        for (int i = 0; i < channels; i++) {
+            servo_channel_set_pulse_width(servo_channel_attach((uint8_t) i), 1000 + 125 * i);   // every channel falls separately
+        }
+        uint64_t elapsed_ns = 0;
+        for (uint32_t frame = 1; frame <= BENCHMARK_FRAMES; frame++) {
+            elapsed_ns += run_frame_timed(1000 + frame * PERIOD_us);
+        }
+        TEST_ASSERT_EQUAL_UINT((unsigned) (channels + 1) * BENCHMARK_FRAMES, alarms_fired);
+        char message[120];
+        snprintf(message, sizeof(message), "%d channel(s): %u interrupts, %.1f ns of ISR time per frame",
+                 channels, alarms_fired / BENCHMARK_FRAMES, (double) elapsed_ns / BENCHMARK_FRAMES);
+        TEST_MESSAGE(message);
+        tearDown();
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_channel_matches_edge_scheduling);
+    RUN_TEST(test_zero_width_keeps_pin_low_with_one_interrupt_per_period);
+    RUN_TEST(test_channels_share_rising_edge_and_fall_in_order);
+    RUN_TEST(test_equal_widths_merge_into_one_falling_edge);
+    RUN_TEST(test_new_width_waits_for_next_period);
+    RUN_TEST(test_latency_does_not_drift_the_period);
+    RUN_TEST(test_pulse_width_is_limited_to_period);
+    RUN_TEST(test_stop_leaves_pins_low_until_restarted);
+    RUN_TEST(test_attach_fails_when_all_channels_are_in_use);
+    RUN_TEST(benchmark_frame_isr_time_by_channel_count);
+    return UNITY_END();
+}
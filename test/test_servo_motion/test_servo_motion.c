@@ -0,0 +1,218 @@
+/**************************************************************************//**
+ *
+ * @file test_servo_motion.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for servo-motion.c's conversion of its motion limits to
+ *      the configured frame period, the shape of its moves, and its
+ *      completion callback and quiescence.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <unity.h>
+#include "servo-motion.c"
+
+static uint32_t written_pulse_width_us;
+static bool is_enabled;
+
+static void fake_set_pulse_width(uint32_t pulse_width_us) {
+    written_pulse_width_us = pulse_width_us;
+}
+
+static void fake_enable_pulses(bool enable) {
+    is_enabled = enable;
+}
+
+/* Returns how many frames a move takes to settle. */
+static unsigned frames_to_reach(uint32_t target_us) {
+    servo_motion_move_to(target_us, NULL);
+    unsigned frames = 0;
+    while (!servo_motion_is_settled()) {
+        TEST_ASSERT_TRUE(servo_motion_step());
+        frames++;
+        TEST_ASSERT_LESS_THAN_UINT32(100000, frames);
+    }
+    TEST_ASSERT_EQUAL_UINT32(target_us, written_pulse_width_us);
+    return frames;
+}
+
+/* Returns how many frames the signal stays on after a move settles. */
+static unsigned frames_held(void) {
+    unsigned frames = 0;
+    while (servo_motion_step()) {
+        frames++;
+    }
+    TEST_ASSERT_FALSE(is_enabled);
+    return frames;
+}
+
+static unsigned completions;
+
+static void count_completion(void) {
+    completions++;
+}
+
+static unsigned other_completions;
+
+static void count_other_completion(void) {
+    other_completions++;
+}
+
+void setUp(void) {
+    frame_us = 0;
+    servo_motion_set_limits(0, 0, 0);
+    completions = 0;
+    other_completions = 0;
+}
+
+void tearDown(void) {}
+
+static void test_limits_set_before_initialization_use_the_frame_period(void) {
+    servo_motion_set_limits(1000000, 0, 100000);            // 1 ms of pulse width per second; hold 100 ms
+    servo_motion_initialize(fake_set_pulse_width, fake_enable_pulses, 10000, 1000);
+    TEST_ASSERT_TRUE(is_enabled);
+    TEST_ASSERT_EQUAL_UINT32(1000, written_pulse_width_us);
+    TEST_ASSERT_EQUAL_UINT(1, frames_to_reach(2000));      // no acceleration limit moves in one frame
+    TEST_ASSERT_EQUAL_UINT(10, frames_held());              // 100 ms of 10 ms frames
+}
+
+static void test_order_of_limits_and_initialization_does_not_matter(void) {
+    servo_motion_set_limits(2000, 4000, 40000);
+    servo_motion_initialize(fake_set_pulse_width, fake_enable_pulses, 20000, 1000);
+    unsigned limits_first = frames_to_reach(2000);
+    unsigned held_limits_first = frames_held();
+
+    frame_us = 0;
+    servo_motion_initialize(fake_set_pulse_width, fake_enable_pulses, 20000, 1000);
+    servo_motion_set_limits(2000, 4000, 40000);
+    TEST_ASSERT_EQUAL_UINT(limits_first, frames_to_reach(2000));
+    TEST_ASSERT_EQUAL_UINT(held_limits_first, frames_held());
+    TEST_ASSERT_EQUAL_UINT(2, held_limits_first);
+}
+
+static void test_move_duration_does_not_depend_on_frame_period(void) {
+    servo_motion_set_limits(1000, 32000, 0);
+    servo_motion_initialize(fake_set_pulse_width, fake_enable_pulses, 20000, 1000);
+    uint32_t twenty_ms_frames_us = frames_to_reach(1500) * 20000;
+    servo_motion_initialize(fake_set_pulse_width, fake_enable_pulses, 5000, 1000);
+    uint32_t five_ms_frames_us = frames_to_reach(1500) * 5000;
+    TEST_ASSERT_UINT32_WITHIN(40000, 531000, twenty_ms_frames_us);  // 0.5 s at full speed plus the ramps
+    TEST_ASSERT_UINT32_WITHIN(40000, 531000, five_ms_frames_us);
+}
+
+static void test_completion_callback_fires_exactly_once(void) {
+    servo_motion_set_limits(2000, 8000, 40000);
+    servo_motion_initialize(fake_set_pulse_width, fake_enable_pulses, 20000, 1000);
+    servo_motion_move_to(1500, count_completion);
+    while (!servo_motion_is_settled()) {
+        TEST_ASSERT_EQUAL_UINT(0, completions);
+        servo_motion_step();
+    }
+    TEST_ASSERT_EQUAL_UINT(1, completions);
+    servo_motion_move_to(1500, count_completion);           // the same target again is not a new move
+    frames_held();
+    for (int i = 0; i < 10; i++) {
+        servo_motion_step();
+    }
+    TEST_ASSERT_EQUAL_UINT(1, completions);
+}
+
+static void test_move_is_a_monotonic_trapezoid_without_overshoot(void) {
+    servo_motion_set_limits(1000, 4000, 0);                 // 20 us and 1.6 us/frame per 20 ms frame
+    servo_motion_initialize(fake_set_pulse_width, fake_enable_pulses, 20000, 1000);
+    servo_motion_move_to(2000, NULL);
+    int32_t previous_position = position;
+    int32_t previous_velocity = 0;
+    uint32_t previous_width = written_pulse_width_us;
+    bool is_decelerating = false;
+    unsigned cruising_frames = 0;
+    while (!servo_motion_is_settled()) {
+        servo_motion_step();
+        TEST_ASSERT_TRUE(position >= previous_position);
+        TEST_ASSERT_TRUE(position <= target);
+        TEST_ASSERT_TRUE(written_pulse_width_us >= previous_width);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(2000, written_pulse_width_us);
+        TEST_ASSERT_TRUE(velocity <= maximum_speed);
+        if (velocity > previous_velocity) {
+            TEST_ASSERT_FALSE(is_decelerating);             // once slowing, never speeding up again
+        } else if (velocity < previous_velocity) {
+            is_decelerating = true;
+        }
+        if (velocity == maximum_speed) {
+            cruising_frames++;
+        }
+        previous_position = position;
+        previous_velocity = velocity;
+        previous_width = written_pulse_width_us;
+    }
+    TEST_ASSERT_EQUAL_UINT32(2000, written_pulse_width_us);
+    TEST_ASSERT_TRUE(is_decelerating);
+    TEST_ASSERT_GREATER_THAN_UINT(0, cruising_frames);
+}
+
+static void test_reversal_slows_to_a_stop_before_turning_around(void) {
+    servo_motion_set_limits(1000, 4000, 0);
+    servo_motion_initialize(fake_set_pulse_width, fake_enable_pulses, 20000, 1000);
+    servo_motion_move_to(2000, count_completion);
+    for (int i = 0; i < 20; i++) {                          // up to cruising speed
+        servo_motion_step();
+    }
+    TEST_ASSERT_EQUAL_INT32(maximum_speed, velocity);
+    int32_t reversal_position = position;
+    int32_t stopping_distance = (int32_t) (((int64_t) velocity * velocity) / (2 * acceleration)) + velocity;
+    servo_motion_move_to(1200, count_other_completion);
+    int32_t previous_velocity = velocity;
+    int32_t farthest_position = position;
+    while (velocity > 0) {
+        servo_motion_step();
+        TEST_ASSERT_EQUAL_INT32(previous_velocity - acceleration > 0 ? previous_velocity - acceleration : 0, velocity);
+        previous_velocity = velocity;
+        farthest_position = position > farthest_position ? position : farthest_position;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(reversal_position + stopping_distance, farthest_position);
+    while (!servo_motion_is_settled()) {
+        servo_motion_step();
+        TEST_ASSERT_TRUE(velocity <= 0);
+        TEST_ASSERT_TRUE(position >= target);               // no overshoot on the way back
+    }
+    TEST_ASSERT_EQUAL_UINT32(1200, written_pulse_width_us);
+    TEST_ASSERT_EQUAL_UINT(0, completions);                 // the abandoned move never completes
+    TEST_ASSERT_EQUAL_UINT(1, other_completions);
+}
+
+static void test_move_from_quiescence_re_enables_at_the_held_position(void) {
+    servo_motion_set_limits(1000, 4000, 40000);
+    servo_motion_initialize(fake_set_pulse_width, fake_enable_pulses, 20000, 1000);
+    frames_to_reach(1300);
+    frames_held();
+    TEST_ASSERT_TRUE(servo_motion_is_quiescent());
+    TEST_ASSERT_FALSE(servo_motion_step());                 // steps do nothing while quiescent
+    written_pulse_width_us = 0;
+    servo_motion_move_to(1100, count_completion);
+    TEST_ASSERT_TRUE(is_enabled);
+    TEST_ASSERT_FALSE(servo_motion_is_quiescent());
+    TEST_ASSERT_EQUAL_UINT32(1300, written_pulse_width_us); // the signal resumes where the servo was left
+    TEST_ASSERT_TRUE(servo_motion_step());
+    TEST_ASSERT_LESS_THAN_UINT32(1300, written_pulse_width_us);
+    frames_to_reach(1100);
+    TEST_ASSERT_EQUAL_UINT(1, completions);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_limits_set_before_initialization_use_the_frame_period);
+    RUN_TEST(test_order_of_limits_and_initialization_does_not_matter);
+    RUN_TEST(test_move_duration_does_not_depend_on_frame_period);
+    RUN_TEST(test_completion_callback_fires_exactly_once);
+    RUN_TEST(test_move_is_a_monotonic_trapezoid_without_overshoot);
+    RUN_TEST(test_reversal_slows_to_a_stop_before_turning_around);
+    RUN_TEST(test_move_from_quiescence_re_enables_at_the_held_position);
+    return UNITY_END();
+}
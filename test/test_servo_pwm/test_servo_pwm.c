@@ -0,0 +1,82 @@
+/**************************************************************************//**
+ *
+ * @file test_servo_pwm.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for the values that servo-pwm.c writes to the RP2040's PWM
+ *      and GPIO control registers.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "servo-pwm.c"
+
+#define SERVO_PIN   (22)
+
+static struct rp2040_pwm_slice simulated_slices[8];
+static struct rp2040_gpio_control simulated_gpio_controls[30];
+
+void setUp(void) {
+    memset(simulated_slices, 0, sizeof(simulated_slices));
+    memset(simulated_gpio_controls, 0, sizeof(simulated_gpio_controls));
+    servo_pwm_use_registers(simulated_slices, simulated_gpio_controls);
+}
+
+void tearDown(void) {}
+
+static void test_initialization_configures_a_1_MHz_20_ms_slice(void) {
+    simulated_gpio_controls[SERVO_PIN].control = 0x3000 | 0x1F;     // overrides set, function NULL
+    servo_pwm_initialize(SERVO_PIN, 20000);
+    struct rp2040_pwm_slice *slice = &simulated_slices[3];             // GPIO22 is slice 3, channel A
+    TEST_ASSERT_EQUAL_HEX32(125 << 4, slice->divider);                 // 125 MHz / 125 = 1 MHz
+    TEST_ASSERT_EQUAL_UINT32(19999, slice->top);
+    TEST_ASSERT_EQUAL_UINT32(20000, (slice->top + 1) * (slice->divider >> 4) / SYSTEM_CLOCK_MHz);
+    TEST_ASSERT_EQUAL_HEX32(0, slice->compare);
+    TEST_ASSERT_EQUAL_HEX32(PWM_ENABLE, slice->control_and_status);
+    TEST_ASSERT_EQUAL_HEX32(0x3000 | GPIO_FUNCTION_PWM, simulated_gpio_controls[SERVO_PIN].control);
+    for (int other = 0; other < 8; other++) {
+        if (other != 3) {
+            TEST_ASSERT_EQUAL_HEX32(0, simulated_slices[other].control_and_status);
+        }
+    }
+}
+
+static void test_channel_a_pulse_width_goes_in_low_half(void) {
+    servo_pwm_initialize(SERVO_PIN, 20000);
+    simulated_slices[3].compare = 0xABCD0000;                           // channel B belongs to someone else
+    servo_pwm_set_pulse_width(1500);
+    TEST_ASSERT_EQUAL_HEX32(0xABCD0000 | 1500, simulated_slices[3].compare);
+    TEST_ASSERT_EQUAL_UINT32(1500, servo_pwm_get_pulse_width());
+}
+
+static void test_channel_b_pulse_width_goes_in_high_half(void) {
+    servo_pwm_initialize(SERVO_PIN + 1, 20000);
+    simulated_slices[3].compare = 0x1234;
+    servo_pwm_set_pulse_width(500);
+    TEST_ASSERT_EQUAL_HEX32((500u << 16) | 0x1234, simulated_slices[3].compare);
+}
+
+static void test_pulse_width_is_limited_to_period(void) {
+    servo_pwm_initialize(SERVO_PIN, 20000);
+    servo_pwm_set_pulse_width(25000);
+    TEST_ASSERT_EQUAL_UINT32(20000, simulated_slices[3].compare & 0xFFFF);
+    servo_pwm_set_pulse_width(0);
+    TEST_ASSERT_EQUAL_UINT32(0, simulated_slices[3].compare & 0xFFFF);   // a zero width switches the signal off
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_initialization_configures_a_1_MHz_20_ms_slice);
+    RUN_TEST(test_channel_a_pulse_width_goes_in_low_half);
+    RUN_TEST(test_channel_b_pulse_width_goes_in_high_half);
+    RUN_TEST(test_pulse_width_is_limited_to_period);
+    return UNITY_END();
+}
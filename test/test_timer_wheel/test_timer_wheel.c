@@ -0,0 +1,270 @@
+/**************************************************************************//**
+ *
+ * @file test_timer_wheel.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for timer-wheel.c, driven both by explicit ticks and by a
+ *      simulated one-shot alarm.
+ *
+ * The randomized tests arm thousands of one-shot and periodic timers with
+ * delays that reach every wheel, cancel a third of them, and check that every
+ * expiry fires on exactly its tick and that no cancelled timer fires. A
+ * benchmark times the same timers: the cost of each tick when ticked, and of
+ * each arm, cancel, and alarm when driven by the alarm.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unity.h>
+#include "timer-wheel.c"
+
+#define TICK_us             (1000)
+#define START_us            ((uint32_t) 0xFFF00000)    // close enough to the end that the clock wraps during the tests
+#define NUMBER_OF_TIMERS    (3000)
+
+static uint32_t simulated_time_us;
+static uint32_t alarm_latency_us;
+static bool is_alarm_pending;
+static uint32_t alarm_deadline_us;
+static void (*alarm_isr)(void);
+static unsigned alarms_fired;
+
+static uint32_t simulated_now_us(void) {
+    return simulated_time_us;
+}
+
+static void simulated_set_alarm(uint32_t delay_us, void (*isr)(void)) {
+    is_alarm_pending = true;
+    alarm_deadline_us = simulated_time_us + delay_us;
+    alarm_isr = isr;
+}
+
+static void simulated_cancel_alarm(void) {
+    is_alarm_pending = false;
+}
+
+static struct timer_wheel_clock const simulated_clock = {
+        .now_us = simulated_now_us,
+        .set_alarm = simulated_set_alarm,
+        .cancel_alarm = simulated_cancel_alarm,
+};
+
+/* Fires every alarm whose deadline is no later than `end_us`, which is relative to the start. */
+static void run_until(uint32_t end_us) {
+    end_us += START_us;
+    while (is_alarm_pending && (int32_t) (alarm_deadline_us + alarm_latency_us - end_us) <= 0) {
+        is_alarm_pending = false;
+        simulated_time_us = alarm_deadline_us + alarm_latency_us;
+        alarms_fired++;
+        alarm_isr();
+    }
+    simulated_time_us = end_us;
+}
+
+static struct software_timer timers[NUMBER_OF_TIMERS];
+static uint32_t due_ticks[NUMBER_OF_TIMERS];
+static uint32_t period_ticks[NUMBER_OF_TIMERS];
+static unsigned fire_counts[NUMBER_OF_TIMERS];
+static bool is_cancelled[NUMBER_OF_TIMERS];
+static unsigned mistimed_expirations;
+static bool check_clock;
+
+static void record_expiration(void *context) {
+    int i = (int) (intptr_t) context;
+    bool is_on_time = timer_wheel_now() == due_ticks[i];
+    if (check_clock) {
+        is_on_time = is_on_time && simulated_time_us == (uint32_t) (START_us + due_ticks[i] * TICK_us);
+    }
+    if (!is_on_time) {
+        mistimed_expirations++;
+    }
+    fire_counts[i]++;
+    due_ticks[i] += period_ticks[i];
+}
+
+/* Arms the timers with delays that reach every wheel, then cancels every third one. */
+static void arm_random_timers(uint32_t longest_delay_ticks) {
+    srand(1);
+    for (int i = 0; i < NUMBER_OF_TIMERS; i++) {
+        uint32_t delay_ticks = 1 + (uint32_t) rand() % ((i % 10 == 0) ? longest_delay_ticks : 300);
+        period_ticks[i] = (i % 7 == 0) ? 1 + (uint32_t) rand() % 200 : 0;
+        due_ticks[i] = delay_ticks;
+        fire_counts[i] = 0;
+        is_cancelled[i] = false;
+        timer_wheel_arm(&timers[i], delay_ticks * TICK_us, period_ticks[i] * TICK_us,
+                        record_expiration, (void *) (intptr_t) i);
+    }
+    for (int i = 0; i < NUMBER_OF_TIMERS; i += 3) {
+        timer_wheel_cancel(&timers[i]);
+        is_cancelled[i] = true;
+    }
+}
+
+static void assert_each_timer_fired_correctly(uint32_t elapsed_ticks) {
+    TEST_ASSERT_EQUAL_UINT(0, mistimed_expirations);
+    for (int i = 0; i < NUMBER_OF_TIMERS; i++) {
+        if (is_cancelled[i]) {
+            TEST_ASSERT_EQUAL_UINT(0, fire_counts[i]);
+        } else if (period_ticks[i]) {
+            TEST_ASSERT_GREATER_THAN_UINT32(elapsed_ticks, due_ticks[i]);      // no expiration was missed
+        } else {
+            TEST_ASSERT_EQUAL_UINT(1, fire_counts[i]);
+        }
+    }
+}
+
+static unsigned callback_count;
+
+static void count_callback(void *context) {
+    callback_count++;
+}
+
+void setUp(void) {
+    simulated_time_us = START_us;
+    alarm_latency_us = 0;
+    is_alarm_pending = false;
+    alarms_fired = 0;
+    mistimed_expirations = 0;
+    callback_count = 0;
+    check_clock = false;
+    wheel_clock = NULL;
+}
+
+void tearDown(void) {
+    for (int i = 0; i < NUMBER_OF_TIMERS; i++) {
+        timer_wheel_cancel(&timers[i]);
+    }
+}
+
+static void test_randomized_timers_fire_on_their_ticks(void) {
+    timer_wheel_initialize(TICK_us, NULL);
+    arm_random_timers(2000000);
+    for (uint32_t tick = 0; tick < 2100000; tick++) {
+        timer_wheel_tick();
+    }
+    assert_each_timer_fired_correctly(2100000);
+}
+
+static void test_randomized_timers_fire_on_their_ticks_from_alarm(void) {
+    timer_wheel_initialize(TICK_us, &simulated_clock);
+    check_clock = true;
+    arm_random_timers(2000000);
+    run_until(2100000 * TICK_us);
+    assert_each_timer_fired_correctly(2100000);
+}
+
+static void test_alarm_is_cancelled_while_no_timer_is_armed(void) {
+    timer_wheel_initialize(TICK_us, &simulated_clock);
+    TEST_ASSERT_FALSE(is_alarm_pending);
+    struct software_timer timer = {.next = NULL};
+    timer_wheel_arm(&timer, 3 * TICK_us, 0, count_callback, NULL);
+    TEST_ASSERT_TRUE(is_alarm_pending);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t) (START_us + 3 * TICK_us), alarm_deadline_us);
+    timer_wheel_cancel(&timer);
+    TEST_ASSERT_FALSE(is_alarm_pending);
+    timer_wheel_arm(&timer, 3 * TICK_us, 0, count_callback, NULL);
+    run_until(10 * TICK_us);
+    TEST_ASSERT_EQUAL_UINT(1, callback_count);
+    TEST_ASSERT_EQUAL_UINT(1, alarms_fired);
+    TEST_ASSERT_FALSE(is_alarm_pending);
+}
+
+static void test_distant_timer_wakes_only_to_cascade_and_expire(void) {
+    timer_wheel_initialize(TICK_us, &simulated_clock);
+    struct software_timer timer = {.next = NULL};
+    timer_wheel_arm(&timer, 5000 * TICK_us, 0, count_callback, NULL);
+    run_until(4999 * TICK_us);
+    TEST_ASSERT_EQUAL_UINT(0, callback_count);
+    TEST_ASSERT_EQUAL_UINT(2, alarms_fired);            // ticks 4096 and 4992 cascade it inward
+    run_until(5000 * TICK_us);
+    TEST_ASSERT_EQUAL_UINT(1, callback_count);
+    TEST_ASSERT_EQUAL_UINT(3, alarms_fired);
+}
+
+static void test_late_alarm_expires_every_timer_that_came_due(void) {
+    timer_wheel_initialize(TICK_us, &simulated_clock);
+    check_clock = false;
+    alarm_latency_us = 3500;
+    for (int i = 0; i < 3; i++) {
+        due_ticks[i] = (uint32_t) i + 1;
+        period_ticks[i] = 0;
+        fire_counts[i] = 0;
+        timer_wheel_arm(&timers[i], due_ticks[i] * TICK_us, 0, record_expiration, (void *) (intptr_t) i);
+    }
+    run_until(10 * TICK_us);
+    TEST_ASSERT_EQUAL_UINT(1, alarms_fired);
+    TEST_ASSERT_EQUAL_UINT(0, mistimed_expirations);    // each saw its own tick as the wheel's time
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_UINT(1, fire_counts[i]);
+    }
+}
+
+static void test_arming_after_idle_counts_from_current_time(void) {
+    timer_wheel_initialize(TICK_us, &simulated_clock);
+    run_until(10000 * TICK_us + 300);                   // long idle, part way into a tick
+    struct software_timer timer = {.next = NULL};
+    timer_wheel_arm(&timer, 2 * TICK_us, 0, count_callback, NULL);
+    TEST_ASSERT_EQUAL_UINT32(10000, timer_wheel_now());
+    TEST_ASSERT_EQUAL_UINT32((uint32_t) (START_us + 10002 * TICK_us), alarm_deadline_us);
+    run_until(10002 * TICK_us);
+    TEST_ASSERT_EQUAL_UINT(1, callback_count);
+}
+
+/* benchmark */
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+static void benchmark_randomized_timers(void) {
+    timer_wheel_initialize(TICK_us, NULL);
+    arm_random_timers(2000000);
+    uint64_t start = now_ns();
+    for (uint32_t tick = 0; tick < 2100000; tick++) {
+        timer_wheel_tick();
+    }
+    uint64_t ticked_ns = now_ns() - start;
+    assert_each_timer_fired_correctly(2100000);
+    tearDown();
+
+    setUp();
+    timer_wheel_initialize(TICK_us, &simulated_clock);
+    check_clock = true;
+    start = now_ns();
+    arm_random_timers(2000000);
+    uint64_t arming_ns = now_ns() - start;
+    start = now_ns();
+    run_until(2100000 * TICK_us);
+    uint64_t alarms_ns = now_ns() - start;
+    assert_each_timer_fired_correctly(2100000);
+
+    char message[160];
+    snprintf(message, sizeof(message), "ticked: %.1f ns per tick; alarm-driven: %.1f ns per arm or cancel, "
+                                       "%u alarms at %.1f ns each",
+             (double) ticked_ns / 2100000, (double) arming_ns / (NUMBER_OF_TIMERS + NUMBER_OF_TIMERS / 3),
+             alarms_fired, (double) alarms_ns / alarms_fired);
+    TEST_MESSAGE(message);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_randomized_timers_fire_on_their_ticks);
+    RUN_TEST(test_randomized_timers_fire_on_their_ticks_from_alarm);
+    RUN_TEST(test_alarm_is_cancelled_while_no_timer_is_armed);
+    RUN_TEST(test_distant_timer_wakes_only_to_cascade_and_expire);
+    RUN_TEST(test_late_alarm_expires_every_timer_that_came_due);
+    RUN_TEST(test_arming_after_idle_counts_from_current_time);
+    RUN_TEST(benchmark_randomized_timers);
+    return UNITY_END();
+}
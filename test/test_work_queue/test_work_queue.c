@@ -0,0 +1,170 @@
+/**************************************************************************//**
+ *
+ * @file test_work_queue.c
+ *
+ * @author (Oliver Triana)
+ * @author (Femi Odulate)
+ *
+ * @brief Host tests for work-queue.c, including a stress test in which
+ *      several threads post concurrently while another drains.
+ *
+ * The threads stand in for ISRs that preempt each other: each producer posts
+ * a numbered sequence of items, and the consumer checks that every item that
+ * was accepted runs exactly once and that each producer's items run in the
+ * order that they were posted.
+ *
+ ******************************************************************************/
+
+/*
+ * ComboLock GroupLab assignment and starter code (c) 2022-24 Christopher A. Bohn
+ * ComboLock solution (c) the above-named students
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <unity.h>
+#include "work-queue.c"
+
+#define NUMBER_OF_PRODUCERS     (4)
+#define ITEMS_PER_PRODUCER      (20000)
+#define PRODUCER_SHIFT          (24)            // a payload is the producer's number above its sequence number
+#define SEQUENCE_MASK           ((1UL << PRODUCER_SHIFT) - 1)
+
+static uint32_t next_sequence[NUMBER_OF_PRODUCERS];
+static uint32_t runs[NUMBER_OF_PRODUCERS];
+static uint32_t out_of_order_runs;
+static uint32_t accepted[NUMBER_OF_PRODUCERS];
+static uint32_t rejected[NUMBER_OF_PRODUCERS];
+static int finished_producers;
+
+/* Items are accepted in order, so each producer's runs must see increasing sequence numbers. */
+static void check_sequence(uint32_t payload) {
+    uint32_t producer = payload >> PRODUCER_SHIFT;
+    uint32_t sequence = payload & SEQUENCE_MASK;
+    if (producer >= NUMBER_OF_PRODUCERS || sequence < next_sequence[producer]) {
+        out_of_order_runs++;
+        return;
+    }
+    next_sequence[producer] = sequence + 1;
+    runs[producer]++;
+}
+
+static void *produce(void *argument) {
+    uint32_t producer = (uint32_t) (intptr_t) argument;
+    for (uint32_t sequence = 0; sequence < ITEMS_PER_PRODUCER; sequence++) {
+        if (work_queue_post(check_sequence, (producer << PRODUCER_SHIFT) | sequence)) {
+            accepted[producer]++;
+        } else {
+            rejected[producer]++;
+            sched_yield();                      // let the consumer make room
+        }
+    }
+    __atomic_add_fetch(&finished_producers, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static uint32_t recorded_payloads[2 * WORK_QUEUE_LENGTH];
+static int number_of_runs;
+
+static void record_payload(uint32_t payload) {
+    recorded_payloads[number_of_runs++] = payload;
+}
+
+static unsigned notifications;
+
+static void count_notification(void) {
+    notifications++;
+}
+
+void setUp(void) {
+    work_queue_initialize();
+    work_queue_set_notify(NULL);
+    memset(next_sequence, 0, sizeof(next_sequence));
+    memset(runs, 0, sizeof(runs));
+    memset(accepted, 0, sizeof(accepted));
+    memset(rejected, 0, sizeof(rejected));
+    out_of_order_runs = 0;
+    finished_producers = 0;
+    number_of_runs = 0;
+    notifications = 0;
+}
+
+void tearDown(void) {}
+
+static void test_items_run_in_the_order_posted(void) {
+    for (uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(work_queue_post(record_payload, 100 + i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, work_queue_drain(4));
+    TEST_ASSERT_EQUAL_UINT32(6, work_queue_drain(WORK_QUEUE_LENGTH));
+    TEST_ASSERT_EQUAL_UINT32(0, work_queue_drain(WORK_QUEUE_LENGTH));
+    TEST_ASSERT_EQUAL_INT(10, number_of_runs);
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL_UINT32(100 + i, recorded_payloads[i]);
+    }
+}
+
+static void test_full_queue_rejects_and_counts(void) {
+    for (uint32_t i = 0; i < WORK_QUEUE_LENGTH; i++) {
+        TEST_ASSERT_TRUE(work_queue_post(record_payload, i));
+    }
+    TEST_ASSERT_FALSE(work_queue_post(record_payload, WORK_QUEUE_LENGTH));
+    TEST_ASSERT_EQUAL_UINT32(1, work_queue_drain(1));
+    TEST_ASSERT_TRUE(work_queue_post(record_payload, WORK_QUEUE_LENGTH + 1));     // draining made room again
+    TEST_ASSERT_EQUAL_UINT32(WORK_QUEUE_LENGTH, work_queue_drain(2 * WORK_QUEUE_LENGTH));
+    TEST_ASSERT_EQUAL_UINT32(WORK_QUEUE_LENGTH + 1, recorded_payloads[WORK_QUEUE_LENGTH]);
+    struct work_queue_statistics statistics = work_queue_get_statistics();
+    TEST_ASSERT_EQUAL_UINT32(WORK_QUEUE_LENGTH + 1, statistics.posted);
+    TEST_ASSERT_EQUAL_UINT32(1, statistics.overflows);
+    TEST_ASSERT_EQUAL_UINT32(WORK_QUEUE_LENGTH, statistics.high_water_mark);
+}
+
+static void test_each_post_notifies(void) {
+    work_queue_set_notify(count_notification);
+    work_queue_post(record_payload, 1);
+    work_queue_post(record_payload, 2);
+    TEST_ASSERT_EQUAL_UINT(2, notifications);
+    work_queue_drain(WORK_QUEUE_LENGTH);
+    TEST_ASSERT_EQUAL_UINT(2, notifications);
+}
+
+static void test_concurrent_producers_lose_and_reorder_nothing(void) {
+    pthread_t producers[NUMBER_OF_PRODUCERS];
+    for (int i = 0; i < NUMBER_OF_PRODUCERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&producers[i], NULL, produce, (void *) (intptr_t) i));
+    }
+    while (__atomic_load_n(&finished_producers, __ATOMIC_ACQUIRE) < NUMBER_OF_PRODUCERS) {
+        if (work_queue_drain(WORK_QUEUE_LENGTH) == 0) {
+            sched_yield();
+        }
+    }
+    for (int i = 0; i < NUMBER_OF_PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    while (work_queue_drain(WORK_QUEUE_LENGTH) > 0) {}
+
+    TEST_ASSERT_EQUAL_UINT32(0, out_of_order_runs);
+    uint32_t total_accepted = 0;
+    uint32_t total_rejected = 0;
+    for (int i = 0; i < NUMBER_OF_PRODUCERS; i++) {
+        TEST_ASSERT_EQUAL_UINT32(ITEMS_PER_PRODUCER, accepted[i] + rejected[i]);
+        TEST_ASSERT_EQUAL_UINT32(accepted[i], runs[i]);                 // each accepted item ran exactly once
+        total_accepted += accepted[i];
+        total_rejected += rejected[i];
+    }
+    struct work_queue_statistics statistics = work_queue_get_statistics();
+    TEST_ASSERT_EQUAL_UINT32(total_accepted, statistics.posted);
+    TEST_ASSERT_EQUAL_UINT32(total_rejected, statistics.overflows);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(WORK_QUEUE_LENGTH, statistics.high_water_mark);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, total_accepted);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_items_run_in_the_order_posted);
+    RUN_TEST(test_full_queue_rejects_and_counts);
+    RUN_TEST(test_each_post_notifies);
+    RUN_TEST(test_concurrent_producers_lose_and_reorder_nothing);
+    return UNITY_END();
+}